@@ -2,15 +2,20 @@
 // Bloco 1: Bibliotecas e Definições de Pinos
 //-----------------------------------------------------------------------------------------------------
 #include <stdio.h>                        // Biblioteca padrão para entrada/saída
+#include <math.h>                         // lroundf() nos valores em centésimos
 #include "pico/stdlib.h"                  // Biblioteca da Raspberry Pi Pico para funcionalidades básicas
 #include "hardware/adc.h"                 // Biblioteca para leitura de ADC (conversor analógico-digital)
 #include "ssd1306.h"                      // Biblioteca para controle do display OLED SSD1306
+#include "oled_ui.h"                      // Widgets do display redesenhados apenas quando mudam
+#include "icons.h"                        // Ícones do display no formato de páginas (tools/img2page.py)
 #include "onewire.h"                      // Biblioteca para comunicação 1-Wire
 #include "onewire_library.h"              // Biblioteca auxiliar do protocolo 1-Wire
 #include "ds18b20.h"                      // Biblioteca específica para o sensor de temperatura DS18B20
 #include "ow_rom.h"                       // Biblioteca auxiliar para dispositivos 1-Wire
 #include "matriz_led.h"                   // Biblioteca para controle da matriz de LEDs
+#include "matriz_anim.h"                  // Animações da matriz de LEDs tocadas por temporizador
 #include "hardware/timer.h"               // Biblioteca para gerenciamento de temporizadores de hardware
+#include "flashlog.h"                     // Histórico local dos sensores na flash
 
 // Definições dos pinos de sensores e atuadores
 #define SENSOR_UMIDADE_GPIO 28  // GPIO para o sensor de umidade do solo (Analógico)
@@ -20,6 +25,14 @@
 #define BUTTON_A 5              // GPIO do Botão A (Digital)
 #define BUTTON_B 6              // GPIO do Botão B (Digital)
 
+// Pinos do modo frota (usados com MODO_FROTA = 1, ver frota.h)
+#define FROTA_MUX_S0_GPIO 8     // S0..S3 dos multiplexadores nos GPIOs 8 a 11
+#define FROTA_HC595_DADOS_GPIO 17
+#define FROTA_HC595_CLOCK_GPIO 18
+#define FROTA_HC595_TRAVA_GPIO 21
+#define FROTA_HC595_OE_GPIO 22  // Saídas dos 74HC595 desabilitadas até a primeira imagem
+#define FROTA_ONEWIRE_GPIOS {DS18B20_GPIO, 2, 3, 4}  // Um barramento 1-Wire por GPIO
+
 // Definições do barramento I2C para o display OLED
 #define I2C_SDA 14
 #define I2C_SCL 15
@@ -32,24 +45,198 @@
 #include "lwip/tcp.h"          // Biblioteca para conexões TCP
 #include "lwip/dns.h"          // Biblioteca para resolução de DNS
 #include "lwip/init.h"         // Inicialização da pilha de rede
+#include "thingspeak.h"        // Cliente HTTP com conexão persistente para o ThingSpeak
+#include "amostras.h"          // Fila de amostras enviadas em lotes ao ThingSpeak
+#include "http_servidor.h"     // Servidor HTTP local com as leituras e métricas
+#include "wifi.h"              // Conexão Wi-Fi sem bloqueio, com reconexão
+#include "relogio.h"           // Hora real por SNTP para o instante das amostras
+#include "lwip_uso.h"          // Picos e falhas de alocação dos pools do lwIP
+#include "politica.h"          // Quando registrar e enviar uma amostra
+#include "aquisicao.h"         // Intervalo de leitura adaptativo de cada sensor
+#include "irrigacao.h"         // Controle automático da irrigação
+#include "regras.h"            // Regras do estado da plantinha por perfil de planta
+#include "vigia.h"             // Prazos das etapas sobre o watchdog
+
+// Destino das amostras, escolhido na compilação (cmake -DENVIO_MQTT=ON):
+// 0 = ThingSpeak (lotes HTTP), 1 = broker MQTT (um tópico por métrica)
+#ifndef ENVIO_MQTT
+#define ENVIO_MQTT 0
+#endif
+#if ENVIO_MQTT
+#include "mqtt_envio.h"        // Publicação das amostras num broker MQTT
+#endif
+
+// Telemetria binária por UDP para um coletor local (cmake -DENVIO_UDP=ON),
+// enviada junto com o destino acima
+#ifndef ENVIO_UDP
+#define ENVIO_UDP 0
+#endif
+#if ENVIO_UDP
+#include "pico/unique_id.h"    // Identificação do dispositivo a partir da flash
+#include "telemetria.h"        // Lotes de amostras em datagramas UDP
+#endif
+
+// Modo frota (cmake -DMODO_FROTA=ON): uma placa cuidando de vários vasos (Bloco 11).
+// Os vasos aparecem em /data.json e /metrics e, com ENVIO_MQTT ou ENVIO_UDP, são
+// enviados um a um (tópicos "<prefixo>/<vaso>/..." ou um dispositivo UDP por vaso).
+// O canal do ThingSpeak e o histórico na flash são só do vaso único.
+#ifndef MODO_FROTA
+#define MODO_FROTA 0
+#endif
+#if MODO_FROTA
+#include <stdlib.h>            // abs() na formatação dos vasos
+#include "frota.h"             // Estado e ciclo de todos os vasos
+#endif
 
 // Configuração da rede Wi-Fi
 #define WIFI_SSID "Ronaldinho & Tati"  
 #define WIFI_PASS "amora2023" 
 #define THINGSPEAK_HOST "api.thingspeak.com"
 #define THINGSPEAK_PORT 80
+#define NTP_SERVIDOR "pool.ntp.org"  // Nome ou IP (ex.: tools/ntp_standin.c no computador)
 
-// Chave de API do ThingSpeak
+// Chave de API e canal do ThingSpeak (o envio em lote usa o número do canal)
 #define API_KEY "HJNSE0EKYOW06C7Q"
-
-// Estruturas para conexão TCP
-struct tcp_pcb *tcp_client_pcb;
-ip_addr_t server_ip;
+#define THINGSPEAK_CHANNEL_ID "0000000"
+#define THINGSPEAK_BULK_PATH "/channels/" THINGSPEAK_CHANNEL_ID "/bulk_update.json"
+
+// Broker MQTT (usado com ENVIO_MQTT = 1)
+#define MQTT_BROKER "192.168.0.10"   // Nome ou IP do broker (ex.: mosquitto no computador)
+#define MQTT_PORT 1883
+#define MQTT_CLIENT_ID "plantinha"
+#define MQTT_PREFIXO "plantinha"      // Tópicos "plantinha/temperatura", "plantinha/umido", ...
+#define MQTT_QOS 1                    // 0 = sem confirmação, 1 = PUBACK do broker
+
+// Coletor de telemetria UDP (usado com ENVIO_UDP = 1, ver tools/telemetria)
+#define TELEMETRIA_COLETOR "192.168.0.10"
+#define TELEMETRIA_PORTA 5005
+
+// Política de envio das amostras (Bloco 9): em vez de uma a cada 30 s, uma amostra
+// sai quando algo muda de verdade, com um limite de taxa e uma pulsação
+#define ENVIO_BANDA_TEMPERATURA 0.25f      // °C de diferença para o último envio
+#define ENVIO_BANDA_UMIDADE 0.05f          // V de diferença na tensão do sensor de umidade
+#define ENVIO_PULSACAO_MS (10 * 60 * 1000) // Sem mudanças, uma amostra a cada 10 minutos
+#define ENVIO_INTERVALO_MS 10000           // Em média, no máximo uma amostra a cada 10 s...
+#define ENVIO_RAJADA 3                     // ...mas até 3 seguidas depois de um período calmo
+
+// Intervalo de leitura de cada sensor (Bloco 5): curto com atividade, dobrando
+// até o máximo enquanto a leitura está estável
+#define AQUISICAO_TEMPERATURA_MAX_MS 60000  // DS18B20: 760 ms de barramento por leitura
+#define AQUISICAO_UMIDADE_MAX_MS 30000
+#define AQUISICAO_POS_IRRIGACAO_MS (5 * 60 * 1000)  // Leitura rápida até 5 min depois do relé desligar
+
+// Controle automático da irrigação (Bloco 10), sobre a umidade calibrada em %:
+// tensão do sensor medida com o solo seco e encharcado (0 % e 100 %)
+#define UMIDADE_V_SECO 0.8f
+#define UMIDADE_V_ENCHARCADO 2.6f
+#define IRRIGACAO_PERIODO_MS 100  // Ritmo fixo do controlador, no temporizador de hardware
+
+// Tabela de perfis de planta (regras.h), gravada pelo picotool no setor logo
+// antes do histórico; sem tabela válida, vale o perfil padrão
+#define REGRAS_FLASH_OFFSET (FLASHLOG_OFFSET - FLASH_SECTOR_SIZE)
+#define VASO_NUMERO 0             // Posição deste vaso na tabela (escolhe o perfil)
+
+// Modo frota (Bloco 11): vasos ligados, barramentos 1-Wire, DS18B20 lidos por
+// ciclo em cada barramento e ritmo do ciclo. Com 2 leituras por ciclo, um ciclo
+// leva ~15 ms de barramento no pior caso (2 x 7,7 ms, os barramentos em
+// paralelo), qualquer que seja o número de vasos ou de barramentos
+#define FROTA_VASOS 16
+#define FROTA_BARRAMENTOS 4
+#define FROTA_LEITURAS_POR_CICLO 2
+#define FROTA_PERIODO_MS 250
+#define FROTA_ENVIO_MS 30000        // Cada vaso sai por MQTT/UDP neste intervalo e quando muda
+#define FROTA_TOQUE_LONGO_MS 1000   // Botão A segurado: irrigação manual do vaso no display
+#define HTTP_PORTA 80               // Porta do servidor local (/data.json e /metrics)
 
 //-----------------------------------------------------------------------------------------------------
 // Bloco 3: Variáveis Globais
 //-----------------------------------------------------------------------------------------------------
 ssd1306_t oled;  // Estrutura para controle do display OLED
+
+// Última leitura dos sensores feita pelo laço principal. As amostras do ThingSpeak
+// usam esta cópia em vez de ler os sensores de novo (o DS18B20 leva 750 ms).
+typedef struct {
+    float temperatura_solo;
+    float tensao_umidade;
+    bool umidade_solo;
+    bool ldr_ativo;        // true = escuro
+    bool irrigacao;
+    bool plantinha_feliz;
+} leituras_t;
+leituras_t leituras;
+leituras_t leituras_publicadas;  // Última leitura formatada pelo servidor HTTP local
+
+// Relógio do histórico na flash: continua do último registro gravado antes do reboot
+// e passa para a hora UNIX quando o SNTP sincroniza (ver instante_historico_s())
+uint32_t relogio_log_base_s;
+
+uint32_t primeiro_quadro_ms;  // Do reset ao primeiro quadro completo do laço principal
+
+politica_t politica;  // Estado da política de envio (último envio, crédito do limite de taxa)
+
+// Canais de leitura com intervalo adaptativo e o tempo gasto pelo laço principal
+// (inclui a espera da conversão do DS18B20, mas não o sleep_ms() do fim da volta)
+aquisicao_canal_t canal_temperatura, canal_umidade;
+uint64_t laco_ocupado_us;
+uint32_t laco_voltas;
+
+// Controle da irrigação: roda no temporizador (Bloco 10); o laço principal só
+// escreve a umidade calibrada e lê o estado
+irrigacao_t irrigacao;
+volatile int16_t umidade_pdm;        // Última umidade calibrada, em décimos de %
+volatile uint32_t umidade_lida_ms;   // Instante dessa leitura
+volatile bool umidade_lida;          // Sem leitura ainda, o controlador não liga o relé
+struct repeating_timer timer_irrigacao;
+
+// Etapas vigiadas pelo monitor de prazos (vigia.h). As do laço têm folga sobre o
+// pior caso normal: a leitura do DS18B20 leva 760 ms, um apagamento de setor do
+// histórico até 400 ms, um quadro inteiro do display ~10 ms (com o I2C desistindo
+// em ~100 ms) e cyw43_arch_init() alguns segundos na carga do firmware do Wi-Fi.
+// A irrigação é periódica: sem passar pelo temporizador por 10 passos, a placa reinicia.
+enum { ETAPA_PARTIDA, ETAPA_SENSORES, ETAPA_ENVIO, ETAPA_DISPLAY, ETAPA_REDE, ETAPA_ESPERA, ETAPA_IRRIGACAO, ETAPAS };
+const vigia_etapa_t etapas_vigiadas[ETAPAS] = {
+    [ETAPA_PARTIDA] = {"partida", 10000, false},
+    [ETAPA_SENSORES] = {"sensores", 2000, false},
+    [ETAPA_ENVIO] = {"envio", 2000, false},
+    [ETAPA_DISPLAY] = {"display", 1000, false},
+    [ETAPA_REDE] = {"rede", 10000, false},
+    [ETAPA_ESPERA] = {"espera", 1000, false},
+    [ETAPA_IRRIGACAO] = {"irrigacao", 10 * IRRIGACAO_PERIODO_MS, true},
+};
+
+// Regras do estado da plantinha: tabela da flash (ou a padrão) e o estado do vaso
+regras_tabela_t tabela_regras;
+bool regras_da_flash;
+regras_vaso_t regras_vaso;
+
+#if MODO_FROTA
+frota_t frota;                      // Todos os vasos (Bloco 11)
+volatile uint8_t frota_exibido;     // Vaso mostrado no display, trocado pelo botão A
+#if ENVIO_UDP
+uint32_t frota_dispositivo;         // Identificação da placa (24 bits); o vaso vai no byte alto
+uint32_t frota_sequencia[FROTA_VASOS];  // Sequência dos datagramas de cada vaso
+#endif
+#endif
+
+// Widgets do display: rótulos fixos e os valores que mudam com as leituras
+ui_widget_t rotulo_umidade, rotulo_temperatura, rotulo_luz, rotulo_irrigacao;
+ui_widget_t valor_umidade, valor_temperatura, valor_luz, valor_irrigacao;
+ui_widget_t icone_luz, icone_wifi, icone_planta;  // Coluna à direita, abaixo do texto
+
+// Gráficos de histórico da temperatura e da umidade do solo (uma coluna por amostra)
+#define INTERVALO_HISTORICO_MS 10000  // 112 colunas x 10 s = ~19 minutos de histórico
+#define GRAFICO_LARGURA 112           // Colunas dos gráficos; à direita ficam os ícones
+ui_historico_t historico_temperatura, historico_umidade;
+ui_widget_t grafico_temperatura, grafico_umidade;
+
+ui_widget_t *const widgets_display[] = {
+    &rotulo_umidade, &valor_umidade,
+    &rotulo_temperatura, &valor_temperatura,
+    &rotulo_luz, &valor_luz,
+    &rotulo_irrigacao, &valor_irrigacao,
+    &grafico_temperatura, &grafico_umidade,
+    &icone_luz, &icone_wifi, &icone_planta,
+};
 PIO pio = pio0;  // PIO utilizado para comunicação 1-Wire
 
 uint offset;   // Variável usada para armazenar o deslocamento do programa 1-Wire no PIO (Programável I/O).
@@ -103,6 +290,8 @@ void configurar_hardware() {
     ssd1306_init(&oled, 128, 64, 0x3C, i2c1); // Configura o display com resolução 128x64 no endereço I2C 0x3C
 
     // **Inicialização do sensor de temperatura DS18B20 usando o protocolo 1-Wire**
+    // (no modo frota, os barramentos são do grupo iniciado por frota_init())
+#if !MODO_FROTA
     if (pio_can_add_program(pio, &onewire_program)) { // Verifica se o programa 1-Wire pode ser adicionado ao PIO
         offset = pio_add_program(pio, &onewire_program); // Adiciona o programa 1-Wire no PIO
 
@@ -113,6 +302,43 @@ void configurar_hardware() {
     } else {
         printf("Não foi possível adicionar o programa 1-Wire ao PIO.\n"); // Exibe erro caso não consiga adicionar o programa
     }
+#endif
+}
+
+// Monta a tela do display OLED com um widget para cada rótulo e valor.
+// Os valores ficam à direita dos rótulos (6 pixels por caractere da fonte).
+// As páginas 0-3 mostram o texto; as páginas 4-5 e 6-7 os gráficos de histórico.
+void configurar_display() {
+    ssd1306_clear(&oled);  // O buffer começa com lixo de memória e a GDDRAM com lixo do display
+    ssd1306_show(&oled);
+
+    ui_label(&rotulo_umidade, 0, 0, "Umidade solo:");
+    ui_label(&valor_umidade, 14 * UI_FONTE_LARGURA, 0, "");
+
+    ui_label(&rotulo_temperatura, 0, 8, "Temp. Solo:");
+    ui_value(&valor_temperatura, 12 * UI_FONTE_LARGURA, 8, 2, 2, " C");  // Centésimos de grau
+
+    ui_label(&rotulo_luz, 0, 16, "Luz:");
+    ui_label(&valor_luz, 5 * UI_FONTE_LARGURA, 16, "");
+
+    ui_label(&rotulo_irrigacao, 0, 24, "Irrig.:");  // Curto: o texto do estado termina antes dos ícones
+    ui_label(&valor_irrigacao, 8 * UI_FONTE_LARGURA, 24, "");
+
+    // Temperatura de 10 a 40 °C (centésimos) e tensão do sensor de umidade de 0 a 3,3 V (mV)
+    ui_sparkline(&grafico_temperatura, &historico_temperatura, 0, 32, GRAFICO_LARGURA, 16, 1000, 4000);
+    ui_sparkline(&grafico_umidade, &historico_umidade, 0, 48, GRAFICO_LARGURA, 16, 0, 3300);
+
+    // Ícones de 16x16 na coluna x = 112: luz (LDR), Wi-Fi e estado da plantinha
+    ui_icon(&icone_luz, GRAFICO_LARGURA, 16, NULL);
+    ui_icon(&icone_wifi, GRAFICO_LARGURA, 32, NULL);
+    ui_icon(&icone_planta, GRAFICO_LARGURA, 48, NULL);
+}
+
+// Troca os ícones que mudaram (o redesenho fica para ui_render())
+void atualizar_icones(bool luz, bool feliz) {
+    ui_set_icon(&icone_luz, luz ? &icon_sol : &icon_lua);
+    ui_set_icon(&icone_wifi, wifi_conectado() ? &icon_wifi_on : &icon_wifi_off);
+    ui_set_icon(&icone_planta, feliz ? &icon_planta_feliz : &icon_planta_triste);
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -154,8 +380,10 @@ float ler_temperatura_solo() {
         // Combina os dois bytes lidos em um número inteiro de 16 bits
         int16_t temp = (temp_msb << 8) | temp_lsb;
 
-        // Converte o valor para graus Celsius (cada unidade equivale a 1/16 °C)
-        temperatura = temp / 16.0;
+        // Converte o valor para graus Celsius (cada unidade equivale a 1/16 °C);
+        // 0xFFFF é o barramento solto ou a leitura que esgotou o tempo (OW_TIMEOUT_US)
+        if (temp != -1) temperatura = temp / 16.0;
+        else printf("Falha na leitura do sensor DS18B20.\n");
     } else {
         // Caso a comunicação com o sensor DS18B20 falhe, exibe uma mensagem no console
         printf("Falha na comunicação com o sensor DS18B20.\n");
@@ -164,6 +392,35 @@ float ler_temperatura_solo() {
     return temperatura; // Retorna o valor da temperatura lida do sensor
 }
 
+// Ritmo de leitura de cada canal: intervalo curto e longo, ruído do sensor, taxa
+// de variação que conta como atividade e corrente do periférico durante a leitura
+const aquisicao_config_t config_temperatura = {
+    .nome = "temperatura",
+    .intervalo_min_ms = 1000,  // Com atividade, a cada volta do laço
+    .intervalo_max_ms = AQUISICAO_TEMPERATURA_MAX_MS,
+    .ruido = 0.07f,            // Um passo de 0,0625 °C do DS18B20
+    .taxa_min = 0.1f,          // °C por minuto
+    .corrente_ua = 1000,       // DS18B20 convertendo (1 mA típico)
+};
+const aquisicao_config_t config_umidade = {
+    .nome = "umidade",
+    .intervalo_min_ms = 500,
+    .intervalo_max_ms = AQUISICAO_UMIDADE_MAX_MS,
+    .ruido = 0.02f,            // Ruído do ADC, em volts
+    .taxa_min = 0.05f,         // V por minuto
+    .corrente_ua = 300,        // ADC do RP2040 convertendo
+};
+
+// Lê o canal se for a vez dele, registrando o valor e o tempo gasto na leitura.
+// Fora da vez, `valor` fica com a leitura anterior.
+bool ler_canal(aquisicao_canal_t *canal, float (*ler)(void), float *valor, uint32_t agora_ms) {
+    if (!aquisicao_devida(canal, agora_ms)) return false;
+    uint64_t inicio_us = time_us_64();
+    *valor = ler();
+    aquisicao_registrar(canal, *valor, agora_ms, (uint32_t)(time_us_64() - inicio_us));
+    return true;
+}
+
 
 //-----------------------------------------------------------------------------------------------------
 // Bloco 6: Funções auxiliares dos sensores
@@ -185,207 +442,782 @@ bool getBoolUmidadeSolo(float tensao_umidade){
 }
 
 
-bool decidir_estado_plantinha(float umidade_solo, float temperatura_solo, bool ldr_ativo) {
-    // Verifica se todas as condições para a felicidade da plantinha estão sendo atendidas
-    if (umidade_solo == true &&                // O solo está úmido?
-        temperatura_solo >= 20 &&              // A temperatura está acima de 20°C?
-        temperatura_solo <= 35 &&              // A temperatura está abaixo de 35°C?
-        ldr_ativo == false) {                  // Existe luz?
-        
-        return true;  // A plantinha está feliz !
-    } 
-    else {
-        return false; // A plantinha não está feliz !
-    }
+// Converte a tensão do sensor de umidade em décimos de % pela calibração de
+// UMIDADE_V_SECO e UMIDADE_V_ENCHARCADO (pode passar um pouco de 0 % ou 100 %)
+int16_t calibrar_umidade(float tensao_umidade) {
+    float pct = (tensao_umidade - UMIDADE_V_SECO) / (UMIDADE_V_ENCHARCADO - UMIDADE_V_SECO) * 100.0f;
+    return (int16_t)lroundf(pct * 10.0f);  // 1,5 V dá 389 (38,9 %), o mínimo do perfil padrão
+}
+
+// Carrega a tabela de perfis da flash (ou a padrão) e as regras deste vaso
+void carregar_regras(void) {
+    regras_da_flash = regras_carregar(&tabela_regras, (const void *)(XIP_BASE + REGRAS_FLASH_OFFSET),
+                                      FLASH_SECTOR_SIZE);
+    if (!regras_da_flash) regras_tabela_padrao(&tabela_regras);
+    regras_vaso_init(&regras_vaso, &tabela_regras, regras_perfil_do_vaso(&tabela_regras, VASO_NUMERO));
+    printf("Regras: perfil %.*s, %u regras (%s)\n", REGRAS_NOME_MAX, regras_vaso.perfil, regras_vaso.quantidade,
+           regras_da_flash ? "tabela da flash" : "padrão");
+}
+
+// Decide se a plantinha está feliz pelas regras do perfil do vaso. Cada leitura
+// só reavalia as regras da sua entrada quando cruza um limiar (ver regras.h).
+bool decidir_estado_plantinha(int16_t umidade_pdm, float temperatura_solo, bool ldr_ativo, uint32_t agora_ms) {
+    regras_atualizar(&regras_vaso, REGRAS_UMIDADE, umidade_pdm, agora_ms);
+    regras_atualizar(&regras_vaso, REGRAS_TEMPERATURA, (int16_t)lroundf(temperatura_solo * 100.0f), agora_ms);
+    regras_atualizar(&regras_vaso, REGRAS_LUZ, !ldr_ativo, agora_ms);
+    regras_tempo(&regras_vaso, agora_ms);  // Regras com duração ("seco há mais de 10 min")
+    return regras_vaso.feliz;
 }
 
 //-----------------------------------------------------------------------------------------------------
 // Bloco 7: Comunicação com ThingSpeak
 //-----------------------------------------------------------------------------------------------------
 
-// Callback quando recebe resposta do ThingSpeak
-static err_t http_recv_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
-    if (p == NULL) {
-        tcp_close(tpcb);
-        return ERR_OK;
+#if ENVIO_MQTT
+// Publica `valor` em "<prefixo>/<metrica>" ou, com `vaso` (modo frota), em "<prefixo>/<vaso>/<metrica>"
+void publicar_metrica(const char *vaso, const char *metrica, const char *valor) {
+    char topico[MQ_TOPICO_MAX];
+    if (vaso) snprintf(topico, sizeof(topico), "%s/%s", vaso, metrica);
+    mq_publicar(vaso ? topico : metrica, valor);
+}
+
+// Publica cada métrica da amostra no seu tópico, com o valor em texto e sem
+// ponto flutuante (a temperatura já vem em centésimos e a umidade em mV).
+// Sem leitura de temperatura (INT16_MIN, vaso da frota sem DS18B20), o tópico dela fica como está.
+void publicar_mqtt(const char *vaso, const amostra_t *a, uint16_t umidade_mv) {
+    const mq_stats_t *stats = mq_stats();
+    uint32_t bytes_antes = stats->bytes;
+    char valor[12];
+    int t = a->temperatura_centi;
+    if (t != INT16_MIN) {
+        snprintf(valor, sizeof(valor), "%s%d.%02d", t < 0 ? "-" : "", (t < 0 ? -t : t) / 100, (t < 0 ? -t : t) % 100);
+        publicar_metrica(vaso, "temperatura", valor);
     }
-    printf("Resposta do ThingSpeak: %.*s\n", p->len, (char *)p->payload);
-    pbuf_free(p);
-    return ERR_OK;
+    snprintf(valor, sizeof(valor), "%u.%03u", umidade_mv / 1000, umidade_mv % 1000);
+    publicar_metrica(vaso, "umidade", valor);
+    publicar_metrica(vaso, "umido", a->estados & AMOSTRA_UMIDO ? "1" : "0");
+    publicar_metrica(vaso, "luz", a->estados & AMOSTRA_LUZ ? "1" : "0");
+    publicar_metrica(vaso, "irrigacao", a->estados & AMOSTRA_IRRIGANDO ? "1" : "0");
+    publicar_metrica(vaso, "feliz", a->estados & AMOSTRA_FELIZ ? "1" : "0");
+    if (vaso) return;  // Modo frota: um vaso por volta, sem linha no monitor serial
+    printf("MQTT: %lu bytes nesta amostra, latência %lu us (média %lu us)\n",
+           (unsigned long)(stats->bytes - bytes_antes), (unsigned long)stats->latencia_ultima_us,
+           (unsigned long)(stats->confirmadas ? stats->latencia_total_us / stats->confirmadas : 0));
+}
+#endif
+
+// Instante de uma amostra no relógio do histórico (flash e telemetria UDP). Antes da
+// sincronização, continua do último registro gravado; depois, é a hora UNIX. Nunca
+// volta para trás: se o relógio já estiver adiantado, segue adiantado até ser alcançado.
+uint32_t instante_historico_s(uint32_t desde_boot_s) {
+    uint32_t unix_s = relogio_unix_s((uint64_t)desde_boot_s * 1000000);
+    if (unix_s > relogio_log_base_s + desde_boot_s) relogio_log_base_s = unix_s - desde_boot_s;
+    return relogio_log_base_s + desde_boot_s;
 }
 
-// Callback quando a conexão TCP é estabelecida
-static err_t http_connected_callback(void *arg, struct tcp_pcb *tpcb, err_t err) {
-    if (err != ERR_OK) {
-        printf("Erro na conexão TCP\n");
-        return err;
+// Guarda a leitura na fila de amostras com o instante da coleta. Os lotes são
+// montados e enviados por amostras_poll(), com ou sem Wi-Fi no momento da coleta.
+// Com ENVIO_MQTT, a amostra é publicada no broker em vez de entrar na fila.
+// Uma amostra `urgente` (mudança de estado) faz o lote sair sem esperar encher.
+void registrar_amostra(const leituras_t *l, bool urgente) {
+    amostra_t amostra = {
+        .instante_s = (uint32_t)(time_us_64() / 1000000),  // Convertido para hora real no envio
+        .temperatura_centi = (int16_t)lroundf(l->temperatura_solo * 100.0f),
+        .estados = (l->umidade_solo ? AMOSTRA_UMIDO : 0) |      // Field2: 1 = Úmido
+                   (l->ldr_ativo ? 0 : AMOSTRA_LUZ) |           // Field3: mesmo valor enviado antes pelo GET
+                   (l->irrigacao ? AMOSTRA_IRRIGANDO : 0) |     // Field4: 1 = Ativada
+                   (l->plantinha_feliz ? AMOSTRA_FELIZ : 0),    // Field5: 1 = Feliz
+    };
+#if ENVIO_MQTT
+    publicar_mqtt(NULL, &amostra, (uint16_t)(l->tensao_umidade * 1000.0f));
+#else
+    if (wifi_pilha_pronta()) {  // Sem o chip Wi-Fi, fica só na flash
+        amostras_adicionar(&amostra);
+        if (urgente) amostras_enviar_agora();
     }
+#endif
+    uint32_t instante_historico = instante_historico_s(amostra.instante_s);
+#if ENVIO_UDP
+    if (wifi_pilha_pronta()) {
+        // Instante no relógio do histórico, que continua crescendo entre reboots
+        tlm_amostra_t telemetria = {
+            .instante_s = instante_historico,
+            .temperatura_centi = amostra.temperatura_centi,
+            .umidade_mv = (uint16_t)(l->tensao_umidade * 1000.0f),
+            .estados = amostra.estados,
+        };
+        telemetria_adicionar(&telemetria);
+        if (urgente) telemetria_enviar_agora();
+    }
+#endif
+
+    // A mesma amostra vai para o histórico local, com a tensão do sensor de umidade
+    flashlog_registro_t registro = {
+        .instante_s = instante_historico,
+        .temperatura_centi = amostra.temperatura_centi,
+        .umidade_mv = (uint16_t)(l->tensao_umidade * 1000.0f),
+        .estados = amostra.estados,  // Mesmos bits (FLASHLOG_* = AMOSTRA_*)
+    };
+    flashlog_adicionar(&registro);
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Bloco 8: Servidor HTTP Local
+//-----------------------------------------------------------------------------------------------------
 
-    printf("Conectado ao ThingSpeak!\n");
-
-    // **Leitura dos sensores**
-    float temperatura_solo = ler_temperatura_solo();
-    float tensao_umidade = ler_tensao_umidade();
-    bool umidade_solo_bool = getBoolUmidadeSolo(tensao_umidade);
-    bool ldr_ativo_bool = ler_estado_ldr();  // 1 = Escuro, 0 = Claro
-    bool irrigacao_rele_bool = gpio_get(RELAY_GPIO);
-    bool plantinha_feliz_bool = decidir_estado_plantinha(umidade_solo_bool, temperatura_solo, ldr_ativo_bool);
-
-    // **Converte os valores booleanos para inteiros (ThingSpeak aceita apenas números)**
-    int umidade_solo = umidade_solo_bool ? 1 : 0;
-    int ldr_ativo = ldr_ativo_bool ? 0 : 1;
-    int irrigacao_rele = irrigacao_rele_bool ? 1 : 0;
-    int plantinha_feliz = plantinha_feliz_bool ? 1 : 0;
-
-    // **Monta a requisição HTTP com apenas 5 fields**
-    char request[512];
-    snprintf(request, sizeof(request),
-        "GET /update?api_key=%s"
-        "&field1=%.2f"  // Temperatura do solo
-        "&field2=%d"    // Umidade do solo (1 = Úmido, 0 = Seco)
-        "&field3=%d"    // Luz (1 = Escuro, 0 = Claro)
-        "&field4=%d"    // Irrigação ativa (1 = Ativada, 0 = Desativada)
-        "&field5=%d"    // Plantinha feliz (1 = Sim, 0 = Não)
-        " HTTP/1.1\r\n"
-        "Host: %s\r\n"
-        "Connection: close\r\n"
-        "\r\n",
-        API_KEY, temperatura_solo, umidade_solo, ldr_ativo, irrigacao_rele, plantinha_feliz,
-        THINGSPEAK_HOST);
-
-    tcp_write(tpcb, request, strlen(request), TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
-    tcp_recv(tpcb, http_recv_callback);
-
-    return ERR_OK;
+// Corpo de /data.json com a última leitura
+size_t gerar_json(char *destino, size_t tamanho) {
+#if MODO_FROTA
+    return frota_json(&frota, destino, tamanho);  // Um objeto por vaso
+#endif
+    const leituras_t *l = &leituras_publicadas;
+    int n = snprintf(destino, tamanho,
+                     "{\"temperatura_solo\":%.2f,\"tensao_umidade\":%.3f,\"umidade_solo\":%s,"
+                     "\"umidade_pct\":%.1f,\"luz\":%s,\"irrigacao\":%s,\"irrigacao_estado\":\"%s\","
+                     "\"plantinha_feliz\":%s,\"perfil\":\"%.*s\",\"instante_s\":%lu,\"unix_s\":%lu}\n",
+                     l->temperatura_solo, l->tensao_umidade, l->umidade_solo ? "true" : "false",
+                     umidade_pdm / 10.0, l->ldr_ativo ? "false" : "true", l->irrigacao ? "true" : "false",
+                     irrigacao_nome(irrigacao.estado),
+                     l->plantinha_feliz ? "true" : "false", REGRAS_NOME_MAX, regras_vaso.perfil,
+                     (unsigned long)(to_ms_since_boot(get_absolute_time()) / 1000),
+                     (unsigned long)relogio_agora_s());  // 0 antes da sincronização
+    return n > 0 ? (size_t)n : 0;
 }
 
-// Resolver DNS e conectar ao servidor
-static void dns_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg) {
-    if (ipaddr) {
-        printf("Endereço IP do ThingSpeak: %s\n", ipaddr_ntoa(ipaddr));
-        tcp_client_pcb = tcp_new();
-        tcp_connect(tcp_client_pcb, ipaddr, THINGSPEAK_PORT, http_connected_callback);
-    } else {
-        printf("Falha na resolução de DNS\n");
+// Corpo de /metrics no formato de texto do Prometheus. Os contadores são os do
+// momento da publicação (a cada leitura nova ou amostra), não os da requisição.
+size_t gerar_metricas(char *destino, size_t tamanho) {
+    const flashlog_stats_t *fl = flashlog_stats();
+    const http_servidor_stats_t *http = http_servidor_stats();
+    const wifi_stats_t *wifi = wifi_stats();
+    const relogio_stats_t *rel = relogio_stats();
+    uint64_t agora_us = time_us_64();
+    int n = snprintf(destino, tamanho,
+        "# TYPE vaso_uptime_segundos counter\nvaso_uptime_segundos %lu\n"
+        "vaso_flashlog_registros_total %lu\nvaso_flashlog_bytes_total %lu\n"
+        "vaso_flashlog_setores_apagados_total %lu\n"
+        "vaso_matriz_quadros_enviados_total %lu\nvaso_matriz_quadros_ignorados_total %lu\n"
+        "vaso_http_conexoes_total %lu\nvaso_http_conexoes_recusadas_total %lu\n"
+        "vaso_http_requisicoes_total %lu\nvaso_http_bytes_total %lu\nvaso_http_atualizacoes_total %lu\n"
+        "vaso_boot_primeiro_quadro_segundos %.3f\nvaso_wifi_primeira_conexao_segundos %.3f\n"
+        "vaso_wifi_init_segundos %.3f\nvaso_wifi_quedas_total %lu\nvaso_wifi_falhas_total %lu\n"
+        "vaso_wifi_ultima_reconexao_segundos %.3f\nvaso_wifi_reconexao_max_segundos %.3f\n"
+        "vaso_relogio_sincronizado %d\nvaso_relogio_unix_segundos %lu\nvaso_relogio_sincronizacoes_total %lu\n"
+        "vaso_relogio_ultimo_ajuste_segundos %.6f\nvaso_relogio_maior_ajuste_segundos %.6f\n"
+        "vaso_laco_voltas_total %lu\nvaso_laco_ocupacao %.4f\n",
+        (unsigned long)(to_ms_since_boot(get_absolute_time()) / 1000),
+        (unsigned long)fl->registros, (unsigned long)fl->bytes,
+        (unsigned long)fl->setores_apagados, (unsigned long)np_anim_envios,
+        (unsigned long)np_anim_ignorados, (unsigned long)http->conexoes, (unsigned long)http->recusadas,
+        (unsigned long)http->requisicoes, (unsigned long)http->bytes, (unsigned long)http->atualizacoes,
+        primeiro_quadro_ms / 1e3, wifi->primeira_conexao_ms / 1e3, wifi->init_ms / 1e3,
+        (unsigned long)wifi->quedas, (unsigned long)wifi->falhas, wifi->ultima_reconexao_ms / 1e3,
+        wifi->reconexao_max_ms / 1e3, relogio_sincronizado(), (unsigned long)relogio_agora_s(),
+        (unsigned long)rel->sincronizacoes, rel->ultimo_ajuste_us / 1e6, rel->maior_ajuste_us / 1e6,
+        (unsigned long)laco_voltas, agora_us ? (double)laco_ocupado_us / agora_us : 0.0);
+#if !MODO_FROTA
+    // Medidas do vaso único. Na frota o laço não passa por aqui: os canais de
+    // aquisição, a política e a irrigação nunca são inicializados, e cada vaso
+    // aparece em frota_metricas com o rótulo vaso="N".
+    const leituras_t *l = &leituras_publicadas;
+    const ts_stats_t *ts = ts_stats();
+    const amostras_stats_t *am = amostras_stats();
+    const politica_stats_t *pol = &politica.stats;
+    const irrigacao_stats_t *irr = &irrigacao.stats;
+    if (n > 0 && (size_t)n < tamanho) {
+        int m = snprintf(destino + n, tamanho - n,
+            "# TYPE vaso_temperatura_solo_celsius gauge\nvaso_temperatura_solo_celsius %.2f\n"
+            "# TYPE vaso_umidade_sensor_volts gauge\nvaso_umidade_sensor_volts %.3f\n"
+            "vaso_solo_umido %d\nvaso_luz %d\nvaso_irrigacao %d\nvaso_plantinha_feliz %d\n"
+            "vaso_thingspeak_respostas_total %lu\nvaso_thingspeak_conexoes_total %lu\n"
+            "vaso_thingspeak_falhas_total %lu\nvaso_thingspeak_latencia_ultima_segundos %.3f\n"
+            "vaso_amostras_fila %u\nvaso_amostras_enviadas_total %lu\nvaso_amostras_perdidas_total %lu\n"
+            "vaso_envios_total{motivo=\"pulsacao\"} %lu\nvaso_envios_total{motivo=\"banda\"} %lu\n"
+            "vaso_envios_total{motivo=\"evento\"} %lu\nvaso_envios_adiados_total %lu\n"
+            "vaso_envios_atraso_max_segundos %.3f\n"
+            "vaso_umidade_solo_porcento %.1f\nvaso_irrigacao_estado{estado=\"%s\"} 1\n"
+            "vaso_irrigacao_ciclos_total %lu\nvaso_irrigacao_pulsos_total %lu\nvaso_irrigacao_manuais_total %lu\n"
+            "vaso_irrigacao_bloqueios_total %lu\nvaso_irrigacao_ligada_segundos_total %.1f\n"
+            "vaso_regras_perfil{perfil=\"%.*s\",origem=\"%s\"} 1\nvaso_regras_motivo %d\n"
+            "vaso_regras_entradas_total %lu\nvaso_regras_avaliacoes_total %lu\nvaso_regras_mudancas_total %lu\n",
+            l->temperatura_solo, l->tensao_umidade, l->umidade_solo, !l->ldr_ativo, l->irrigacao,
+            l->plantinha_feliz, (unsigned long)ts->respostas, (unsigned long)ts->conexoes,
+            (unsigned long)ts->falhas, ts->latencia_ultima_us / 1e6, amostras_quantidade(),
+            (unsigned long)am->enviadas, (unsigned long)am->perdidas,
+            (unsigned long)pol->envios[POLITICA_PULSACAO], (unsigned long)pol->envios[POLITICA_BANDA],
+            (unsigned long)pol->envios[POLITICA_EVENTO], (unsigned long)pol->adiados, pol->atraso_max_ms / 1e3,
+            umidade_pdm / 10.0, irrigacao_nome(irrigacao.estado), (unsigned long)irr->ciclos,
+            (unsigned long)irr->pulsos, (unsigned long)irr->manuais, (unsigned long)irr->bloqueios,
+            irr->ligada_ms / 1e3, REGRAS_NOME_MAX, regras_vaso.perfil, regras_da_flash ? "flash" : "padrao",
+            regras_vaso.motivo, (unsigned long)regras_vaso.stats.entradas,
+            (unsigned long)regras_vaso.stats.avaliacoes, (unsigned long)regras_vaso.stats.mudancas);
+        n = m > 0 ? n + m : 0;
+    }
+    const aquisicao_canal_t *canais[] = {&canal_temperatura, &canal_umidade};
+    for (size_t i = 0; i < sizeof(canais) / sizeof(canais[0]) && n > 0 && (size_t)n < tamanho; ++i) {
+        const aquisicao_canal_t *c = canais[i];
+        const char *nome = c->config->nome;
+        uint32_t decorrido_ms = (uint32_t)(agora_us / 1000);
+        int m = snprintf(destino + n, tamanho - n,
+            "vaso_aquisicao_leituras_total{canal=\"%s\"} %lu\nvaso_aquisicao_aceleracoes_total{canal=\"%s\"} %lu\n"
+            "vaso_aquisicao_intervalo_segundos{canal=\"%s\"} %.1f\nvaso_aquisicao_ocupacao{canal=\"%s\"} %.5f\n"
+            "vaso_aquisicao_corrente_media_microamperes{canal=\"%s\"} %.1f\n",
+            nome, (unsigned long)c->stats.leituras, nome, (unsigned long)c->stats.aceleracoes,
+            nome, c->intervalo_ms / 1e3, nome, aquisicao_ocupacao(c, decorrido_ms),
+            nome, aquisicao_corrente_media_ua(c, decorrido_ms));
+        n = m > 0 ? n + m : 0;
+    }
+#endif
+    const vigia_relatorio_t *vr = vigia_relatorio();
+    if (n > 0 && (size_t)n < tamanho) {
+        int m = snprintf(destino + n, tamanho - n,
+            "vaso_vigia_reinicios_total %lu\nvaso_vigia_reinicio_sem_registro %d\nvaso_vigia_conferencias_total %lu\n"
+            "vaso_onewire_tempos_esgotados_total %u\n",
+            (unsigned long)vr->reinicios, vr->reinicio && !vr->registrado,
+            (unsigned long)vigia_stats()->conferencias, ow.timeouts);
+        n = m > 0 ? n + m : 0;
+    }
+    if (vr->registrado && n > 0 && (size_t)n < tamanho) {  // Etapa que parou antes deste boot
+        int m = snprintf(destino + n, tamanho - n,
+            "vaso_vigia_ultimo_reinicio{etapa=\"%s\"} 1\nvaso_vigia_ultima_parada_segundos %.3f\n"
+            "vaso_vigia_ultima_parada_instante_segundos %.3f\n",
+            vigia_nome(vr->etapa), vr->parada_ms / 1e3, vr->instante_ms / 1e3);
+        n = m > 0 ? n + m : 0;
+    }
+    for (uint8_t i = 0; i < ETAPAS && n > 0 && (size_t)n < tamanho; ++i) {
+        int m = snprintf(destino + n, tamanho - n,
+            "vaso_vigia_etapa_max_segundos{etapa=\"%s\"} %.3f\nvaso_vigia_etapa_prazo_segundos{etapa=\"%s\"} %.3f\n",
+            etapas_vigiadas[i].nome, vigia_stats()->max_ms[i] / 1e3, etapas_vigiadas[i].nome,
+            etapas_vigiadas[i].prazo_ms / 1e3);
+        n = m > 0 ? n + m : 0;
     }
+#if ENVIO_MQTT
+    const mq_stats_t *mqs = mq_stats();
+    if (n > 0 && (size_t)n < tamanho) {
+        int m = snprintf(destino + n, tamanho - n,
+            "vaso_mqtt_conectado %d\nvaso_mqtt_publicadas_total %lu\nvaso_mqtt_confirmadas_total %lu\n"
+            "vaso_mqtt_falhas_total %lu\nvaso_mqtt_bytes_total %lu\nvaso_mqtt_latencia_ultima_segundos %.6f\n",
+            mq_conectado(), (unsigned long)mqs->publicadas, (unsigned long)mqs->confirmadas,
+            (unsigned long)mqs->falhas, (unsigned long)mqs->bytes, mqs->latencia_ultima_us / 1e6);
+        n = m > 0 ? n + m : 0;
+    }
+#endif
+#if ENVIO_UDP
+    const telemetria_stats_t *tls = telemetria_stats();
+    if (n > 0 && (size_t)n < tamanho) {
+        int m = snprintf(destino + n, tamanho - n,
+            "vaso_udp_datagramas_total %lu\nvaso_udp_amostras_total %lu\nvaso_udp_bytes_total %lu\n"
+            "vaso_udp_falhas_total %lu\nvaso_udp_descartadas_total %lu\n",
+            (unsigned long)tls->datagramas, (unsigned long)tls->amostras, (unsigned long)tls->bytes,
+            (unsigned long)tls->falhas, (unsigned long)tls->descartadas);
+        n = m > 0 ? n + m : 0;
+    }
+#endif
+#if MODO_FROTA
+    if (n > 0 && (size_t)n < tamanho) {
+        size_t m = frota_metricas(&frota, destino + n, tamanho - n);
+        n = m ? n + (int)m : 0;
+    }
+#endif
+    if (n > 0 && (size_t)n < tamanho) {
+        size_t m = lwip_uso_metricas(destino + n, tamanho - n);  // Heap, pools e quadros do lwIP
+        n = m ? n + (int)m : 0;
+    }
+    return n > 0 ? (size_t)n : 0;
+}
+
+// Refaz as respostas do servidor local só quando a leitura muda (ou quando uma
+// amostra nova altera os contadores); as requisições apenas reenviam o buffer pronto.
+void publicar_leituras(bool forcar) {
+    const leituras_t *a = &leituras, *b = &leituras_publicadas;
+    bool mudou = a->temperatura_solo != b->temperatura_solo || a->tensao_umidade != b->tensao_umidade ||
+                 a->umidade_solo != b->umidade_solo || a->ldr_ativo != b->ldr_ativo ||
+                 a->irrigacao != b->irrigacao || a->plantinha_feliz != b->plantinha_feliz;
+    if (!mudou && !forcar) return;
+    cyw43_arch_lwip_begin();  // Uma publicação adiada pode ser refeita num callback do lwIP
+    leituras_publicadas = leituras;
+    http_servidor_publicar();
+    cyw43_arch_lwip_end();
+}
+
+// Serviços que usam o lwIP, iniciados quando o chip Wi-Fi fica pronto (ainda sem IP:
+// cada um conecta sozinho quando a rede chegar)
+void iniciar_rede(void) {
+#if ENVIO_MQTT
+    mq_init(MQTT_BROKER, MQTT_PORT, MQTT_CLIENT_ID, MQTT_PREFIXO, MQTT_QOS);  // Conecta em mq_poll()
+#endif
+#if ENVIO_UDP
+    // Identificação: 32 bits baixos do número de série único da flash
+    pico_unique_board_id_t id;
+    pico_get_unique_board_id(&id);
+    uint32_t dispositivo = id.id[4] | id.id[5] << 8 | id.id[6] << 16 | (uint32_t)id.id[7] << 24;
+    telemetria_init(TELEMETRIA_COLETOR, TELEMETRIA_PORTA, dispositivo);
+#if MODO_FROTA
+    frota_dispositivo = dispositivo & 0x00FFFFFF;
+#endif
+    printf("Telemetria UDP para %s:%d, dispositivo %08lx\n", TELEMETRIA_COLETOR, TELEMETRIA_PORTA,
+           (unsigned long)dispositivo);
+#endif
+    lwip_uso_imprimir();  // RAM reservada pelo perfil de lwipopts.h
+    relogio_init(NTP_SERVIDOR);  // Consulta o servidor quando a rede chegar, e depois a cada hora
+    // Servidor local: http://<ip da placa>/data.json e /metrics
+    if (http_servidor_lwip_init(HTTP_PORTA)) printf("Servidor HTTP na porta %d\n", HTTP_PORTA);
+    publicar_leituras(true);
 }
 
 //-----------------------------------------------------------------------------------------------------
-// Bloco 8: Temporizador para Envio de Dados
+// Bloco 9: Política de Envio das Amostras
 //-----------------------------------------------------------------------------------------------------
 
-//Função de callback do temporizador para envio de dados para o ThingSpeaks
-bool repeating_timer_callback(struct repeating_timer *t) {
-    printf("Enviando dados para o ThingSpeak...\n");
-    dns_gethostbyname(THINGSPEAK_HOST, &server_ip, dns_callback, NULL);
-    return true;  // Mantém o temporizador ativo
+// Campos comparados com o último envio: os dois contínuos com banda morta e os
+// estados discretos (banda 0), que são enviados assim que mudam
+const politica_config_t politica_config = {
+    .campos = 6,
+    .banda = {ENVIO_BANDA_TEMPERATURA, ENVIO_BANDA_UMIDADE, 0, 0, 0, 0},
+    .pulsacao_ms = ENVIO_PULSACAO_MS,
+    .intervalo_ms = ENVIO_INTERVALO_MS,
+    .rajada = ENVIO_RAJADA,
+};
+
+// Avalia a leitura a cada volta do laço: a latência de um evento (relé ligado,
+// plantinha triste) é a de uma volta, e não mais até 30 s mais o lote
+politica_motivo_t avaliar_envio(const leituras_t *l) {
+    float valores[] = {l->temperatura_solo, l->tensao_umidade, l->umidade_solo, l->ldr_ativo,
+                       l->irrigacao, l->plantinha_feliz};
+    return politica_avaliar(&politica, valores, to_ms_since_boot(get_absolute_time()));
 }
 
 //-----------------------------------------------------------------------------------------------------
-// Bloco 9: Função Principal
+// Bloco 10: Controle Automático da Irrigação
 //-----------------------------------------------------------------------------------------------------
-int main() {
 
-    npInit(7);  // Inicializa a matriz de LEDs
+// Histerese de 35 % a 50 % em pulsos de 20 s com 4 min de molho entre eles,
+// ajustada em tools/irrigacao_sim.c. A trava de 5 min por ciclo é ~30 % de
+// umidade com a bomba do projeto; passar disso indica sensor solto ou falta d'água.
+const irrigacao_config_t irrigacao_config = {
+    .liga_pdm = 350,
+    .desliga_pdm = 500,
+    .pulso_ms = 20 * 1000,
+    .molho_ms = 4 * 60 * 1000,
+    .ciclo_max_ms = 5 * 60 * 1000,
+    .desligado_min_ms = 30 * 60 * 1000,
+    .pausa_ms = 60 * 60 * 1000,       // Botão B: automático suspenso por 1 hora
+    .bloqueio_ms = 6 * 60 * 60 * 1000,
+    .validade_ms = 2 * 60 * 1000,     // Quatro vezes o intervalo máximo de leitura da umidade
+};
+
+// Texto do estado no display (sem acentos, que a fonte não tem)
+const char *const textos_irrigacao[IRRIGACAO_ESTADOS] = {
+    [IRRIGACAO_OCIOSA] = "Auto",   [IRRIGACAO_PULSO] = "Irrigando", [IRRIGACAO_MOLHO] = "Molho",
+    [IRRIGACAO_MANUAL] = "Manual", [IRRIGACAO_PAUSA] = "Pausa",     [IRRIGACAO_BLOQUEADA] = "Bloqueada",
+};
+
+// Passo do controlador, em ritmo fixo pelo temporizador de hardware: o tempo dos
+// pulsos e das travas não depende do laço principal (que pode levar 760 ms numa
+// leitura do DS18B20). Os botões são lidos aqui, na borda de descida:
+// A liga a irrigação manual e B desliga e pausa o automático.
+bool irrigacao_tick(struct repeating_timer *t) {
+    static bool a_antes, b_antes;
+    bool a = !gpio_get(BUTTON_A), b = !gpio_get(BUTTON_B);  // LOW = pressionado
+    irrigacao_comando_t comando = a && !a_antes ? IRRIGACAO_LIGAR
+                                : b && !b_antes ? IRRIGACAO_DESLIGAR : IRRIGACAO_NENHUM;
+    a_antes = a;
+    b_antes = b;
+
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t idade_ms = umidade_lida ? agora_ms - umidade_lida_ms : UINT32_MAX;
+    gpio_put(RELAY_GPIO, irrigacao_passo(&irrigacao, umidade_pdm, idade_ms, comando, agora_ms));
+    vigia_marcar(ETAPA_IRRIGACAO);
+    return true;  // Mantém o temporizador ativo
+}
 
-    configurar_hardware();  // Chama a função que configura todos os periféricos e sensores
+//-----------------------------------------------------------------------------------------------------
+// Bloco 11: Modo Frota
+//-----------------------------------------------------------------------------------------------------
+#if MODO_FROTA
+
+// Multiplexador 0 no ADC0 (GPIO 26) e multiplexador 1 no ADC1 (GPIO 27); a
+// calibração da umidade é a mesma do vaso único
+const frota_config_t frota_config = {
+    .vasos = FROTA_VASOS,
+    .mux_s0 = FROTA_MUX_S0_GPIO,
+    .mux_adc = {0, 1},
+    .hc595_dados = FROTA_HC595_DADOS_GPIO,
+    .hc595_clock = FROTA_HC595_CLOCK_GPIO,
+    .hc595_trava = FROTA_HC595_TRAVA_GPIO,
+    .hc595_oe = FROTA_HC595_OE_GPIO,
+    .barramentos = FROTA_BARRAMENTOS,
+    .onewire_gpio = FROTA_ONEWIRE_GPIOS,
+    .leituras_por_ciclo = FROTA_LEITURAS_POR_CICLO,
+    .seco_mv = (uint16_t)(UMIDADE_V_SECO * 1000),
+    .encharcado_mv = (uint16_t)(UMIDADE_V_ENCHARCADO * 1000),
+};
+
+// Temporizador da irrigação no modo frota: os controladores de todos os vasos
+// no mesmo passo. Um toque em A (ao soltar) passa o display para o próximo vaso;
+// A segurado por FROTA_TOQUE_LONGO_MS liga a irrigação manual do vaso mostrado.
+// B desliga e pausa todos.
+bool frota_tick(struct repeating_timer *t) {
+    static bool b_antes;
+    static uint32_t a_ms;  // Tempo com A pressionado
+    bool a = !gpio_get(BUTTON_A), b = !gpio_get(BUTTON_B);  // LOW = pressionado
+    irrigacao_comando_t comando = IRRIGACAO_NENHUM;
+    uint32_t vasos = 0;
+    if (a) {
+        if (a_ms < FROTA_TOQUE_LONGO_MS && (a_ms += IRRIGACAO_PERIODO_MS) >= FROTA_TOQUE_LONGO_MS) {
+            comando = IRRIGACAO_LIGAR;  // Uma vez por toque; soltar depois não troca o vaso
+            vasos = 1u << frota_exibido;
+        }
+    } else {
+        if (a_ms && a_ms < FROTA_TOQUE_LONGO_MS) frota_exibido = (frota_exibido + 1) % FROTA_VASOS;
+        a_ms = 0;
+    }
+    if (b && !b_antes) {
+        comando = IRRIGACAO_DESLIGAR;
+        vasos = UINT32_MAX;
+    }
+    b_antes = b;
 
-    // Variáveis que armazenam os estados da plantinha e da irrigação
-    bool plantinha_feliz = false;  
-    bool irrigacao_rele = false;  
+    frota_irrigar(&frota, comando, vasos, to_ms_since_boot(get_absolute_time()));
+    vigia_marcar(ETAPA_IRRIGACAO);
+    return true;  // Mantém o temporizador ativo
+}
 
-    // Inicializa o Wi-Fi
-    if (cyw43_arch_init()) {  // Tenta iniciar o módulo Wi-Fi
-        printf("Falha ao iniciar Wi-Fi\n");  // Exibe mensagem de erro se falhar
-        return 1;  // Encerra o programa com erro
+// Display com o vaso escolhido pelo botão A; os gráficos recomeçam a cada troca
+void frota_exibir(uint8_t vaso, bool trocou) {
+    char texto[UI_TEXTO_MAX];
+    if (trocou) {
+        // Até 10 letras do perfil: o texto termina antes do ícone da luz
+        snprintf(texto, sizeof(texto), "%u %.*s", vaso, 10, frota.regras[vaso].perfil);
+        ui_set_text(&valor_luz, texto);
+        ui_sparkline(&grafico_temperatura, &historico_temperatura, 0, 32, GRAFICO_LARGURA, 16, 1000, 4000);
+        ui_sparkline(&grafico_umidade, &historico_umidade, 0, 48, GRAFICO_LARGURA, 16, 0, 3300);
     }
+    int16_t u = frota.umidade_pdm[vaso];
+    snprintf(texto, sizeof(texto), "%s%d.%d%%", u < 0 ? "-" : "", abs(u) / 10, abs(u) % 10);
+    ui_set_text(&valor_umidade, texto);
+    ui_set_value(&valor_temperatura, frota.temperatura_centi[vaso]);
+    ui_set_text(&valor_irrigacao, textos_irrigacao[frota.irrigacao[vaso].estado]);
+}
+
+#if ENVIO_MQTT || ENVIO_UDP
+// Envia as leituras de um vaso: MQTT em "<prefixo>/<vaso>/<métrica>" e UDP como o
+// dispositivo do vaso, com a mesma amostra do vaso único (instante e estados)
+void frota_enviar_vaso(uint8_t i, bool luz) {
+    amostra_t amostra = {
+        .instante_s = (uint32_t)(time_us_64() / 1000000),
+        .temperatura_centi = frota.temperatura_ok & 1u << i ? frota.temperatura_centi[i] : INT16_MIN,
+        .estados = (frota.umidade_mv[i] >= LIMIAR_UMIDADE * 1000 ? AMOSTRA_UMIDO : 0) |
+                   (luz ? AMOSTRA_LUZ : 0) |
+                   (frota.reles >> i & 1 ? AMOSTRA_IRRIGANDO : 0) |
+                   (frota.feliz >> i & 1 ? AMOSTRA_FELIZ : 0),
+    };
+#if ENVIO_MQTT
+    char vaso[4];
+    snprintf(vaso, sizeof(vaso), "%u", i);
+    publicar_mqtt(vaso, &amostra, frota.umidade_mv[i]);
+#endif
+#if ENVIO_UDP
+    if (wifi_conectado()) {
+        tlm_amostra_t telemetria = {
+            .instante_s = instante_historico_s(amostra.instante_s),
+            .temperatura_centi = amostra.temperatura_centi,
+            .umidade_mv = frota.umidade_mv[i],
+            .estados = amostra.estados,
+        };
+        telemetria_enviar_de(frota_dispositivo | (uint32_t)i << 24, &frota_sequencia[i], &telemetria, 1);
+    }
+#endif
+}
+#endif
+
+// Laço do modo frota, no lugar do laço do vaso único. Cada ciclo lê a umidade
+// de todos os vasos, avança a rodada de temperatura e reavalia as regras; as
+// respostas do servidor local são refeitas a cada rodada ou quando um vaso
+// muda de estado. Com MQTT ou UDP, todos os vasos são enviados a cada
+// FROTA_ENVIO_MS, e um vaso que muda (feliz ou relé) entra na frente; sai um vaso
+// por volta, para não encher o cliente MQTT de uma vez. A matriz resume a frota:
+// alerta com algum vaso bloqueado, gota com algum relé ligado, carinha feliz só
+// com todos os vasos felizes.
+void laco_frota(void) {
+    bool rede_iniciada = false;
+    uint32_t feliz_publicado = 0, reles_publicados = 0;
+    uint8_t exibido = 0xFF;
+    absolute_time_t proximo_historico = get_absolute_time();
+    const uint32_t todos = FROTA_VASOS < 32 ? (1u << FROTA_VASOS) - 1 : UINT32_MAX;
+#if ENVIO_MQTT || ENVIO_UDP
+    uint32_t envios_pendentes = 0, feliz_enviado = 0, reles_enviados = 0;
+    absolute_time_t proximo_envio = get_absolute_time();
+#endif
+    ui_set_text(&rotulo_luz, "Vaso");
+    while (1) {
+        uint64_t inicio_volta_us = time_us_64();
+        uint32_t agora_ms = (uint32_t)(inicio_volta_us / 1000);
+
+        vigia_entrar(ETAPA_SENSORES);
+        bool luz = !ler_estado_ldr();  // LDR em HIGH = escuro
+        bool rodada = frota_ciclo(&frota, luz, agora_ms);
+        const frota_stats_t *s = &frota.stats;
+        if (rodada) {
+            printf("Frota: rodada %lu em %lu ms, %d de %d vasos felizes, ciclo %lu us (máx. %lu us)\n",
+                   (unsigned long)s->rodadas, (unsigned long)s->rodada_ms, __builtin_popcount(frota.feliz),
+                   FROTA_VASOS, (unsigned long)s->ciclo_us, (unsigned long)s->ciclo_max_us);
+        }
+
+        // **Servidor local**: refeito a cada rodada ou quando um vaso muda
+        vigia_entrar(ETAPA_ENVIO);
+        uint32_t reles = frota.reles;
+        if (rede_iniciada && (rodada || frota.feliz != feliz_publicado || reles != reles_publicados)) {
+            feliz_publicado = frota.feliz;
+            reles_publicados = reles;
+            cyw43_arch_lwip_begin();
+            http_servidor_publicar();
+            cyw43_arch_lwip_end();
+        }
+        if (rede_iniciada) lwip_uso_poll();
+#if ENVIO_MQTT || ENVIO_UDP
+        envios_pendentes |= (frota.feliz ^ feliz_enviado) | (reles ^ reles_enviados);
+        feliz_enviado = frota.feliz;
+        reles_enviados = reles;
+        if (time_reached(proximo_envio)) {
+            proximo_envio = delayed_by_ms(proximo_envio, FROTA_ENVIO_MS);
+            envios_pendentes = todos;
+        }
+        if (rede_iniciada && envios_pendentes) {
+            uint8_t i = (uint8_t)__builtin_ctz(envios_pendentes);
+            envios_pendentes &= ~(1u << i);
+            frota_enviar_vaso(i, luz);
+        }
+#endif
+#if ENVIO_MQTT
+        if (rede_iniciada) mq_poll();  // Conexão e reconexão com o broker MQTT
+#endif
+
+        // **Display** com o vaso escolhido
+        vigia_entrar(ETAPA_DISPLAY);
+        uint8_t vaso = frota_exibido;
+        frota_exibir(vaso, vaso != exibido);
+        exibido = vaso;
+        if (time_reached(proximo_historico)) {
+            proximo_historico = delayed_by_ms(proximo_historico, INTERVALO_HISTORICO_MS);
+            ui_push_sample(&grafico_temperatura, frota.temperatura_centi[vaso]);
+            ui_push_sample(&grafico_umidade, (int16_t)frota.umidade_mv[vaso]);
+        }
+        atualizar_icones(luz, frota.feliz >> vaso & 1);
+        ui_render(&oled, widgets_display, sizeof(widgets_display) / sizeof(widgets_display[0]));
+
+        // **Matriz de LEDs**: resumo da frota
+        bool bloqueado = false;
+        for (uint8_t i = 0; i < FROTA_VASOS; ++i) bloqueado |= frota.irrigacao[i].estado == IRRIGACAO_BLOQUEADA;
+        if (bloqueado) {
+            npAnimPlay(&np_anim_alerta);
+        } else if (reles) {
+            npAnimPlay(&np_anim_irrigando);
+        } else if (frota.feliz == todos) {
+            npAnimPlay(&np_anim_feliz);
+        } else {
+            npAnimPlay(&np_anim_triste);
+        }
 
-    cyw43_arch_enable_sta_mode();  // Configura o Wi-Fi no modo cliente
-    printf("Conectando ao Wi-Fi...\n");
+        if (!primeiro_quadro_ms) {
+            primeiro_quadro_ms = to_ms_since_boot(get_absolute_time());
+            printf("Primeiro quadro em %lu ms após o reset\n", (unsigned long)primeiro_quadro_ms);
+        }
 
-    // Tenta conectar à rede Wi-Fi
-    if (cyw43_arch_wifi_connect_blocking(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_MIXED_PSK)) {
-        printf("Falha ao conectar ao Wi-Fi\n");  // Exibe erro se a conexão falhar
-        return 1;  // Encerra o programa com erro
+        // **Wi-Fi**: inicia o chip, conecta e reconecta sem parar o laço
+        vigia_entrar(ETAPA_REDE);
+        wifi_poll();
+        if (!rede_iniciada && wifi_pilha_pronta()) {
+            rede_iniciada = true;
+            iniciar_rede();
+        }
+
+        vigia_entrar(ETAPA_ESPERA);
+        uint64_t ocupado_us = time_us_64() - inicio_volta_us;
+        laco_ocupado_us += ocupado_us;
+        ++laco_voltas;
+        if (ocupado_us < FROTA_PERIODO_MS * 1000) sleep_us(FROTA_PERIODO_MS * 1000 - ocupado_us);
     }
+}
+
+#endif
+
+//-----------------------------------------------------------------------------------------------------
+// Bloco 12: Função Principal
+//-----------------------------------------------------------------------------------------------------
+int main() {
 
-    printf("Wi-Fi conectado!\n");  // Exibe mensagem de sucesso
+    npInit(7);  // Inicializa a matriz de LEDs
+    npAnimInit();  // Inicia o temporizador que anima a matriz de LEDs
 
-    // **Configuração do temporizador para enviar dados ao ThingSpeak a cada 30 segundos**
-    struct repeating_timer timer;
-    add_repeating_timer_ms(30000, repeating_timer_callback, NULL, &timer);
+    configurar_hardware();  // Chama a função que configura todos os periféricos e sensores
 
-    // **Loop infinito para monitoramento da plantinha**
-    while (1) {
+    // **Monitor de prazos**: relata a etapa que parou antes deste boot e liga o watchdog
+    vigia_init(etapas_vigiadas, ETAPAS);
+    vigia_entrar(ETAPA_PARTIDA);
+
+    configurar_display();   // Monta os widgets do display OLED
 
-        // **Leitura do estado dos botões**
-        bool button_a_state = gpio_get(BUTTON_A);  // HIGH = solto, LOW = pressionado
-        bool button_b_state = gpio_get(BUTTON_B);  // HIGH = solto, LOW = pressionado
+    flashlog_init();  // Localiza o fim do histórico gravado na flash
+    relogio_log_base_s = flashlog_ultimo_instante() + 1;
+    carregar_regras();  // Perfil da planta deste vaso
 
-        // **Verifica se o Botão A foi pressionado**
-        if (!button_a_state) {  // Se o botão A for pressionado...
-            gpio_put(RELAY_GPIO, true);  // Ativa o relé (liga a irrigação)
-            printf("Relé ativado pelo Botão A\n");  // Exibe mensagem no console
-            irrigacao_rele = true;  // Atualiza variável de estado da irrigação
+    // Variáveis que armazenam os estados da plantinha e da irrigação
+    bool plantinha_feliz = false;  
+    bool irrigacao_rele = false;  
+    irrigacao_estado_t irrigacao_anterior = IRRIGACAO_OCIOSA;
+
+    // **Controle da irrigação** em ritmo fixo (atraso negativo: entre os inícios dos passos)
+#if MODO_FROTA
+    frota_init(&frota, &frota_config, &tabela_regras, &irrigacao_config, to_ms_since_boot(get_absolute_time()));
+    add_repeating_timer_ms(-IRRIGACAO_PERIODO_MS, frota_tick, NULL, &timer_irrigacao);
+#else
+    irrigacao_init(&irrigacao, &irrigacao_config, to_ms_since_boot(get_absolute_time()));
+    add_repeating_timer_ms(-IRRIGACAO_PERIODO_MS, irrigacao_tick, NULL, &timer_irrigacao);
+#endif
+
+    // Wi-Fi sem bloqueio: a conexão é feita por wifi_poll() no laço principal, depois
+    // do primeiro quadro, e os serviços de rede começam quando o chip estiver pronto
+    wifi_init(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_MIXED_PSK);
+    bool rede_iniciada = false;
+#if !ENVIO_MQTT && !MODO_FROTA
+    ts_init(THINGSPEAK_HOST, THINGSPEAK_PORT);  // Cliente HTTP persistente (conecta no primeiro envio)
+    amostras_init(THINGSPEAK_BULK_PATH, API_KEY);
+#endif
+    http_servidor_init(gerar_json, gerar_metricas);
+#if MODO_FROTA
+    laco_frota();  // Não retorna: o laço abaixo é o do vaso único
+#endif
+
+    // Instante da próxima amostra dos gráficos de histórico
+    absolute_time_t proximo_historico = get_absolute_time();
+
+    // **Política de envio**: as amostras saem por mudança, não mais por um temporizador fixo
+    politica_init(&politica, &politica_config, to_ms_since_boot(get_absolute_time()));
+
+    // **Leitura adaptativa**: cada sensor é lido na sua vez, mais espaçada com o sinal estável
+    aquisicao_init(&canal_temperatura, &config_temperatura, to_ms_since_boot(get_absolute_time()));
+    aquisicao_init(&canal_umidade, &config_umidade, to_ms_since_boot(get_absolute_time()));
+
+    // **Loop infinito para monitoramento da plantinha**
+    while (1) {
+        uint64_t inicio_volta_us = time_us_64();
+        uint32_t agora_ms = (uint32_t)(inicio_volta_us / 1000);
+
+        // **Estado da irrigação**: o relé e os botões são do temporizador (Bloco 10)
+        irrigacao_estado_t estado_irrigacao = irrigacao.estado;
+        irrigacao_rele = irrigacao_ligada(&irrigacao);
+        if (estado_irrigacao != irrigacao_anterior) {
+            printf("Irrigação: %s (umidade %.1f%%)\n", irrigacao_nome(estado_irrigacao), umidade_pdm / 10.0f);
+            irrigacao_anterior = estado_irrigacao;
         }
 
-        // **Verifica se o Botão B foi pressionado**
-        if (!button_b_state) {  // Se o botão B for pressionado...
-            gpio_put(RELAY_GPIO, false);  // Desativa o relé (desliga a irrigação)
-            printf("Relé desativado pelo Botão B\n");  // Exibe mensagem no console
-            irrigacao_rele = false;  // Atualiza variável de estado da irrigação
+        // **Ciclo de irrigação em andamento**: umidade e temperatura voltam a ser lidas
+        // a cada volta, até AQUISICAO_POS_IRRIGACAO_MS depois do relé desligar
+        if (irrigacao_rele || estado_irrigacao == IRRIGACAO_MOLHO) {
+            aquisicao_acelerar(&canal_umidade, agora_ms, AQUISICAO_POS_IRRIGACAO_MS);
+            aquisicao_acelerar(&canal_temperatura, agora_ms, AQUISICAO_POS_IRRIGACAO_MS);
         }
 
-        // **Atualiza os dados dos sensores**
-        float tensao_umidade = ler_tensao_umidade();  // Lê a tensão do sensor de umidade
-        float temperatura_solo = ler_temperatura_solo();  // Lê a temperatura do solo
-        bool ldr_ativo = ler_estado_ldr();  // Lê o estado do sensor de luz
+        // **Atualiza os dados dos sensores** que estão na vez (os outros mantêm a leitura anterior)
+        vigia_entrar(ETAPA_SENSORES);
+        float tensao_umidade = leituras.tensao_umidade;
+        float temperatura_solo = leituras.temperatura_solo;
+        bool nova_leitura = ler_canal(&canal_umidade, ler_tensao_umidade, &tensao_umidade, agora_ms);
+        if (nova_leitura) {  // Para o controle da irrigação
+            umidade_pdm = calibrar_umidade(tensao_umidade);
+            umidade_lida_ms = agora_ms;
+            umidade_lida = true;
+        }
+        nova_leitura |= ler_canal(&canal_temperatura, ler_temperatura_solo, &temperatura_solo, agora_ms);
+        bool ldr_ativo = ler_estado_ldr();  // Lê o estado do sensor de luz (só um GPIO, a cada volta)
 
         // **Verifica o nível de umidade do solo**
         bool umidade_solo = getBoolUmidadeSolo(tensao_umidade);
 
         // **Decide se a plantinha está feliz ou não**
-        plantinha_feliz = decidir_estado_plantinha(umidade_solo, temperatura_solo, ldr_ativo);
-
-        // **Exibe os dados no monitor serial**
-        printf("Tensão do sensor de umidade: %.2fV\n", tensao_umidade);
-        printf("Umidade do solo: %s\n", umidade_solo ? "Úmido" : "Seco");
-        printf("Temperatura do solo: %.2f°C\n", temperatura_solo);
-        printf("Luz na plantinha?: %s\n", ldr_ativo ? "Não" : "Sim");
-        printf("Irrigação: %s\n", irrigacao_rele ? "Ativada" : "Desativada");
-        printf("Plantinha feliz: %s\n", plantinha_feliz ? "Sim" : "Não");
-
-        // **Atualiza o display OLED**
-        ssd1306_clear(&oled);  // Limpa a tela do display antes de atualizar os dados
-
-        // **Exibe a umidade do solo no display**
-        char buffer[32];  // Buffer para armazenar strings formatadas
-        snprintf(buffer, sizeof(buffer), "Umidade solo: %s\n", umidade_solo ? "Umido" : "Seco");
-        ssd1306_draw_string(&oled, 0, 0, 1, buffer);
-
-        // **Exibe a temperatura do solo no display**
-        snprintf(buffer, sizeof(buffer), "Temp. Solo: %.2f C", temperatura_solo);
-        ssd1306_draw_string(&oled, 0, 16, 1, buffer);
-
-        // **Exibe o estado da luz no display**
-        snprintf(buffer, sizeof(buffer), "Luz: %s", ldr_ativo ? "Ausente" : "Detectada");
-        ssd1306_draw_string(&oled, 0, 32, 1, buffer);
-
-        // **Exibe o estado da irrigação no display**
-        snprintf(buffer, sizeof(buffer), "Irrigacao: %s", irrigacao_rele ? "Ativada" : "Desativada");
-        ssd1306_draw_string(&oled, 0, 48, 1, buffer);
-
-        // **Atualiza o display OLED**
-        ssd1306_show(&oled);
-
-        // **Mostra a carinha feliz ou triste na matriz de LEDs**
-        if (plantinha_feliz) {
-            npCarinhaFeliz();  // Mostra carinha feliz na matriz de LEDs
+        plantinha_feliz = decidir_estado_plantinha(umidade_pdm, temperatura_solo, ldr_ativo, agora_ms);
+
+        // **Guarda a leitura para os envios ao ThingSpeak**
+        leituras = (leituras_t){temperatura_solo, tensao_umidade, umidade_solo, ldr_ativo,
+                                irrigacao_rele, plantinha_feliz};
+
+        // **Amostra pedida pela política de envio** (mudança, pulsação ou evento)
+        vigia_entrar(ETAPA_ENVIO);
+        politica_motivo_t motivo = avaliar_envio(&leituras);
+        bool nova_amostra = motivo != POLITICA_NADA;
+        if (nova_amostra) registrar_amostra(&leituras, motivo == POLITICA_EVENTO);
+        if (rede_iniciada) {
+            publicar_leituras(nova_amostra);  // Respostas do servidor local, se algo mudou
+            lwip_uso_poll();                  // Novos picos de uso dos pools no monitor serial
+#if ENVIO_MQTT
+            mq_poll();        // Conexão e reconexão com o broker MQTT
+#else
+            amostras_poll();  // Envia um lote ao ThingSpeak quando for hora
+            if (wifi_conectado()) ts_poll();  // Conexão, reconexão e tempos limite do cliente HTTP
+#endif
+#if ENVIO_UDP
+            if (wifi_conectado()) telemetria_poll();  // Envia o lote de telemetria quando for hora
+#endif
+        }
+
+        // **Exibe os dados no monitor serial** (só quando algum sensor foi lido)
+        if (nova_leitura) {
+            printf("Tensão do sensor de umidade: %.2fV\n", tensao_umidade);
+            printf("Umidade do solo: %s\n", umidade_solo ? "Úmido" : "Seco");
+            printf("Temperatura do solo: %.2f°C\n", temperatura_solo);
+            printf("Luz na plantinha?: %s\n", ldr_ativo ? "Não" : "Sim");
+            printf("Irrigação: %s\n", irrigacao_nome(estado_irrigacao));
+            printf("Plantinha feliz: %s\n", plantinha_feliz ? "Sim" : "Não");
+        }
+
+        // **Atualiza os widgets do display OLED**
+        vigia_entrar(ETAPA_DISPLAY);
+        // Apenas os valores que mudaram são redesenhados e enviados pelo I2C
+        ui_set_text(&valor_umidade, umidade_solo ? "Umido" : "Seco");
+        ui_set_value(&valor_temperatura, lroundf(temperatura_solo * 100.0f));
+        ui_set_text(&valor_luz, ldr_ativo ? "Ausente" : "Detectada");
+        ui_set_text(&valor_irrigacao, textos_irrigacao[estado_irrigacao]);
+
+        // **Acrescenta uma coluna aos gráficos de histórico no intervalo definido**
+        if (time_reached(proximo_historico)) {
+            proximo_historico = delayed_by_ms(proximo_historico, INTERVALO_HISTORICO_MS);
+            ui_push_sample(&grafico_temperatura, (int16_t)lroundf(temperatura_solo * 100.0f));
+            ui_push_sample(&grafico_umidade, (int16_t)(tensao_umidade * 1000.0f));
+        }
+        atualizar_icones(!ldr_ativo, plantinha_feliz);
+
+        ui_render(&oled, widgets_display, sizeof(widgets_display) / sizeof(widgets_display[0]));
+
+        // **Escolhe a animação da matriz de LEDs** (o temporizador só envia quadros que mudaram)
+        if (estado_irrigacao == IRRIGACAO_BLOQUEADA) {
+            npAnimPlay(&np_anim_alerta);     // Exclamação: a trava de tempo ligado desarmou a irrigação
+        } else if (irrigacao_rele) {
+            npAnimPlay(&np_anim_irrigando);  // Gota piscando enquanto a irrigação está ligada
+        } else if (plantinha_feliz) {
+            npAnimPlay(&np_anim_feliz);      // Carinha feliz em verde
         } else {
-            npCarinhaTriste(); // Mostra carinha triste na matriz de LEDs
+            npAnimPlay(&np_anim_triste);     // Carinha triste em vermelho, pulsando
+        }
+
+        // **Primeiro quadro completo** (sensores, relé, display e matriz) antes de qualquer rede
+        if (!primeiro_quadro_ms) {
+            primeiro_quadro_ms = to_ms_since_boot(get_absolute_time());
+            printf("Primeiro quadro em %lu ms após o reset\n", (unsigned long)primeiro_quadro_ms);
         }
 
+        // **Wi-Fi**: inicia o chip, conecta e reconecta sem parar o laço
+        vigia_entrar(ETAPA_REDE);
+        wifi_poll();
+        if (!rede_iniciada && wifi_pilha_pronta()) {
+            rede_iniciada = true;
+            iniciar_rede();
+        }
+
+        vigia_entrar(ETAPA_ESPERA);
+        laco_ocupado_us += time_us_64() - inicio_volta_us;
+        ++laco_voltas;
+
         // **Aguarda 500 milissegundos antes da próxima leitura**
         sleep_ms(500);
     }
@@ -0,0 +1,187 @@
+// amostras.c
+// Implementação da fila de amostras e dos lotes do ThingSpeak (ver amostras.h).
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/cyw43_arch.h"
+#include "thingspeak.h"
+#include "relogio.h"
+#include "amostras.h"
+
+// Entrada do lote com os campos em largura fixa (espaços antes do valor são JSON válido).
+// É copiada para o corpo e os valores são escritos por cima, sem printf. Com o relógio
+// sincronizado, cada entrada leva a hora da coleta (created_at); sem ele, o intervalo
+// desde a entrada anterior (delta_t), e o ThingSpeak completa com a hora da chegada.
+#define AMOSTRAS_MODELO_RELATIVO \
+    ",{\"delta_t\":          ,\"field1\":       ,\"field2\": ,\"field3\": ,\"field4\": ,\"field5\": }"
+#define AMOSTRAS_MODELO_ABSOLUTO \
+    ",{\"created_at\":\"                    \",\"field1\":       ,\"field2\": ,\"field3\": ,\"field4\": ,\"field5\": }"
+#define AMOSTRAS_ENTRADA_MAX (sizeof(AMOSTRAS_MODELO_ABSOLUTO) - 1)
+#define AMOSTRAS_CAMPOS 6         // delta_t ou created_at, temperatura e os quatro estados
+#define AMOSTRAS_PREFIXO_MAX 96   // {"write_api_key":"...","updates":[
+
+typedef struct {
+    const char *texto;
+    uint8_t tamanho;
+    uint8_t campo[AMOSTRAS_CAMPOS];   // Posição e largura de cada valor no modelo
+    uint8_t largura[AMOSTRAS_CAMPOS];
+} amostras_modelo_t;
+
+static amostras_modelo_t modelo_relativo = {.texto = AMOSTRAS_MODELO_RELATIVO};
+static amostras_modelo_t modelo_absoluto = {.texto = AMOSTRAS_MODELO_ABSOLUTO};
+
+static struct {
+    const char *caminho;
+    amostra_t fila[AMOSTRAS_CAPACIDADE];
+    uint16_t inicio, quantidade;
+    uint16_t em_envio;            // Amostras do início da fila que estão no lote em envio
+    uint32_t ultimo_instante_s;   // Instante da última amostra confirmada (base do delta_t)
+    bool houve_envio;
+    uint32_t ultimo_lote_ms;
+    bool urgente;                     // Próximo lote sai sem esperar encher
+    uint16_t prefixo;                 // Tamanho do início do JSON, montado uma vez
+    char corpo[AMOSTRAS_PREFIXO_MAX + AMOSTRAS_LOTE_MAX * AMOSTRAS_ENTRADA_MAX + 2];
+    amostras_stats_t stats;
+} am;
+
+static inline const amostra_t *amostra(uint i) {
+    return &am.fila[(am.inicio + i) % AMOSTRAS_CAPACIDADE];
+}
+
+static void amostras_descartar(uint n) {
+    am.inicio = (am.inicio + n) % AMOSTRAS_CAPACIDADE;
+    am.quantidade -= n;
+}
+
+// Resposta do lote (contexto do lwIP): só então as amostras saem da fila
+static void amostras_resposta(void *arg, uint16_t status) {
+    uint n = am.em_envio;
+    am.em_envio = 0;
+    if (status >= 200 && status < 300) {
+        am.ultimo_instante_s = amostra(n - 1)->instante_s;
+        am.houve_envio = true;
+        amostras_descartar(n);
+        am.stats.enviadas += n;
+        ++am.stats.lotes;
+    } else if (status >= 400 && status < 500 && status != 429) {
+        // Lote recusado (chave ou canal errados, JSON inválido): reenviar não adianta
+        printf("ThingSpeak recusou o lote (HTTP %u), %u amostras descartadas\n", status, n);
+        amostras_descartar(n);
+        am.stats.perdidas += n;
+        ++am.stats.lotes_rejeitados;
+    }
+    // 429, 5xx: as amostras ficam na fila para o próximo lote
+}
+
+// Monta o JSON do lote com as `n` primeiras amostras. O created_at de cada entrada
+// é a hora UTC da coleta, convertida agora do instante desde o boot; o delta_t é o
+// intervalo em segundos desde a entrada anterior do canal. O início do JSON já está
+// no corpo; cada entrada é o modelo com os valores escritos por cima.
+static uint16_t amostras_montar(uint n) {
+    const amostras_modelo_t *m = relogio_sincronizado() ? &modelo_absoluto : &modelo_relativo;
+    char *p = am.corpo + am.prefixo;
+    uint32_t anterior = am.houve_envio ? am.ultimo_instante_s : amostra(0)->instante_s;
+    for (uint i = 0; i < n; ++i, p += m->tamanho) {
+        const amostra_t *a = amostra(i);
+        int32_t valores[AMOSTRAS_CAMPOS] = {
+            (int32_t)(a->instante_s - anterior), a->temperatura_centi,
+            !!(a->estados & AMOSTRA_UMIDO), !!(a->estados & AMOSTRA_LUZ),
+            !!(a->estados & AMOSTRA_IRRIGANDO), !!(a->estados & AMOSTRA_FELIZ),
+        };
+        memcpy(p, m->texto, m->tamanho);
+        if (i == 0) p[0] = ' ';
+        if (m == &modelo_absoluto) {
+            relogio_iso8601(p + m->campo[0], relogio_unix_s((uint64_t)a->instante_s * 1000000));
+        } else {
+            ts_campo_inteiro(p + m->campo[0], m->largura[0], valores[0], 0);
+        }
+        for (uint c = 1; c < AMOSTRAS_CAMPOS; ++c) {
+            ts_campo_inteiro(p + m->campo[c], m->largura[c], valores[c], c == 1 ? 2 : 0);
+        }
+        anterior = a->instante_s;
+    }
+    memcpy(p, "]}", 2);
+    return (uint16_t)(p + 2 - am.corpo);
+}
+
+// Posição e largura de cada valor: os espaços depois de ':' (ou de ':"' num texto)
+static void amostras_modelo_medir(amostras_modelo_t *m) {
+    m->tamanho = (uint8_t)strlen(m->texto);
+    uint c = 0;
+    for (uint i = 0; i < m->tamanho && c < AMOSTRAS_CAMPOS; ++i) {
+        if (m->texto[i] != ':') continue;
+        if (m->texto[i + 1] == '"') ++i;
+        m->campo[c] = (uint8_t)(i + 1);
+        while (m->texto[i + 1] == ' ') ++i;
+        m->largura[c] = (uint8_t)(i + 1 - m->campo[c]);
+        ++c;
+    }
+}
+
+void amostras_init(const char *caminho, const char *api_key) {
+    memset(&am, 0, sizeof(am));
+    am.caminho = caminho;
+
+    // Partes fixas, montadas uma única vez: o início do JSON e a posição de cada valor no modelo
+    int n = snprintf(am.corpo, AMOSTRAS_PREFIXO_MAX, "{\"write_api_key\":\"%s\",\"updates\":[", api_key);
+    am.prefixo = n > 0 && n < AMOSTRAS_PREFIXO_MAX ? (uint16_t)n : 0;
+    amostras_modelo_medir(&modelo_relativo);
+    amostras_modelo_medir(&modelo_absoluto);
+}
+
+void amostras_adicionar(const amostra_t *nova) {
+    cyw43_arch_lwip_begin();
+    ++am.stats.adicionadas;
+    if (am.quantidade == AMOSTRAS_CAPACIDADE) {
+        ++am.stats.perdidas;
+        if (am.em_envio == am.quantidade) {
+            cyw43_arch_lwip_end();  // Fila inteira no lote em envio: descarta a nova
+            return;
+        }
+        // Descarta a mais antiga que não está no lote em envio
+        if (am.em_envio == 0) {
+            amostras_descartar(1);
+        } else {
+            for (uint i = am.em_envio; i + 1 < am.quantidade; ++i) {
+                am.fila[(am.inicio + i) % AMOSTRAS_CAPACIDADE] = *amostra(i + 1);
+            }
+            --am.quantidade;
+        }
+    }
+    am.fila[(am.inicio + am.quantidade) % AMOSTRAS_CAPACIDADE] = *nova;
+    ++am.quantidade;
+    cyw43_arch_lwip_end();
+}
+
+void amostras_poll(void) {
+    cyw43_arch_lwip_begin();
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    bool enviar = false;
+    if (am.quantidade && !am.em_envio && (!am.ultimo_lote_ms || agora - am.ultimo_lote_ms >= AMOSTRAS_INTERVALO_MIN_MS)) {
+        uint32_t espera_ms = (agora / 1000 - amostra(0)->instante_s) * 1000;
+        enviar = am.quantidade >= AMOSTRAS_LOTE_MIN || espera_ms >= AMOSTRAS_ESPERA_MAX_MS || am.urgente;
+    }
+    if (enviar) {
+        uint n = am.quantidade < AMOSTRAS_LOTE_MAX ? am.quantidade : AMOSTRAS_LOTE_MAX;
+        uint16_t tamanho = amostras_montar(n);
+        if (ts_post(am.caminho, "application/json", am.corpo, tamanho, amostras_resposta, NULL)) {
+            am.em_envio = n;
+            am.ultimo_lote_ms = agora;
+            am.urgente = false;
+            printf("Lote de %u amostras enfileirado (%u bytes, %u na fila)\n", n, tamanho, am.quantidade);
+        }
+    }
+    cyw43_arch_lwip_end();
+}
+
+void amostras_enviar_agora(void) {
+    am.urgente = true;
+}
+
+uint amostras_quantidade(void) {
+    return am.quantidade;
+}
+
+const amostras_stats_t *amostras_stats(void) {
+    return &am.stats;
+}
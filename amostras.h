@@ -0,0 +1,56 @@
+// amostras.h
+// Fila de amostras com registro de tempo, enviadas em lotes ao ThingSpeak.
+//
+// Cada leitura periódica entra numa fila circular de tamanho fixo, com ou sem
+// Wi-Fi. O envio usa o endpoint de atualização em lote (bulk_update.json) do
+// ThingSpeak: muitas amostras por requisição em vez de uma requisição por
+// amostra. As amostras só saem da fila quando o servidor confirma o lote, e
+// o atraso acumulado sem conexão é enviado em lotes seguidos ao reconectar.
+#ifndef AMOSTRAS_H
+#define AMOSTRAS_H
+
+#include "pico/stdlib.h"
+
+#define AMOSTRAS_CAPACIDADE 720                 // 6 horas de amostras a cada 30 s
+#define AMOSTRAS_LOTE_MIN 20                    // Envia quando houver esta quantidade na fila...
+#define AMOSTRAS_ESPERA_MAX_MS (10 * 60 * 1000) // ...ou quando a mais antiga esperou este tempo
+#define AMOSTRAS_LOTE_MAX 40                    // Entradas por requisição (corpo de até ~4 KB, sem cópia)
+#define AMOSTRAS_INTERVALO_MIN_MS 15000         // Intervalo mínimo entre lotes (limite do ThingSpeak)
+
+// Estados discretos de uma amostra (campo `estados`)
+#define AMOSTRA_UMIDO     (1u << 0)
+#define AMOSTRA_LUZ       (1u << 1)
+#define AMOSTRA_IRRIGANDO (1u << 2)
+#define AMOSTRA_FELIZ     (1u << 3)
+
+typedef struct {
+    uint32_t instante_s;        // Segundos desde o boot (hora real no envio, ver relogio.h)
+    int16_t temperatura_centi;  // Temperatura do solo em centésimos de grau
+    uint8_t estados;            // AMOSTRA_*
+} amostra_t;
+
+typedef struct {
+    uint32_t adicionadas;
+    uint32_t enviadas;          // Amostras confirmadas pelo servidor
+    uint32_t perdidas;          // Descartadas com a fila cheia ou em lotes rejeitados
+    uint32_t lotes;             // Requisições confirmadas
+    uint32_t lotes_rejeitados;  // Respostas 4xx (o lote não é reenviado)
+} amostras_stats_t;
+
+// `caminho` é o endpoint do canal ("/channels/<id>/bulk_update.json")
+void amostras_init(const char *caminho, const char *api_key);
+
+// Acrescenta uma amostra; com a fila cheia, a mais antiga fora do lote em envio é descartada
+void amostras_adicionar(const amostra_t *amostra);
+
+// Monta e enfileira um lote no cliente HTTP quando for hora. Chamar no laço principal.
+void amostras_poll(void);
+
+// Envia o próximo lote sem esperar AMOSTRAS_LOTE_MIN (evento que deve aparecer logo),
+// ainda respeitando AMOSTRAS_INTERVALO_MIN_MS
+void amostras_enviar_agora(void);
+
+uint amostras_quantidade(void);
+const amostras_stats_t *amostras_stats(void);
+
+#endif
@@ -0,0 +1,60 @@
+// aquisicao.c
+// Implementação do intervalo de leitura adaptativo (ver aquisicao.h).
+#include <math.h>
+#include <string.h>
+
+#include "aquisicao.h"
+
+void aquisicao_init(aquisicao_canal_t *c, const aquisicao_config_t *config, uint32_t agora_ms) {
+    memset(c, 0, sizeof(*c));
+    c->config = config;
+    c->intervalo_ms = config->intervalo_min_ms;
+    c->proxima_ms = agora_ms;
+}
+
+bool aquisicao_devida(const aquisicao_canal_t *c, uint32_t agora_ms) {
+    return (int32_t)(agora_ms - c->proxima_ms) >= 0;
+}
+
+// Volta para o intervalo curto, contando a mudança de ritmo
+static void aquisicao_rapido(aquisicao_canal_t *c) {
+    if (c->intervalo_ms > c->config->intervalo_min_ms) ++c->stats.aceleracoes;
+    c->intervalo_ms = c->config->intervalo_min_ms;
+}
+
+void aquisicao_registrar(aquisicao_canal_t *c, float valor, uint32_t agora_ms, uint32_t duracao_us) {
+    const aquisicao_config_t *cfg = c->config;
+    ++c->stats.leituras;
+    c->stats.ocupado_us += duracao_us;
+
+    bool ativo = (int32_t)(c->rapido_ate_ms - agora_ms) > 0;
+    if (!ativo && c->houve_leitura) {
+        float variacao = fabsf(valor - c->ultimo_valor);
+        uint32_t passado_ms = agora_ms - c->ultima_ms;
+        ativo = variacao > cfg->ruido && passado_ms && variacao * 60000.0f / passado_ms >= cfg->taxa_min;
+    }
+    if (ativo) {
+        aquisicao_rapido(c);
+    } else if (c->houve_leitura) {
+        c->intervalo_ms = c->intervalo_ms * 2 < cfg->intervalo_max_ms ? c->intervalo_ms * 2 : cfg->intervalo_max_ms;
+    }
+    c->ultimo_valor = valor;
+    c->ultima_ms = agora_ms;
+    c->houve_leitura = true;
+    c->proxima_ms = agora_ms + c->intervalo_ms;
+}
+
+void aquisicao_acelerar(aquisicao_canal_t *c, uint32_t agora_ms, uint32_t duracao_ms) {
+    c->rapido_ate_ms = agora_ms + duracao_ms;
+    aquisicao_rapido(c);
+    uint32_t limite = agora_ms + c->intervalo_ms;
+    if ((int32_t)(c->proxima_ms - limite) > 0) c->proxima_ms = agora_ms;
+}
+
+float aquisicao_ocupacao(const aquisicao_canal_t *c, uint32_t decorrido_ms) {
+    return decorrido_ms ? (float)(c->stats.ocupado_us / 1000.0 / decorrido_ms) : 0.0f;
+}
+
+float aquisicao_corrente_media_ua(const aquisicao_canal_t *c, uint32_t decorrido_ms) {
+    return aquisicao_ocupacao(c, decorrido_ms) * c->config->corrente_ua;
+}
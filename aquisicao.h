@@ -0,0 +1,68 @@
+// aquisicao.h
+// Intervalo de leitura adaptativo de cada canal de sensor: em vez de ler o
+// DS18B20 e o ADC a cada volta do laço, cada canal é lido quando chega a sua
+// vez, e a vez se afasta enquanto a leitura está estável.
+//
+// Depois de uma leitura sem atividade, o intervalo dobra, até `intervalo_max_ms`.
+// Há atividade quando a variação desde a leitura anterior passa do ruído do
+// sensor e a taxa de variação passa de `taxa_min` por minuto: o intervalo volta
+// na hora para `intervalo_min_ms`. aquisicao_acelerar() faz o mesmo por um
+// tempo, para atividade vista de fora do sinal (o relé de irrigação ligado).
+//
+// Cada canal conta as leituras e o tempo gasto nelas; com a corrente do
+// periférico durante a leitura, isso dá a ocupação do barramento e uma
+// estimativa da corrente média.
+//
+// Sem dependências do SDK: o mesmo código roda na simulação de tools/aquisicao_sim.c.
+#ifndef AQUISICAO_H
+#define AQUISICAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    const char *nome;           // Rótulo nas métricas
+    uint32_t intervalo_min_ms;  // Intervalo com atividade (maior que 0)
+    uint32_t intervalo_max_ms;  // Intervalo com o sinal estável
+    float ruido;                // Variação que ainda é ruído do sensor
+    float taxa_min;             // Variação por minuto que conta como atividade
+    uint32_t corrente_ua;       // Corrente do periférico durante a leitura
+} aquisicao_config_t;
+
+typedef struct {
+    uint32_t leituras;
+    uint32_t aceleracoes;       // Voltas do intervalo longo para o curto
+    uint64_t ocupado_us;        // Tempo total gasto nas leituras
+} aquisicao_stats_t;
+
+typedef struct {
+    const aquisicao_config_t *config;
+    uint32_t intervalo_ms;      // Intervalo atual
+    uint32_t proxima_ms;        // Instante da próxima leitura
+    uint32_t ultima_ms;
+    uint32_t rapido_ate_ms;     // Fim do período de aquisicao_acelerar()
+    float ultimo_valor;
+    bool houve_leitura;
+    aquisicao_stats_t stats;
+} aquisicao_canal_t;
+
+// O canal começa no intervalo curto, com a primeira leitura devida em `agora_ms`
+void aquisicao_init(aquisicao_canal_t *c, const aquisicao_config_t *config, uint32_t agora_ms);
+
+// Se o canal deve ser lido nesta volta
+bool aquisicao_devida(const aquisicao_canal_t *c, uint32_t agora_ms);
+
+// Registra uma leitura, que levou `duracao_us`, e agenda a próxima
+void aquisicao_registrar(aquisicao_canal_t *c, float valor, uint32_t agora_ms, uint32_t duracao_us);
+
+// Mantém o intervalo curto até `agora_ms + duracao_ms`; se a próxima leitura
+// estava mais longe que o intervalo curto, ela fica devida agora
+void aquisicao_acelerar(aquisicao_canal_t *c, uint32_t agora_ms, uint32_t duracao_ms);
+
+// Fração do tempo desde o início (`decorrido_ms`) gasta nas leituras do canal
+float aquisicao_ocupacao(const aquisicao_canal_t *c, uint32_t decorrido_ms);
+
+// Corrente média estimada do periférico no mesmo período, em µA
+float aquisicao_corrente_media_ua(const aquisicao_canal_t *c, uint32_t decorrido_ms);
+
+#endif
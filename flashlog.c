@@ -0,0 +1,203 @@
+// flashlog.c
+// Histórico circular na flash com página de escrita em RAM (ver flashlog.h).
+#include <string.h>
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "flashlog.h"
+
+static struct {
+    uint16_t ordem[FLASHLOG_SETORES];  // Setores válidos, do mais antigo ao mais novo
+    uint16_t setores;                  // Quantidade de setores em `ordem`
+    uint32_t sequencia;                // Sequência do setor atual
+    uint16_t posicao;                  // Próximo byte livre no setor atual
+    flashlog_estado_t estado;          // Estado do codificador no fim do setor atual
+    uint8_t pagina[FLASHLOG_PAGINA];   // Página atual: bytes já gravados e os novos
+    uint16_t pagina_inicio;            // Offset da página dentro do setor
+    bool pagina_suja;                  // Há bytes na página que ainda não estão na flash
+    uint32_t pagina_desde_s;           // Instante do primeiro desses bytes
+    uint8_t copia[FLASHLOG_SETOR];     // Setor atual com a página em RAM (para consultas)
+    flashlog_stats_t stats;
+} fl;
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *dados;
+} flashlog_operacao_t;
+
+static inline const uint8_t *flashlog_setor(uint16_t fisico) {
+    return (const uint8_t *)(uintptr_t)(XIP_BASE + FLASHLOG_OFFSET + (uint32_t)fisico * FLASHLOG_SETOR);
+}
+
+static inline uint16_t flashlog_atual(void) {
+    return fl.ordem[fl.setores - 1];
+}
+
+// Executadas por flash_safe_execute, com o XIP desligado e o outro núcleo parado
+static void flashlog_programar(void *parametro) {
+    flashlog_operacao_t *op = parametro;
+    flash_range_program(op->offset, op->dados, FLASHLOG_PAGINA);
+}
+
+static void flashlog_apagar(void *parametro) {
+    flashlog_operacao_t *op = parametro;
+    flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+}
+
+// Grava a página em RAM. Uma página parcial pode ser gravada de novo depois com mais
+// bytes: os já gravados se repetem e os novos só levam bits de 1 para 0.
+static void flashlog_gravar_pagina(void) {
+    flashlog_operacao_t op = {
+        FLASHLOG_OFFSET + (uint32_t)flashlog_atual() * FLASHLOG_SETOR + fl.pagina_inicio, fl.pagina};
+    flash_safe_execute(flashlog_programar, &op, UINT32_MAX);
+    fl.pagina_suja = false;
+    ++fl.stats.paginas_gravadas;
+}
+
+// Começa o próximo setor do círculo, apagando-o (e descartando o mais antigo se for ele)
+static void flashlog_novo_setor(uint32_t instante_s) {
+    if (fl.pagina_suja) flashlog_gravar_pagina();
+
+    uint16_t fisico = fl.setores ? (flashlog_atual() + 1) % FLASHLOG_SETORES : 0;
+    for (uint i = 0; i < fl.setores; ++i) {
+        if (fl.ordem[i] != fisico) continue;
+        memmove(&fl.ordem[i], &fl.ordem[i + 1], (fl.setores - i - 1) * sizeof(fl.ordem[0]));
+        --fl.setores;
+        break;
+    }
+    flashlog_operacao_t op = {FLASHLOG_OFFSET + (uint32_t)fisico * FLASHLOG_SETOR, NULL};
+    flash_safe_execute(flashlog_apagar, &op, UINT32_MAX);
+    ++fl.stats.setores_apagados;
+
+    ++fl.sequencia;
+    fl.ordem[fl.setores++] = fisico;
+
+    flashlog_cabecalho_t cabecalho;
+    flashlog_cabecalho_montar(&cabecalho, fl.sequencia, instante_s);
+    flashlog_estado_inicio(&fl.estado, &cabecalho);
+    memset(fl.pagina, 0xFF, sizeof(fl.pagina));
+    memcpy(fl.pagina, &cabecalho, sizeof(cabecalho));
+    fl.pagina_inicio = 0;
+    fl.posicao = sizeof(cabecalho);
+    fl.pagina_suja = true;
+    fl.pagina_desde_s = instante_s;
+}
+
+void flashlog_init(void) {
+    memset(&fl, 0, sizeof(fl));
+    fl.setores = (uint16_t)flashlog_ordenar(flashlog_setor(0), FLASHLOG_SETORES, fl.ordem);
+    if (!fl.setores) return;
+
+    const uint8_t *setor = flashlog_setor(flashlog_atual());
+    flashlog_cabecalho_t cabecalho;
+    memcpy(&cabecalho, setor, sizeof(cabecalho));
+    fl.sequencia = cabecalho.sequencia;
+    fl.posicao = (uint16_t)flashlog_fim_setor(setor, &fl.estado);
+
+    // A página onde o log parou volta para a RAM e continua a ser preenchida
+    uint16_t ultimo = fl.posicao < FLASHLOG_SETOR ? fl.posicao : FLASHLOG_SETOR - 1;
+    fl.pagina_inicio = ultimo & ~(FLASHLOG_PAGINA - 1);
+    memcpy(fl.pagina, setor + fl.pagina_inicio, FLASHLOG_PAGINA);
+}
+
+uint32_t flashlog_ultimo_instante(void) {
+    return fl.setores ? fl.estado.instante_s : 0;
+}
+
+void flashlog_adicionar(const flashlog_registro_t *registro) {
+    uint8_t bytes[FLASHLOG_REGISTRO_MAX];
+    flashlog_estado_t estado = fl.estado;
+    size_t n = flashlog_codificar(registro, &estado, bytes);
+
+    if (!fl.setores || fl.posicao + n > FLASHLOG_SETOR) {
+        flashlog_novo_setor(registro->instante_s);
+        estado = fl.estado;
+        n = flashlog_codificar(registro, &estado, bytes);
+    }
+    fl.estado = estado;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!fl.pagina_suja) {
+            fl.pagina_suja = true;
+            fl.pagina_desde_s = registro->instante_s;
+        }
+        fl.pagina[fl.posicao++ - fl.pagina_inicio] = bytes[i];
+        if (fl.posicao - fl.pagina_inicio == FLASHLOG_PAGINA) {
+            flashlog_gravar_pagina();
+            fl.pagina_inicio += FLASHLOG_PAGINA;
+            memset(fl.pagina, 0xFF, sizeof(fl.pagina));
+        }
+    }
+    ++fl.stats.registros;
+    fl.stats.bytes += n;
+
+    if (fl.pagina_suja && registro->instante_s - fl.pagina_desde_s >= FLASHLOG_SYNC_S) {
+        flashlog_gravar_pagina();
+    }
+}
+
+void flashlog_sync(void) {
+    if (fl.pagina_suja) flashlog_gravar_pagina();
+}
+
+static uint32_t flashlog_base(uint16_t posicao_setor) {
+    flashlog_cabecalho_t cabecalho;
+    bool so_na_ram = posicao_setor == fl.setores - 1 && fl.pagina_inicio == 0;  // Setor novo ainda não gravado
+    memcpy(&cabecalho, so_na_ram ? fl.pagina : flashlog_setor(fl.ordem[posicao_setor]), sizeof(cabecalho));
+    return cabecalho.instante_s;
+}
+
+void flashlog_consultar(flashlog_consulta_t *consulta, uint32_t de_s, uint32_t ate_s) {
+    consulta->de_s = de_s;
+    consulta->ate_s = ate_s;
+    consulta->setor = NULL;
+    consulta->fim = fl.setores == 0;
+
+    // Último setor que começa antes de `de_s` (os instantes crescem com a sequência)
+    uint16_t baixo = 0, alto = fl.setores;
+    while (alto - baixo > 1) {
+        uint16_t meio = (baixo + alto) / 2;
+        if (flashlog_base(meio) <= de_s) baixo = meio;
+        else alto = meio;
+    }
+    consulta->posicao_setor = baixo;
+}
+
+bool flashlog_proximo(flashlog_consulta_t *consulta, flashlog_registro_t *registro) {
+    while (!consulta->fim) {
+        if (!consulta->setor) {
+            const uint8_t *setor = flashlog_setor(fl.ordem[consulta->posicao_setor]);
+            if (consulta->posicao_setor == fl.setores - 1) {
+                // Setor atual: a parte final ainda pode estar só na RAM
+                memcpy(fl.copia, setor, fl.pagina_inicio);
+                memset(fl.copia + fl.pagina_inicio, 0xFF, FLASHLOG_SETOR - fl.pagina_inicio);
+                if (fl.pagina_inicio < FLASHLOG_SETOR) memcpy(fl.copia + fl.pagina_inicio, fl.pagina, FLASHLOG_PAGINA);
+                setor = fl.copia;
+            }
+            flashlog_cabecalho_t cabecalho;
+            memcpy(&cabecalho, setor, sizeof(cabecalho));
+            flashlog_estado_inicio(&consulta->estado, &cabecalho);
+            consulta->setor = setor;
+            consulta->offset = sizeof(cabecalho);
+        }
+
+        size_t n = flashlog_decodificar(consulta->setor + consulta->offset, consulta->setor + FLASHLOG_SETOR,
+                                        &consulta->estado, registro);
+        if (n == 0) {
+            consulta->setor = NULL;
+            consulta->fim = ++consulta->posicao_setor >= fl.setores;
+            continue;
+        }
+        consulta->offset += n;
+        if (registro->instante_s < consulta->de_s) continue;
+        if (registro->instante_s > consulta->ate_s) {
+            consulta->fim = true;
+            break;
+        }
+        return true;
+    }
+    return false;
+}
+
+const flashlog_stats_t *flashlog_stats(void) {
+    return &fl.stats;
+}
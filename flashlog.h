@@ -0,0 +1,59 @@
+// flashlog.h
+// Histórico local dos sensores numa região reservada da flash.
+//
+// Os registros (formato em flashlog_codec.h, poucos bytes cada) se acumulam
+// numa página de 256 bytes em RAM e vão para a flash quando ela enche ou a
+// cada FLASHLOG_SYNC_S segundos. Os setores são usados em círculo: cada um é
+// apagado apenas quando o log dá a volta, o que distribui o desgaste por
+// igual entre todos os setores da região. O setor mais antigo é sobrescrito
+// quando a região enche.
+#ifndef FLASHLOG_H
+#define FLASHLOG_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "flashlog_codec.h"
+
+#define FLASHLOG_TAMANHO (256 * 1024)                          // ~4 semanas com amostras a cada 30 s
+#define FLASHLOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASHLOG_TAMANHO)  // Final da flash, longe do programa
+#define FLASHLOG_SETORES (FLASHLOG_TAMANHO / FLASHLOG_SETOR)
+#define FLASHLOG_SYNC_S 600                                    // Perda máxima numa queda de energia
+
+typedef struct {
+    uint32_t registros;           // Registros gravados desde o boot
+    uint32_t bytes;               // Bytes desses registros
+    uint32_t paginas_gravadas;    // Programações de página (inclui as parciais do sync)
+    uint32_t setores_apagados;
+} flashlog_stats_t;
+
+// Consulta por intervalo de tempo (ver flashlog_consultar)
+typedef struct {
+    uint32_t de_s, ate_s;
+    uint16_t posicao_setor;       // Índice na ordem do mais antigo ao mais novo
+    uint16_t offset;              // Próximo byte dentro do setor
+    const uint8_t *setor;
+    flashlog_estado_t estado;
+    bool fim;
+} flashlog_consulta_t;
+
+// Localiza o setor atual e o fim dos registros. Chamar uma vez antes de usar o log.
+void flashlog_init(void);
+
+// Instante do último registro gravado (0 com o log vazio). Permite continuar a contagem
+// de tempo do log depois de um reboot.
+uint32_t flashlog_ultimo_instante(void);
+
+// Acrescenta um registro (vai para a flash quando a página enche ou no próximo sync)
+void flashlog_adicionar(const flashlog_registro_t *registro);
+
+// Grava a página em RAM na flash, mesmo parcial
+void flashlog_sync(void);
+
+// Registros com instante em [de_s, ate_s], do mais antigo ao mais novo. O início é
+// achado por busca binária nos cabeçalhos dos setores, sem decodificar o log inteiro.
+void flashlog_consultar(flashlog_consulta_t *consulta, uint32_t de_s, uint32_t ate_s);
+bool flashlog_proximo(flashlog_consulta_t *consulta, flashlog_registro_t *registro);
+
+const flashlog_stats_t *flashlog_stats(void);
+
+#endif
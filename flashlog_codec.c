@@ -0,0 +1,143 @@
+// flashlog_codec.c
+// Codificação dos registros e dos setores do histórico na flash (ver flashlog_codec.h).
+#include <string.h>
+#include "flashlog_codec.h"
+
+#define BIT_INTERVALO_IGUAL (1u << 4)
+#define BIT_TEMPERATURA_IGUAL (1u << 5)
+#define BIT_UMIDADE_IGUAL (1u << 6)
+
+static uint8_t *varint_escrever(uint8_t *p, uint32_t valor) {
+    while (valor >= 0x80) {
+        *p++ = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    *p++ = (uint8_t)valor;
+    return p;
+}
+
+static const uint8_t *varint_ler(const uint8_t *p, const uint8_t *fim, uint32_t *valor) {
+    uint32_t v = 0;
+    for (unsigned deslocamento = 0; p < fim && deslocamento < 35; deslocamento += 7) {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << deslocamento;
+        if (!(b & 0x80)) {
+            *valor = v;
+            return p;
+        }
+    }
+    return NULL;  // Truncado
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t dezigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+void flashlog_estado_inicio(flashlog_estado_t *estado, const flashlog_cabecalho_t *cabecalho) {
+    estado->instante_s = cabecalho->instante_s;
+    estado->temperatura_centi = 0;
+    estado->umidade_mv = 0;
+    estado->intervalo_s = 0;
+}
+
+size_t flashlog_codificar(const flashlog_registro_t *r, flashlog_estado_t *estado, uint8_t *saida) {
+    uint32_t intervalo = r->instante_s > estado->instante_s ? r->instante_s - estado->instante_s : 0;
+    int32_t d_temperatura = r->temperatura_centi - estado->temperatura_centi;
+    int32_t d_umidade = (int32_t)r->umidade_mv - estado->umidade_mv;
+
+    uint8_t *p = saida + 1;
+    uint8_t cabecalho = r->estados & 0x0F;
+    if (intervalo == estado->intervalo_s) cabecalho |= BIT_INTERVALO_IGUAL;
+    else p = varint_escrever(p, intervalo);
+    if (d_temperatura == 0) cabecalho |= BIT_TEMPERATURA_IGUAL;
+    else p = varint_escrever(p, zigzag(d_temperatura));
+    if (d_umidade == 0) cabecalho |= BIT_UMIDADE_IGUAL;
+    else p = varint_escrever(p, zigzag(d_umidade));
+    saida[0] = cabecalho;
+
+    estado->instante_s += intervalo;
+    estado->intervalo_s = intervalo;
+    estado->temperatura_centi = r->temperatura_centi;
+    estado->umidade_mv = r->umidade_mv;
+    return (size_t)(p - saida);
+}
+
+size_t flashlog_decodificar(const uint8_t *p, const uint8_t *fim, flashlog_estado_t *estado,
+                            flashlog_registro_t *r) {
+    const uint8_t *inicio = p;
+    if (p >= fim || (*p & 0x80)) return 0;
+    uint8_t cabecalho = *p++;
+
+    uint32_t intervalo = estado->intervalo_s, valor;
+    int32_t temperatura = estado->temperatura_centi, umidade = estado->umidade_mv;
+    if (!(cabecalho & BIT_INTERVALO_IGUAL)) {
+        if (!(p = varint_ler(p, fim, &valor))) return 0;
+        intervalo = valor;
+    }
+    if (!(cabecalho & BIT_TEMPERATURA_IGUAL)) {
+        if (!(p = varint_ler(p, fim, &valor))) return 0;
+        temperatura += dezigzag(valor);
+    }
+    if (!(cabecalho & BIT_UMIDADE_IGUAL)) {
+        if (!(p = varint_ler(p, fim, &valor))) return 0;
+        umidade += dezigzag(valor);
+    }
+
+    estado->instante_s += intervalo;
+    estado->intervalo_s = intervalo;
+    estado->temperatura_centi = temperatura;
+    estado->umidade_mv = umidade;
+
+    r->instante_s = estado->instante_s;
+    r->temperatura_centi = (int16_t)temperatura;
+    r->umidade_mv = (uint16_t)umidade;
+    r->estados = cabecalho & 0x0F;
+    return (size_t)(p - inicio);
+}
+
+void flashlog_cabecalho_montar(flashlog_cabecalho_t *c, uint32_t sequencia, uint32_t instante_s) {
+    c->magica = FLASHLOG_MAGICA;
+    c->sequencia = sequencia;
+    c->instante_s = instante_s;
+    c->verificacao = ~(c->magica ^ sequencia ^ instante_s);
+}
+
+bool flashlog_cabecalho_valido(const flashlog_cabecalho_t *c) {
+    return c->magica == FLASHLOG_MAGICA && c->verificacao == ~(c->magica ^ c->sequencia ^ c->instante_s);
+}
+
+unsigned flashlog_ordenar(const uint8_t *regiao, unsigned setores, uint16_t *ordem) {
+    // Ordenação por inserção: as sequências já estão quase em ordem circular
+    unsigned n = 0;
+    for (unsigned s = 0; s < setores; ++s) {
+        flashlog_cabecalho_t c;
+        memcpy(&c, regiao + (size_t)s * FLASHLOG_SETOR, sizeof(c));
+        if (!flashlog_cabecalho_valido(&c)) continue;
+        unsigned i = n++;
+        while (i > 0) {
+            flashlog_cabecalho_t anterior;
+            memcpy(&anterior, regiao + (size_t)ordem[i - 1] * FLASHLOG_SETOR, sizeof(anterior));
+            if (anterior.sequencia < c.sequencia) break;
+            ordem[i] = ordem[i - 1];
+            --i;
+        }
+        ordem[i] = (uint16_t)s;
+    }
+    return n;
+}
+
+size_t flashlog_fim_setor(const uint8_t *setor, flashlog_estado_t *estado) {
+    flashlog_cabecalho_t c;
+    memcpy(&c, setor, sizeof(c));
+    flashlog_estado_inicio(estado, &c);
+
+    const uint8_t *p = setor + sizeof(c), *fim = setor + FLASHLOG_SETOR;
+    flashlog_registro_t r;
+    size_t n;
+    while ((n = flashlog_decodificar(p, fim, estado, &r)) != 0) p += n;
+    return (size_t)(p - setor);
+}
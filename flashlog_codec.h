@@ -0,0 +1,78 @@
+// flashlog_codec.h
+// Formato do registro histórico na flash, sem dependências do SDK: o mesmo
+// código é usado pelo firmware (flashlog.c) e pelas ferramentas de host.
+//
+// A região é uma sequência circular de setores de 4 KB. Cada setor começa com
+// um cabeçalho (número de sequência e instante do primeiro registro) seguido
+// de registros de tamanho variável. Cada registro guarda a diferença para o
+// anterior do mesmo setor:
+//
+//   byte 0: bits 0-3 estados, bit 4 "intervalo igual ao anterior",
+//           bit 5 "temperatura igual", bit 6 "umidade igual", bit 7 sempre 0
+//   [intervalo em segundos, varint]  se o bit 4 for 0
+//   [delta da temperatura, varint zigzag]  se o bit 5 for 0
+//   [delta da umidade, varint zigzag]  se o bit 6 for 0
+//
+// Como o bit 7 é sempre 0, um byte 0xFF (flash apagada) marca o fim dos registros.
+#ifndef FLASHLOG_CODEC_H
+#define FLASHLOG_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FLASHLOG_SETOR 4096
+#define FLASHLOG_PAGINA 256
+#define FLASHLOG_MAGICA 0x474F4C46u   // "FLOG"
+#define FLASHLOG_REGISTRO_MAX 12      // 1 + 5 + 3 + 3 bytes
+
+// Estados discretos (mesmos bits de AMOSTRA_* em amostras.h)
+#define FLASHLOG_UMIDO     (1u << 0)
+#define FLASHLOG_LUZ       (1u << 1)
+#define FLASHLOG_IRRIGANDO (1u << 2)
+#define FLASHLOG_FELIZ     (1u << 3)
+
+typedef struct {
+    uint32_t instante_s;
+    int16_t temperatura_centi;    // Centésimos de grau
+    uint16_t umidade_mv;          // Tensão do sensor de umidade
+    uint8_t estados;              // FLASHLOG_* (4 bits)
+} flashlog_registro_t;
+
+typedef struct {
+    uint32_t magica;
+    uint32_t sequencia;           // Cresce a cada setor iniciado; o maior é o setor atual
+    uint32_t instante_s;          // Instante do primeiro registro do setor
+    uint32_t verificacao;         // ~(magica ^ sequencia ^ instante_s)
+} flashlog_cabecalho_t;
+
+// Estado do codificador/decodificador dentro de um setor
+typedef struct {
+    uint32_t instante_s;
+    int32_t temperatura_centi;
+    int32_t umidade_mv;
+    uint32_t intervalo_s;
+} flashlog_estado_t;
+
+// Prepara o estado para o primeiro registro de um setor
+void flashlog_estado_inicio(flashlog_estado_t *estado, const flashlog_cabecalho_t *cabecalho);
+
+// Codifica `r` em `saida` (FLASHLOG_REGISTRO_MAX bytes) e avança o estado. Retorna o tamanho.
+// Instantes anteriores ao último registro são gravados como iguais a ele.
+size_t flashlog_codificar(const flashlog_registro_t *r, flashlog_estado_t *estado, uint8_t *saida);
+
+// Decodifica um registro de [p, fim). Retorna os bytes consumidos ou 0 no fim dos registros.
+size_t flashlog_decodificar(const uint8_t *p, const uint8_t *fim, flashlog_estado_t *estado,
+                            flashlog_registro_t *r);
+
+void flashlog_cabecalho_montar(flashlog_cabecalho_t *c, uint32_t sequencia, uint32_t instante_s);
+bool flashlog_cabecalho_valido(const flashlog_cabecalho_t *c);
+
+// Ordena os setores válidos de uma região do mais antigo ao mais novo (por sequência).
+// `ordem` recebe até `setores` índices; retorna quantos setores válidos existem.
+unsigned flashlog_ordenar(const uint8_t *regiao, unsigned setores, uint16_t *ordem);
+
+// Posição do fim dos registros de um setor (onde o próximo seria gravado), com o estado final
+size_t flashlog_fim_setor(const uint8_t *setor, flashlog_estado_t *estado);
+
+#endif
@@ -0,0 +1,294 @@
+// frota.c
+// Implementação do modo frota (ver frota.h).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/adc.h"
+#include "ds18b20.h"
+#include "ow_rom.h"
+#include "frota.h"
+
+enum { FASE_CONVERTER, FASE_AGUARDAR, FASE_LER };
+
+// Desloca a imagem dos relés pelos 74HC595, do último vaso ao primeiro, e trava as saídas
+static void frota_reles_enviar(const frota_t *f, uint32_t reles) {
+    const frota_config_t *c = f->config;
+    int bits = (c->vasos + 7) / 8 * 8;
+    for (int i = bits - 1; i >= 0; --i) {
+        gpio_put(c->hc595_dados, (reles >> i) & 1);
+        gpio_put(c->hc595_clock, 1);
+        gpio_put(c->hc595_clock, 0);
+    }
+    gpio_put(c->hc595_trava, 1);
+    gpio_put(c->hc595_trava, 0);
+}
+
+static void frota_saida(uint gpio, bool valor) {
+    gpio_init(gpio);
+    gpio_put(gpio, valor);
+    gpio_set_dir(gpio, GPIO_OUT);
+}
+
+void frota_init(frota_t *f, const frota_config_t *config, const regras_tabela_t *regras,
+                const irrigacao_config_t *irrigacao, uint32_t agora_ms) {
+    memset(f, 0, sizeof(*f));
+    f->config = config;
+
+    // Relés: as saídas dos 74HC595 ficam desabilitadas (OE em 1) até a primeira
+    // imagem, toda desligada, ser travada; sem isso ligariam com lixo no boot
+    frota_saida(config->hc595_oe, 1);
+    frota_saida(config->hc595_dados, 0);
+    frota_saida(config->hc595_clock, 0);
+    frota_saida(config->hc595_trava, 0);
+    frota_reles_enviar(f, 0);
+    gpio_put(config->hc595_oe, 0);
+
+    for (uint i = 0; i < 4; ++i) frota_saida(config->mux_s0 + i, 0);
+    for (uint m = 0; m * FROTA_MUX_CANAIS < config->vasos; ++m) adc_gpio_init(26 + config->mux_adc[m]);
+
+    // Sensores de todos os barramentos; cada vaso fica com o do seu código no mapa
+    // da tabela de regras, em qualquer barramento. A troca ou a falta de um
+    // sensor não muda a temperatura dos outros vasos.
+    uint64_t achados[FROTA_MAX];
+    uint8_t achado_em[FROTA_MAX];
+    uint8_t sensores = 0;
+    for (uint8_t b = 0; b < config->barramentos && sensores < FROTA_MAX; ++b) {
+        if (!ow_group_add(&f->grupo, pio0, config->onewire_gpio[b])) {
+            printf("Frota: sem máquina de estados para o 1-Wire do GPIO %u\n", config->onewire_gpio[b]);
+            break;
+        }
+        int n = ow_romsearch(&f->grupo.bus[b], achados + sensores, FROTA_MAX - sensores, OW_SEARCH_ROM);
+        if (n <= 0) continue;
+        memset(achado_em + sensores, b, n);
+        sensores += n;
+    }
+    f->stats.barramentos = f->grupo.count;
+    f->stats.sensores = sensores;
+    uint32_t usados = 0;
+    for (uint8_t i = 0; i < config->vasos; ++i) {
+        uint64_t rom = regras_rom_do_vaso(regras, i);
+        uint8_t k = 0;
+        while (k < sensores && achados[k] != rom) ++k;
+        if (rom && k < sensores) {
+            f->rom[i] = rom;
+            f->barramento[i] = achado_em[k];
+            f->com_sensor |= 1u << i;
+            usados |= 1u << k;
+            printf("Frota: vaso %u, barramento %u, DS18B20 %016llx\n", i, f->barramento[i], (unsigned long long)rom);
+        } else if (rom) {
+            printf("Frota: vaso %u sem temperatura, DS18B20 %016llx não encontrado\n", i, (unsigned long long)rom);
+        }
+        f->seco_mv[i] = config->seco_mv;
+        f->encharcado_mv[i] = config->encharcado_mv;
+        regras_vaso_init(&f->regras[i], regras, regras_perfil_do_vaso(regras, i));
+        irrigacao_init(&f->irrigacao[i], irrigacao, agora_ms);
+    }
+    for (uint8_t k = 0; k < sensores; ++k) {
+        if (!(usados & 1u << k)) {
+            printf("Frota: DS18B20 %016llx no barramento %u sem vaso no mapa (tools/regras/perfis.txt)\n",
+                   (unsigned long long)achados[k], achado_em[k]);
+        }
+    }
+    printf("Frota: %u vasos, %u com temperatura, %u DS18B20 em %u barramentos\n", config->vasos,
+           __builtin_popcount(f->com_sensor), sensores, f->grupo.count);
+}
+
+// Varredura do ADC: um multiplexador por vez, todos os canais dele
+static void frota_ler_umidade(frota_t *f) {
+    const frota_config_t *c = f->config;
+    uint32_t mascara = 0xFu << c->mux_s0;
+    for (uint8_t i = 0; i < c->vasos; ++i) {
+        uint8_t canal = i % FROTA_MUX_CANAIS;
+        if (!canal) adc_select_input(c->mux_adc[i / FROTA_MUX_CANAIS]);
+        gpio_put_masked(mascara, (uint32_t)canal << c->mux_s0);
+        busy_wait_us_32(FROTA_MUX_ACOMODACAO_US);
+        f->umidade_mv[i] = (uint16_t)(adc_read() * 3300u / 4095u);
+    }
+}
+
+// Próximo vaso com sensor no barramento `b` a partir de f->proximo[b]; vasos se acabaram
+static uint8_t frota_proximo(frota_t *f, uint8_t b) {
+    uint8_t i = f->proximo[b];
+    while (i < f->config->vasos && !((f->com_sensor & 1u << i) && f->barramento[i] == b)) ++i;
+    return f->proximo[b] = i;
+}
+
+// Um DS18B20 de cada barramento, todos ao mesmo tempo: Match ROM com o código
+// de cada um e só os dois primeiros bytes do scratchpad (o reset seguinte
+// encerra a leitura). Retorna false quando não há mais o que ler na rodada.
+static bool frota_ler_ds18b20(frota_t *f) {
+    uint64_t roms[OW_GROUP_MAX] = {0};
+    uint8_t vaso[OW_GROUP_MAX], lsb[OW_GROUP_MAX], msb[OW_GROUP_MAX];
+    uint mascara = 0;
+    for (uint8_t b = 0; b < f->grupo.count; ++b) {
+        vaso[b] = frota_proximo(f, b);
+        if (vaso[b] < f->config->vasos) {
+            roms[b] = f->rom[vaso[b]];
+            mascara |= 1u << b;
+            ++f->proximo[b];
+        }
+    }
+    if (!mascara) return false;
+
+    uint presentes = ow_group_reset(&f->grupo, mascara);
+    ow_group_send(&f->grupo, presentes, OW_MATCH_ROM);
+    ow_group_send_rom(&f->grupo, presentes, roms);
+    ow_group_send(&f->grupo, presentes, DS18B20_READ_SCRATCHPAD);
+    ow_group_read(&f->grupo, presentes, lsb);
+    ow_group_read(&f->grupo, presentes, msb);
+    for (uint8_t b = 0; b < f->grupo.count; ++b) {
+        if (!(mascara & 1u << b)) continue;
+        uint8_t i = vaso[b];
+        int16_t bruto = (int16_t)(msb[b] << 8 | lsb[b]);
+        if (presentes & 1u << b && bruto != -1) {  // 0xFFFF: ninguém respondeu
+            f->temperatura_centi[i] = (int16_t)(bruto * 100 / 16);
+            f->temperatura_ok |= 1u << i;
+        } else {
+            f->temperatura_ok &= ~(1u << i);
+            ++f->stats.falhas_temperatura;
+        }
+    }
+    return true;
+}
+
+// Próxima parte da rodada de temperatura; retorna true quando a rodada termina
+static bool frota_temperatura(frota_t *f, uint32_t agora_ms) {
+    if (!f->com_sensor) return false;
+    switch (f->fase) {
+    case FASE_CONVERTER: {
+        uint presentes = ow_group_reset(&f->grupo, (1u << f->grupo.count) - 1);
+        ow_group_send(&f->grupo, presentes, OW_SKIP_ROM);  // Todos os DS18B20 de todos os barramentos
+        ow_group_send(&f->grupo, presentes, DS18B20_CONVERT_T);
+        f->conversao_ms = agora_ms;
+        f->fase = FASE_AGUARDAR;
+        return false;
+    }
+    case FASE_AGUARDAR:
+        if (agora_ms - f->conversao_ms < FROTA_CONVERSAO_MS) return false;
+        f->fase = FASE_LER;
+        memset(f->proximo, 0, sizeof(f->proximo));
+        // fall through
+    default:
+        for (uint8_t passo = 0; passo < f->config->leituras_por_ciclo; ++passo) {
+            if (!frota_ler_ds18b20(f)) {
+                f->fase = FASE_CONVERTER;
+                ++f->stats.rodadas;
+                f->stats.rodada_ms = agora_ms - f->conversao_ms;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool frota_ciclo(frota_t *f, bool luz, uint32_t agora_ms) {
+    uint8_t n = f->config->vasos;
+    uint64_t inicio = time_us_64();
+    frota_ler_umidade(f);
+    uint64_t depois_adc = time_us_64();
+    bool rodada = frota_temperatura(f, agora_ms);
+    uint64_t depois_onewire = time_us_64();
+
+    // Calibração e regras, uma entrada por vez para todos os vasos
+    for (uint8_t i = 0; i < n; ++i) {
+        int32_t faixa = (int32_t)f->encharcado_mv[i] - f->seco_mv[i];
+        int32_t numerador = ((int32_t)f->umidade_mv[i] - f->seco_mv[i]) * 1000;
+        // Arredondado como calibrar_umidade(): 1500 mV dá 389, o mínimo do perfil padrão
+        f->umidade_pdm[i] = (int16_t)((numerador + (numerador < 0 ? -faixa : faixa) / 2) / faixa);
+    }
+    f->umidade_ms = agora_ms;
+    for (uint8_t i = 0; i < n; ++i) regras_atualizar(&f->regras[i], REGRAS_UMIDADE, f->umidade_pdm[i], agora_ms);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (f->temperatura_ok & 1u << i) {
+            regras_atualizar(&f->regras[i], REGRAS_TEMPERATURA, f->temperatura_centi[i], agora_ms);
+        }
+    }
+    for (uint8_t i = 0; i < n; ++i) regras_atualizar(&f->regras[i], REGRAS_LUZ, luz, agora_ms);
+    uint32_t feliz = 0;
+    for (uint8_t i = 0; i < n; ++i) {
+        regras_tempo(&f->regras[i], agora_ms);
+        feliz |= (uint32_t)f->regras[i].feliz << i;
+    }
+    f->feliz = feliz;
+
+    uint64_t fim = time_us_64();
+    frota_stats_t *s = &f->stats;
+    ++s->ciclos;
+    s->adc_us = (uint32_t)(depois_adc - inicio);
+    s->onewire_us = (uint32_t)(depois_onewire - depois_adc);
+    s->avaliacao_us = (uint32_t)(fim - depois_onewire);
+    s->ciclo_us = (uint32_t)(fim - inicio);
+    if (s->onewire_us > s->onewire_max_us) s->onewire_max_us = s->onewire_us;
+    if (s->ciclo_us > s->ciclo_max_us) s->ciclo_max_us = s->ciclo_us;
+    return rodada;
+}
+
+void frota_irrigar(frota_t *f, irrigacao_comando_t comando, uint32_t vasos, uint32_t agora_ms) {
+    uint32_t idade_ms = f->umidade_ms ? agora_ms - f->umidade_ms : UINT32_MAX;
+    uint32_t reles = 0;
+    for (uint8_t i = 0; i < f->config->vasos; ++i) {
+        irrigacao_comando_t c = vasos & 1u << i ? comando : IRRIGACAO_NENHUM;
+        reles |= (uint32_t)irrigacao_passo(&f->irrigacao[i], f->umidade_pdm[i], idade_ms, c, agora_ms) << i;
+    }
+    if (reles != f->reles) {
+        f->reles = reles;
+        frota_reles_enviar(f, reles);
+    }
+}
+
+size_t frota_json(const frota_t *f, char *destino, size_t tamanho) {
+    int n = snprintf(destino, tamanho, "{\"vasos\":[");
+    for (uint8_t i = 0; i < f->config->vasos && n > 0 && (size_t)n < tamanho; ++i) {
+        char temperatura[12] = "null";  // Sem DS18B20 ou sem leitura válida
+        int16_t t = f->temperatura_centi[i];
+        if (f->temperatura_ok & 1u << i) {
+            snprintf(temperatura, sizeof(temperatura), "%s%d.%02d", t < 0 ? "-" : "", abs(t) / 100, abs(t) % 100);
+        }
+        int16_t u = f->umidade_pdm[i];
+        int m = snprintf(destino + n, tamanho - n,
+                         "%s{\"vaso\":%u,\"temperatura_solo\":%s,\"umidade_pct\":%s%d.%d,\"feliz\":%s,"
+                         "\"irrigacao\":\"%s\",\"perfil\":\"%.*s\"}",
+                         i ? "," : "", i, temperatura, u < 0 ? "-" : "", abs(u) / 10, abs(u) % 10,
+                         f->feliz & 1u << i ? "true" : "false", irrigacao_nome(f->irrigacao[i].estado),
+                         REGRAS_NOME_MAX, f->regras[i].perfil);
+        n = m > 0 ? n + m : 0;
+    }
+    if (n > 0 && (size_t)n < tamanho) {
+        int m = snprintf(destino + n, tamanho - n, "]}\n");
+        n = m > 0 ? n + m : 0;
+    }
+    return n > 0 && (size_t)n < tamanho ? (size_t)n : 0;
+}
+
+size_t frota_metricas(const frota_t *f, char *destino, size_t tamanho) {
+    const frota_stats_t *s = &f->stats;
+    uint tempos_esgotados = 0;
+    for (uint b = 0; b < f->grupo.count; ++b) tempos_esgotados += f->grupo.bus[b].timeouts;
+    int n = snprintf(destino, tamanho,
+        "vaso_frota_vasos %u\nvaso_frota_sensores %u\nvaso_frota_barramentos %u\nvaso_frota_ciclos_total %lu\n"
+        "vaso_frota_ciclo_segundos %.6f\nvaso_frota_ciclo_max_segundos %.6f\n"
+        "vaso_frota_etapa_segundos{etapa=\"adc\"} %.6f\nvaso_frota_etapa_segundos{etapa=\"onewire\"} %.6f\n"
+        "vaso_frota_etapa_segundos{etapa=\"avaliacao\"} %.6f\nvaso_frota_onewire_max_segundos %.6f\n"
+        "vaso_frota_rodadas_total %lu\nvaso_frota_rodada_segundos %.3f\nvaso_frota_falhas_temperatura_total %lu\n"
+        "vaso_frota_onewire_tempos_esgotados_total %u\n",
+        f->config->vasos, s->sensores, s->barramentos, (unsigned long)s->ciclos, s->ciclo_us / 1e6, s->ciclo_max_us / 1e6,
+        s->adc_us / 1e6, s->onewire_us / 1e6, s->avaliacao_us / 1e6, s->onewire_max_us / 1e6,
+        (unsigned long)s->rodadas, s->rodada_ms / 1e3, (unsigned long)s->falhas_temperatura, tempos_esgotados);
+    for (uint8_t i = 0; i < f->config->vasos && n > 0 && (size_t)n < tamanho; ++i) {
+        int16_t u = f->umidade_pdm[i];
+        int m = snprintf(destino + n, tamanho - n,
+                         "vaso_frota_umidade_porcento{vaso=\"%u\"} %s%d.%d\n"
+                         "vaso_frota_feliz{vaso=\"%u\"} %d\nvaso_frota_irrigando{vaso=\"%u\"} %d\n",
+                         i, u < 0 ? "-" : "", abs(u) / 10, abs(u) % 10, i, (int)(f->feliz >> i & 1), i,
+                         (int)(f->reles >> i & 1));
+        n = m > 0 ? n + m : 0;
+        if (n > 0 && (size_t)n < tamanho && f->temperatura_ok & 1u << i) {  // Sem leitura, sem a série
+            int16_t t = f->temperatura_centi[i];
+            m = snprintf(destino + n, tamanho - n, "vaso_frota_temperatura_celsius{vaso=\"%u\"} %s%d.%02d\n", i,
+                         t < 0 ? "-" : "", abs(t) / 100, abs(t) % 100);
+            n = m > 0 ? n + m : 0;
+        }
+    }
+    return n > 0 && (size_t)n < tamanho ? (size_t)n : 0;
+}
@@ -0,0 +1,103 @@
+// frota.h
+// Modo frota (MODO_FROTA): uma placa cuidando de vários vasos.
+//
+// A umidade de cada vaso chega ao ADC por multiplexadores analógicos de 16
+// canais (CD74HC4067, quatro GPIOs de seleção em comum, um por entrada do ADC);
+// os DS18B20 ficam em um ou mais barramentos 1-Wire, cada um numa máquina de
+// estados do PIO, endereçados pelo código ROM; e os relés são saídas de registradores de deslocamento 74HC595
+// em cascata (oito vasos por chip).
+//
+// O estado de cada vaso fica em vetores indexados pelo vaso (struct of arrays),
+// e cada etapa do ciclo é um laço curto sobre todos os vasos: varredura do ADC,
+// calibração, regras de cada entrada, controle da irrigação, relés e a
+// formatação das respostas do servidor local. A conversão de temperatura é uma
+// só para todos os barramentos, ao mesmo tempo; as leituras dos DS18B20 são
+// divididas entre ciclos (`leituras_por_ciclo`), e cada leitura pega um sensor
+// de cada barramento em paralelo (OW_GROUP). O tempo de 1-Wire de um ciclo não
+// depende do número de vasos nem do de barramentos.
+#ifndef FROTA_H
+#define FROTA_H
+
+#include "pico/stdlib.h"
+#include "onewire_library.h"
+#include "regras.h"
+#include "irrigacao.h"
+
+#define FROTA_MAX 32                    // Dois multiplexadores e quatro 74HC595
+#define FROTA_MUX_CANAIS 16
+#define FROTA_MUX_ACOMODACAO_US 10      // Espera depois de trocar o canal do multiplexador
+#define FROTA_CONVERSAO_MS 750          // Conversão de 12 bits do DS18B20
+
+typedef struct {
+    uint8_t vasos;                      // Vasos ligados (até FROTA_MAX)
+    uint8_t mux_s0;                     // Primeiro dos 4 GPIOs de seleção (S0..S3 consecutivos)
+    uint8_t mux_adc[FROTA_MAX / FROTA_MUX_CANAIS];  // Entrada do ADC de cada multiplexador
+    uint8_t hc595_dados, hc595_clock, hc595_trava, hc595_oe;
+    uint8_t barramentos;                // Barramentos 1-Wire (até OW_GROUP_MAX)
+    uint8_t onewire_gpio[OW_GROUP_MAX];
+    uint8_t leituras_por_ciclo;         // DS18B20 lidos por ciclo em cada barramento
+    uint16_t seco_mv, encharcado_mv;    // Calibração inicial da umidade de todos os vasos
+} frota_config_t;
+
+typedef struct {
+    uint32_t ciclos;
+    uint32_t ciclo_us, ciclo_max_us;    // Último ciclo e o mais longo
+    uint32_t adc_us, onewire_us, avaliacao_us;  // Etapas do último ciclo
+    uint32_t onewire_max_us;
+    uint32_t rodadas;                   // Rodadas completas de temperatura
+    uint32_t rodada_ms;                 // Última rodada (conversão e leituras)
+    uint32_t falhas_temperatura;
+    uint8_t sensores;                   // DS18B20 achados na busca
+    uint8_t barramentos;                // Barramentos 1-Wire iniciados
+} frota_stats_t;
+
+typedef struct {
+    const frota_config_t *config;
+    OW_GROUP grupo;
+
+    // Estado dos vasos (um elemento por vaso; bits: bit i = vaso i)
+    uint16_t umidade_mv[FROTA_MAX];
+    volatile int16_t umidade_pdm[FROTA_MAX];   // Lida pelo temporizador da irrigação
+    int16_t temperatura_centi[FROTA_MAX];
+    uint16_t seco_mv[FROTA_MAX], encharcado_mv[FROTA_MAX];
+    uint64_t rom[FROTA_MAX];            // DS18B20 de cada vaso (do mapa da tabela de regras)
+    uint8_t barramento[FROTA_MAX];      // Índice do barramento do DS18B20 no grupo
+    uint32_t com_sensor;                // Vasos com DS18B20
+    uint32_t temperatura_ok;            // Última leitura de temperatura válida
+    uint32_t feliz;
+    volatile uint32_t reles;            // Imagem dos 74HC595
+    volatile uint32_t umidade_ms;       // Última varredura do ADC
+    regras_vaso_t regras[FROTA_MAX];
+    irrigacao_t irrigacao[FROTA_MAX];
+
+    // Rodada de temperatura: conversão em todos, depois as leituras em partes
+    uint8_t fase;
+    uint8_t proximo[OW_GROUP_MAX];      // Próximo vaso a ler em cada barramento
+    uint32_t conversao_ms;
+    frota_stats_t stats;
+} frota_t;
+
+// Configura os pinos, desliga os relés, inicia os barramentos 1-Wire (máquinas
+// de estados do pio0, depois do pio1), acha os DS18B20 e prepara as regras e a
+// irrigação de cada vaso. O sensor de cada vaso vem do mapa de códigos ROM da
+// tabela de regras (regras_rom_do_vaso()); um vaso sem código no mapa, ou cujo
+// sensor não foi achado, fica sem temperatura.
+void frota_init(frota_t *f, const frota_config_t *config, const regras_tabela_t *regras,
+                const irrigacao_config_t *irrigacao, uint32_t agora_ms);
+
+// Um ciclo: umidade de todos os vasos, a próxima parte da rodada de temperatura,
+// calibração e regras. `luz` vem do LDR da placa, comum a todos: true quando há
+// luz (REGRAS_LUZ = 1), ou seja, o inverso de ler_estado_ldr(). Retorna true
+// quando uma rodada de temperatura termina.
+bool frota_ciclo(frota_t *f, bool luz, uint32_t agora_ms);
+
+// Passo dos controladores de irrigação e envio dos relés que mudaram. Chamar
+// do temporizador da irrigação; `comando` vale para os vasos da máscara `vasos`
+// (bit i = vaso i), e os outros dão o passo sem comando.
+void frota_irrigar(frota_t *f, irrigacao_comando_t comando, uint32_t vasos, uint32_t agora_ms);
+
+// Respostas do servidor local: /data.json com um objeto por vaso e as métricas por vaso
+size_t frota_json(const frota_t *f, char *destino, size_t tamanho);
+size_t frota_metricas(const frota_t *f, char *destino, size_t tamanho);
+
+#endif
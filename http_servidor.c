@@ -0,0 +1,172 @@
+// http_servidor.c
+// Núcleo do servidor HTTP local: respostas pré-formatadas e leitura das requisições.
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "http_servidor.h"
+
+typedef struct {
+    char *memoria;
+    uint16_t capacidade;
+    const char *tipo;               // Content-Type
+    http_gerador_fn gerador;
+    uint8_t atual;                  // Buffer entregue às novas requisições
+    const char *dados[2];           // Início da resposta em cada buffer
+    uint16_t tamanho[2];
+} http_recurso_t;
+
+static char memoria_json[2][HTTP_JSON_MAX];
+static char memoria_metricas[2][HTTP_METRICAS_MAX];
+
+static http_recurso_t recursos[2] = {
+    {.memoria = memoria_json[0], .capacidade = HTTP_JSON_MAX, .tipo = "application/json"},
+    {.memoria = memoria_metricas[0], .capacidade = HTTP_METRICAS_MAX, .tipo = "text/plain; version=0.0.4"},
+};
+#define RECURSO_JSON 0
+#define RECURSO_METRICAS 1
+
+// Retenções de cada buffer (recurso * 2 + índice) por respostas ainda em envio
+static volatile uint16_t retencoes[4];
+static bool publicacao_pendente;
+
+static const char resposta_404[] =
+    "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\n\r\nnot found\n";
+static const char resposta_503[] =
+    "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nRetry-After: 1\r\n\r\n";
+
+static http_servidor_stats_t stats;
+
+// Gera o corpo e escreve o cabeçalho logo antes dele, para que a resposta fique contígua
+static bool http_recurso_montar(http_recurso_t *r, uint8_t indice) {
+    char *buffer = r->memoria + (size_t)indice * r->capacidade;
+    char *corpo = buffer + HTTP_CABECALHO_MAX;
+    size_t n = r->gerador ? r->gerador(corpo, r->capacidade - HTTP_CABECALHO_MAX) : 0;
+    if (n == 0 || n >= (size_t)(r->capacidade - HTTP_CABECALHO_MAX)) return false;
+
+    char cabecalho[HTTP_CABECALHO_MAX];
+    int h = snprintf(cabecalho, sizeof(cabecalho),
+                     "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %u\r\nCache-Control: no-store\r\n\r\n",
+                     r->tipo, (unsigned)n);
+    if (h <= 0 || h >= HTTP_CABECALHO_MAX) return false;
+    memcpy(corpo - h, cabecalho, (size_t)h);
+    r->dados[indice] = corpo - h;
+    r->tamanho[indice] = (uint16_t)(h + n);
+    return true;
+}
+
+void http_servidor_init(http_gerador_fn json, http_gerador_fn metricas) {
+    recursos[RECURSO_JSON].gerador = json;
+    recursos[RECURSO_METRICAS].gerador = metricas;
+    for (uint8_t i = 0; i < 2; ++i) {
+        recursos[i].atual = 0;
+        recursos[i].dados[0] = recursos[i].dados[1] = NULL;
+    }
+    memset((void *)retencoes, 0, sizeof(retencoes));
+    memset(&stats, 0, sizeof(stats));
+    publicacao_pendente = false;
+}
+
+void http_servidor_publicar(void) {
+    for (uint8_t i = 0; i < 2; ++i) {
+        http_recurso_t *r = &recursos[i];
+        // Antes da primeira resposta, qualquer buffer serve; depois, só o que não está em uso
+        uint8_t livre = r->dados[r->atual] ? (uint8_t)(r->atual ^ 1) : r->atual;
+        if (retencoes[i * 2 + livre]) {
+            ++stats.atualizacoes_adiadas;
+            publicacao_pendente = true;
+            continue;
+        }
+        if (http_recurso_montar(r, livre)) r->atual = livre;
+    }
+    ++stats.atualizacoes;
+}
+
+void http_conexao_iniciar(http_conexao_t *c) {
+    memset(c, 0, sizeof(*c));
+    c->na_primeira_linha = true;
+}
+
+// Resposta para a linha de requisição guardada
+static http_resposta_t http_responder(http_conexao_t *c) {
+    ++stats.requisicoes;
+    if (strncmp(c->linha, "HTTP/1.0", 8) == 0 || strstr(c->linha, " HTTP/1.0")) c->fechar = true;
+
+    int recurso = -1;
+    if (strncmp(c->linha, "GET /data.json ", 15) == 0) recurso = RECURSO_JSON;
+    else if (strncmp(c->linha, "GET /metrics ", 13) == 0) recurso = RECURSO_METRICAS;
+
+    if (recurso < 0) {
+        ++stats.nao_encontrado;
+        stats.bytes += sizeof(resposta_404) - 1;
+        return (http_resposta_t){resposta_404, sizeof(resposta_404) - 1, HTTP_SEM_BUFFER};
+    }
+    http_recurso_t *r = &recursos[recurso];
+    if (!r->dados[r->atual]) {
+        stats.bytes += sizeof(resposta_503) - 1;  // Nada publicado ainda
+        return (http_resposta_t){resposta_503, sizeof(resposta_503) - 1, HTTP_SEM_BUFFER};
+    }
+    uint8_t buffer = (uint8_t)(recurso * 2 + r->atual);
+    ++retencoes[buffer];
+    stats.bytes += r->tamanho[r->atual];
+    return (http_resposta_t){r->dados[r->atual], r->tamanho[r->atual], buffer};
+}
+
+size_t http_conexao_receber(http_conexao_t *c, const uint8_t *dados, size_t tamanho,
+                            http_resposta_t *resposta, bool *pronta) {
+    *pronta = false;
+    for (size_t i = 0; i < tamanho; ++i) {
+        char ch = (char)dados[i];
+        if (ch == '\r') continue;
+        if (ch != '\n') {
+            if (c->na_primeira_linha) {
+                if (c->linha_tamanho < HTTP_LINHA_MAX - 1) c->linha[c->linha_tamanho++] = ch;
+            } else {
+                if (c->linha_atual < sizeof(c->cabecalho) - 1) {
+                    c->cabecalho[c->linha_atual] = (char)tolower((unsigned char)ch);
+                }
+                if (c->linha_atual < 255) ++c->linha_atual;
+            }
+            continue;
+        }
+
+        // Fim de uma linha
+        if (c->na_primeira_linha) {
+            c->linha[c->linha_tamanho] = '\0';
+            c->na_primeira_linha = c->linha_tamanho == 0;  // Ignora linhas vazias antes da requisição
+            continue;
+        }
+        if (c->linha_atual == 0) {
+            // Linha vazia: fim da requisição (GET, sem corpo)
+            *resposta = http_responder(c);
+            *pronta = true;
+            bool fechar = c->fechar;
+            http_conexao_iniciar(c);
+            c->fechar = fechar;
+            return i + 1;
+        }
+        c->cabecalho[c->linha_atual < sizeof(c->cabecalho) ? c->linha_atual : sizeof(c->cabecalho) - 1] = '\0';
+        if (strncmp(c->cabecalho, "connection: close", 17) == 0) c->fechar = true;
+        c->linha_atual = 0;
+    }
+    return tamanho;
+}
+
+void http_servidor_liberar(uint8_t buffer) {
+    if (buffer == HTTP_SEM_BUFFER) return;
+    if (retencoes[buffer]) --retencoes[buffer];
+    // Uma publicação adiada usa o buffer assim que ele fica livre
+    if (publicacao_pendente && !retencoes[buffer]) {
+        publicacao_pendente = false;
+        http_servidor_publicar();
+    }
+}
+
+void http_servidor_contar_conexao(bool aceita) {
+    if (aceita) ++stats.conexoes;
+    else ++stats.recusadas;
+}
+
+const http_servidor_stats_t *http_servidor_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,89 @@
+// http_servidor.h
+// Servidor HTTP local com as leituras em JSON (/data.json) e métricas no
+// formato do Prometheus (/metrics).
+//
+// As respostas completas (cabeçalho + corpo) ficam pré-formatadas em buffers
+// estáticos e só são refeitas quando o laço principal publica uma leitura
+// nova. Cada requisição apenas aponta para o buffer atual, que é enviado sem
+// cópia e sem alocação. Cada recurso tem dois buffers: um novo conteúdo vai
+// para o buffer livre, enquanto conexões ainda podem estar enviando o outro.
+//
+// Este núcleo não depende do lwIP: http_servidor_lwip.c liga-o a conexões TCP
+// na placa e tools/http_host/ a sockets do Linux, para comparação.
+#ifndef HTTP_SERVIDOR_H
+#define HTTP_SERVIDOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if MODO_FROTA                      // Uma linha por vaso (até FROTA_MAX)
+#define HTTP_JSON_MAX 5120
+#define HTTP_METRICAS_MAX 13312
+#else
+#define HTTP_JSON_MAX 512           // Resposta completa de /data.json
+#define HTTP_METRICAS_MAX 7168      // Resposta completa de /metrics (com os pools do lwIP)
+#endif
+#define HTTP_CABECALHO_MAX 128      // Espaço reservado antes do corpo para o cabeçalho
+#define HTTP_LINHA_MAX 96           // Linha de requisição guardada (o restante é ignorado)
+#define HTTP_SEM_BUFFER 0xFF        // Resposta constante, que não precisa ser retida
+
+// Escreve o corpo de um recurso em `destino` e retorna o tamanho (0 em erro)
+typedef size_t (*http_gerador_fn)(char *destino, size_t tamanho);
+
+// Resposta pronta para envio; `buffer` deve ser liberado quando o envio terminar
+typedef struct {
+    const char *dados;
+    uint16_t tamanho;
+    uint8_t buffer;
+} http_resposta_t;
+
+// Estado de leitura de uma conexão (uma requisição de cada vez, com keep-alive)
+typedef struct {
+    char linha[HTTP_LINHA_MAX];     // Linha de requisição
+    uint8_t linha_tamanho;
+    uint8_t linha_atual;            // Bytes da linha de cabeçalho atual
+    bool na_primeira_linha;
+    bool fechar;                    // HTTP/1.0 ou "Connection: close"
+    char cabecalho[24];             // Início da linha de cabeçalho atual
+} http_conexao_t;
+
+typedef struct {
+    uint32_t conexoes;
+    uint32_t recusadas;             // Conexões recusadas sem espaço livre
+    uint32_t requisicoes;
+    uint32_t nao_encontrado;        // Respostas 404
+    uint32_t bytes;                 // Bytes de resposta entregues ao transporte
+    uint32_t atualizacoes;          // Vezes em que as respostas foram refeitas
+    uint32_t atualizacoes_adiadas;  // Publicações sem buffer livre (refeitas na próxima)
+} http_servidor_stats_t;
+
+void http_servidor_init(http_gerador_fn json, http_gerador_fn metricas);
+
+// Refaz as respostas com o estado atual. Chamar quando a leitura mudar.
+void http_servidor_publicar(void);
+
+void http_conexao_iniciar(http_conexao_t *conexao);
+
+// Processa bytes recebidos até o fim de uma requisição, quando grava a resposta
+// (retendo seu buffer) e marca `pronta`. Retorna quantos bytes foram consumidos;
+// o restante pertence às próximas requisições (pipelining).
+size_t http_conexao_receber(http_conexao_t *conexao, const uint8_t *dados, size_t tamanho,
+                            http_resposta_t *resposta, bool *pronta);
+
+// Libera um buffer retido por uma resposta já enviada (e confirmada pelo TCP)
+void http_servidor_liberar(uint8_t buffer);
+
+// Contagem de conexões feita pelo transporte
+void http_servidor_contar_conexao(bool aceita);
+
+const http_servidor_stats_t *http_servidor_stats(void);
+
+// Transporte na placa (http_servidor_lwip.c): escuta em `porta` com um conjunto
+// fixo de conexões. Retorna false se não foi possível escutar.
+#define HTTP_CONEXOES 4             // Conexões simultâneas (as excedentes são recusadas)
+#define HTTP_EM_VOO 4               // Respostas aguardando confirmação por conexão
+#define HTTP_OCIOSA_S 10            // Fecha conexões sem requisições por este tempo
+bool http_servidor_lwip_init(uint16_t porta);
+
+#endif
@@ -0,0 +1,202 @@
+// http_servidor_lwip.c
+// Liga o núcleo do servidor HTTP (http_servidor.c) a conexões TCP do lwIP.
+//
+// As respostas são escritas com tcp_write() sem TCP_WRITE_FLAG_COPY: o lwIP
+// apenas referencia o buffer pré-formatado, que fica retido até o cliente
+// confirmar (ACK) todos os seus bytes. As conexões vêm de um conjunto estático,
+// sem alocação por requisição além dos próprios segmentos do lwIP.
+#include <string.h>
+
+#include "pico/cyw43_arch.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+
+#include "http_servidor.h"
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    http_conexao_t leitor;
+
+    // Respostas em ordem; as `escritas` primeiras já estão inteiras na conexão
+    http_resposta_t fila[HTTP_EM_VOO];
+    uint16_t sem_ack[HTTP_EM_VOO];  // Bytes de cada resposta ainda sem confirmação
+    uint8_t inicio, quantidade, escritas;
+    uint16_t parcial;               // Bytes já escritos da próxima resposta
+
+    struct pbuf *pendente;          // Requisições recebidas com a fila cheia
+    uint16_t pendente_lido;
+    uint8_t ociosa;                 // Chamadas de tcp_poll sem atividade
+} http_lwip_conexao_t;
+
+static http_lwip_conexao_t conexoes[HTTP_CONEXOES];
+static struct tcp_pcb *escuta;
+
+static void http_lwip_liberar(http_lwip_conexao_t *c) {
+    while (c->quantidade) {
+        http_servidor_liberar(c->fila[c->inicio].buffer);
+        c->inicio = (c->inicio + 1) % HTTP_EM_VOO;
+        --c->quantidade;
+    }
+    if (c->pendente) {
+        pbuf_free(c->pendente);
+        c->pendente = NULL;
+    }
+    c->pcb = NULL;
+}
+
+// Fecha a conexão; retorna ERR_ABRT se o pcb precisou ser abortado
+static err_t http_lwip_fechar(http_lwip_conexao_t *c) {
+    err_t err = ERR_OK;
+    struct tcp_pcb *pcb = c->pcb;
+    if (!pcb) return ERR_OK;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    // Só se fecha sem respostas em voo (ou abortando), então os buffers podem ser liberados
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        err = ERR_ABRT;
+    }
+    http_lwip_liberar(c);
+    return err;
+}
+
+// Escreve o quanto couber das respostas ainda não escritas, sem copiar
+static void http_lwip_escrever(http_lwip_conexao_t *c) {
+    bool escreveu = false;
+    while (c->escritas < c->quantidade) {
+        const http_resposta_t *r = &c->fila[(c->inicio + c->escritas) % HTTP_EM_VOO];
+        uint16_t restante = r->tamanho - c->parcial;
+        uint16_t espaco = tcp_sndbuf(c->pcb);
+        if (espaco == 0) break;
+        uint16_t n = restante < espaco ? restante : espaco;
+        bool mais = n < restante || c->escritas + 1 < c->quantidade;
+        if (tcp_write(c->pcb, r->dados + c->parcial, n, mais ? TCP_WRITE_FLAG_MORE : 0) != ERR_OK) break;
+        escreveu = true;
+        c->parcial += n;
+        if (c->parcial < r->tamanho) break;  // Continua quando houver espaço (callback de envio)
+        c->parcial = 0;
+        ++c->escritas;
+    }
+    if (escreveu) tcp_output(c->pcb);
+}
+
+// Lê requisições até encher a fila; o que sobrar fica guardado para depois
+static err_t http_lwip_processar(http_lwip_conexao_t *c) {
+    while (c->pendente && c->quantidade < HTTP_EM_VOO && !c->leitor.fechar) {
+        struct pbuf *p = c->pendente;
+        bool pronta;
+        uint8_t i = (c->inicio + c->quantidade) % HTTP_EM_VOO;
+        size_t lidos = http_conexao_receber(&c->leitor, (const uint8_t *)p->payload + c->pendente_lido,
+                                            p->len - c->pendente_lido, &c->fila[i], &pronta);
+        c->pendente_lido += (uint16_t)lidos;
+        tcp_recved(c->pcb, (u16_t)lidos);
+        if (pronta) {
+            c->sem_ack[i] = c->fila[i].tamanho;
+            ++c->quantidade;
+        }
+        if (c->pendente_lido == p->len) {
+            c->pendente = p->next;
+            if (p->next) pbuf_ref(p->next);
+            pbuf_free(p);
+            c->pendente_lido = 0;
+        }
+    }
+    // Depois de "Connection: close" o restante é descartado
+    if (c->leitor.fechar && c->pendente) {
+        tcp_recved(c->pcb, (u16_t)(c->pendente->tot_len - c->pendente_lido));
+        pbuf_free(c->pendente);
+        c->pendente = NULL;
+    }
+    http_lwip_escrever(c);
+    if (c->leitor.fechar && c->quantidade == 0) return http_lwip_fechar(c);
+    return ERR_OK;
+}
+
+static err_t http_lwip_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    http_lwip_conexao_t *c = arg;
+    // Confirma as respostas na ordem em que foram escritas
+    while (len && c->quantidade) {
+        uint16_t n = c->sem_ack[c->inicio] < len ? c->sem_ack[c->inicio] : len;
+        c->sem_ack[c->inicio] -= n;
+        len -= n;
+        if (c->sem_ack[c->inicio]) break;
+        http_servidor_liberar(c->fila[c->inicio].buffer);
+        c->inicio = (c->inicio + 1) % HTTP_EM_VOO;
+        --c->quantidade;
+        --c->escritas;
+    }
+    (void)tpcb;
+    return http_lwip_processar(c);
+}
+
+static err_t http_lwip_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    http_lwip_conexao_t *c = arg;
+    (void)tpcb;
+    if (!p || err != ERR_OK) {
+        // O cliente fechou o envio: termina de entregar as respostas em voo e fecha
+        if (p) pbuf_free(p);
+        c->leitor.fechar = true;
+        return http_lwip_processar(c);
+    }
+    c->ociosa = 0;
+    if (c->pendente) pbuf_cat(c->pendente, p);
+    else c->pendente = p;
+    return http_lwip_processar(c);
+}
+
+static void http_lwip_err(void *arg, err_t err) {
+    (void)err;
+    http_lwip_liberar(arg);  // O pcb já foi liberado pelo lwIP
+}
+
+// Chamado a cada segundo: fecha conexões ociosas para liberar o espaço
+static err_t http_lwip_poll(void *arg, struct tcp_pcb *tpcb) {
+    http_lwip_conexao_t *c = arg;
+    (void)tpcb;
+    if (c->quantidade == 0 && ++c->ociosa >= HTTP_OCIOSA_S) return http_lwip_fechar(c);
+    return ERR_OK;
+}
+
+static err_t http_lwip_accept(void *arg, struct tcp_pcb *novo, err_t err) {
+    (void)arg;
+    if (err != ERR_OK || !novo) return ERR_VAL;
+
+    http_lwip_conexao_t *c = NULL;
+    for (uint i = 0; i < HTTP_CONEXOES && !c; ++i) {
+        if (!conexoes[i].pcb) c = &conexoes[i];
+    }
+    if (!c) {
+        http_servidor_contar_conexao(false);
+        tcp_abort(novo);
+        return ERR_ABRT;
+    }
+    http_servidor_contar_conexao(true);
+
+    memset(c, 0, sizeof(*c));
+    c->pcb = novo;
+    http_conexao_iniciar(&c->leitor);
+    tcp_nagle_disable(novo);  // Cada resposta sai inteira; não há o que agrupar
+    tcp_arg(novo, c);
+    tcp_recv(novo, http_lwip_recv);
+    tcp_sent(novo, http_lwip_sent);
+    tcp_err(novo, http_lwip_err);
+    tcp_poll(novo, http_lwip_poll, 2);
+    return ERR_OK;
+}
+
+bool http_servidor_lwip_init(uint16_t porta) {
+    cyw43_arch_lwip_begin();
+    struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+    if (pcb && tcp_bind(pcb, IP_ANY_TYPE, porta) == ERR_OK) {
+        escuta = tcp_listen_with_backlog(pcb, HTTP_CONEXOES);
+        if (escuta) tcp_accept(escuta, http_lwip_accept);
+        else tcp_abort(pcb);
+    } else if (pcb) {
+        tcp_abort(pcb);
+    }
+    cyw43_arch_lwip_end();
+    return escuta != NULL;
+}
@@ -0,0 +1,66 @@
+// ------------------------------------------------------------ //
+// Arquivo gerado por tools/img2page.py; nao edite manualmente! //
+// ------------------------------------------------------------ //
+
+#ifndef _inc_icons_h
+#define _inc_icons_h
+
+#include "ssd1306.h"
+
+// gota.bmp: 16x16, 28 bytes (RLE, 32 sem compressao)
+static const uint8_t icon_gota_data[] = {
+    0x82, 0x00, 0x08, 0x80, 0xC0, 0xF0, 0xFC, 0xFF, 0xFC, 0xF0, 0xC0, 0x80,
+    0x85, 0x00, 0x0A, 0x0E, 0x3F, 0x3F, 0x78, 0x77, 0x6F, 0x7F, 0x7F, 0x3F,
+    0x3F, 0x0E, 0x82, 0x00,
+};
+static const ssd1306_image_t icon_gota = {16, 16, SSD1306_IMG_RLE, sizeof(icon_gota_data), icon_gota_data};
+
+// lua.bmp: 16x16, 28 bytes (RLE, 32 sem compressao)
+static const uint8_t icon_lua_data[] = {
+    0x08, 0xC0, 0xF0, 0xF8, 0xFC, 0x3C, 0x0E, 0x06, 0x02, 0x02, 0x86, 0x00,
+    0x05, 0x03, 0x0F, 0x1F, 0x3F, 0x3C, 0x78, 0x83, 0x70, 0x05, 0x30, 0x38,
+    0x1C, 0x0E, 0x00, 0x00,
+};
+static const ssd1306_image_t icon_lua = {16, 16, SSD1306_IMG_RLE, sizeof(icon_lua_data), icon_lua_data};
+
+// planta_feliz.bmp: 16x16, 27 bytes (RLE, 32 sem compressao)
+static const uint8_t icon_planta_feliz_data[] = {
+    0x84, 0x00, 0x07, 0x04, 0x0E, 0xFE, 0x44, 0x28, 0x1C, 0x1C, 0x08, 0x84,
+    0x00, 0x03, 0x0F, 0x31, 0xC1, 0x95, 0x83, 0xA1, 0x05, 0x95, 0xC1, 0x31,
+    0x0F, 0x00, 0x00,
+};
+static const ssd1306_image_t icon_planta_feliz = {16, 16, SSD1306_IMG_RLE, sizeof(icon_planta_feliz_data), icon_planta_feliz_data};
+
+// planta_triste.bmp: 16x16, 30 bytes (RLE, 32 sem compressao)
+static const uint8_t icon_planta_triste_data[] = {
+    0x0C, 0x00, 0x10, 0x38, 0x38, 0x50, 0x80, 0x00, 0xFC, 0x80, 0x60, 0x30,
+    0x30, 0x20, 0x84, 0x00, 0x03, 0x0F, 0x31, 0xC1, 0xA5, 0x83, 0x91, 0x05,
+    0xA5, 0xC1, 0x31, 0x0F, 0x00, 0x00,
+};
+static const ssd1306_image_t icon_planta_triste = {16, 16, SSD1306_IMG_RLE, sizeof(icon_planta_triste_data), icon_planta_triste_data};
+
+// sol.bmp: 16x16, 32 bytes
+static const uint8_t icon_sol_data[] = {
+    0xC0, 0xC0, 0x0C, 0x0C, 0xE0, 0xF0, 0xF8, 0xFB, 0xFB, 0xF8, 0xF0, 0xE0,
+    0x0C, 0x0C, 0xC0, 0xC0, 0x00, 0x00, 0x0C, 0x0C, 0x01, 0x03, 0x07, 0x37,
+    0x37, 0x07, 0x03, 0x01, 0x0C, 0x0C, 0x00, 0x00,
+};
+static const ssd1306_image_t icon_sol = {16, 16, 0, sizeof(icon_sol_data), icon_sol_data};
+
+// wifi_off.bmp: 16x16, 31 bytes (RLE, 32 sem compressao)
+static const uint8_t icon_wifi_off_data[] = {
+    0x0F, 0x20, 0x34, 0x0C, 0x98, 0xF4, 0x64, 0xC4, 0xA4, 0x24, 0x24, 0x44,
+    0xC8, 0x88, 0x18, 0x30, 0x20, 0x84, 0x00, 0x0A, 0x02, 0x03, 0x19, 0x1B,
+    0x07, 0x06, 0x08, 0x18, 0x30, 0x20, 0x00,
+};
+static const ssd1306_image_t icon_wifi_off = {16, 16, SSD1306_IMG_RLE, sizeof(icon_wifi_off_data), icon_wifi_off_data};
+
+// wifi_on.bmp: 16x16, 27 bytes (RLE, 32 sem compressao)
+static const uint8_t icon_wifi_on_data[] = {
+    0x05, 0x20, 0x30, 0x18, 0x88, 0xCC, 0x64, 0x83, 0x24, 0x05, 0x64, 0xCC,
+    0x88, 0x18, 0x30, 0x20, 0x84, 0x00, 0x05, 0x02, 0x03, 0x19, 0x19, 0x03,
+    0x02, 0x84, 0x00,
+};
+static const ssd1306_image_t icon_wifi_on = {16, 16, SSD1306_IMG_RLE, sizeof(icon_wifi_on_data), icon_wifi_on_data};
+
+#endif
@@ -0,0 +1,100 @@
+// irrigacao.c
+// Implementação do controle automático da irrigação (ver irrigacao.h).
+#include <string.h>
+
+#include "irrigacao.h"
+
+static const char *const nomes[IRRIGACAO_ESTADOS] = {
+    [IRRIGACAO_OCIOSA] = "ociosa",   [IRRIGACAO_PULSO] = "pulso", [IRRIGACAO_MOLHO] = "molho",
+    [IRRIGACAO_MANUAL] = "manual",   [IRRIGACAO_PAUSA] = "pausa", [IRRIGACAO_BLOQUEADA] = "bloqueada",
+};
+
+void irrigacao_init(irrigacao_t *c, const irrigacao_config_t *config, uint32_t agora_ms) {
+    memset(c, 0, sizeof(*c));
+    c->config = config;
+    c->estado_desde_ms = agora_ms;
+    c->ultimo_passo_ms = agora_ms;
+}
+
+bool irrigacao_ligada(const irrigacao_t *c) {
+    return c->estado == IRRIGACAO_PULSO || c->estado == IRRIGACAO_MANUAL;
+}
+
+const char *irrigacao_nome(irrigacao_estado_t estado) {
+    return estado < IRRIGACAO_ESTADOS ? nomes[estado] : "?";
+}
+
+static void irrigacao_entrar(irrigacao_t *c, irrigacao_estado_t estado, uint32_t agora_ms) {
+    if (irrigacao_ligada(c) && estado != IRRIGACAO_PULSO && estado != IRRIGACAO_MANUAL) {
+        c->desligou_ms = agora_ms;
+        c->houve_ciclo = true;
+    }
+    if (estado == IRRIGACAO_PULSO) ++c->stats.pulsos;
+    c->estado = estado;
+    c->estado_desde_ms = agora_ms;
+}
+
+bool irrigacao_passo(irrigacao_t *c, int16_t umidade_pdm, uint32_t idade_ms, irrigacao_comando_t comando,
+                     uint32_t agora_ms) {
+    const irrigacao_config_t *cfg = c->config;
+    uint32_t passo_ms = agora_ms - c->ultimo_passo_ms;
+    c->ultimo_passo_ms = agora_ms;
+    if (irrigacao_ligada(c)) {
+        c->ciclo_ligada_ms += passo_ms;
+        c->stats.ligada_ms += passo_ms;
+    }
+    bool valida = idade_ms <= cfg->validade_ms;
+    uint32_t no_estado_ms = agora_ms - c->estado_desde_ms;
+
+    // Os botões passam por cima de qualquer estado, inclusive do bloqueio
+    if (comando == IRRIGACAO_LIGAR && c->estado != IRRIGACAO_MANUAL) {
+        ++c->stats.manuais;
+        c->ciclo_ligada_ms = 0;
+        irrigacao_entrar(c, IRRIGACAO_MANUAL, agora_ms);
+        return true;
+    }
+    if (comando == IRRIGACAO_DESLIGAR) {
+        irrigacao_entrar(c, IRRIGACAO_PAUSA, agora_ms);  // Um novo toque reinicia a pausa
+        return false;
+    }
+
+    switch (c->estado) {
+    case IRRIGACAO_OCIOSA:
+        if (valida && umidade_pdm < cfg->liga_pdm &&
+            (!c->houve_ciclo || agora_ms - c->desligou_ms >= cfg->desligado_min_ms)) {
+            ++c->stats.ciclos;
+            c->ciclo_ligada_ms = 0;
+            irrigacao_entrar(c, IRRIGACAO_PULSO, agora_ms);
+        }
+        break;
+    case IRRIGACAO_PULSO:
+        if (!valida || umidade_pdm >= cfg->desliga_pdm) {
+            irrigacao_entrar(c, IRRIGACAO_OCIOSA, agora_ms);
+        } else if (c->ciclo_ligada_ms >= cfg->ciclo_max_ms) {
+            ++c->stats.bloqueios;
+            irrigacao_entrar(c, IRRIGACAO_BLOQUEADA, agora_ms);
+        } else if (no_estado_ms >= cfg->pulso_ms) {
+            irrigacao_entrar(c, IRRIGACAO_MOLHO, agora_ms);
+        }
+        break;
+    case IRRIGACAO_MOLHO:
+        if (valida && umidade_pdm >= cfg->desliga_pdm) {
+            irrigacao_entrar(c, IRRIGACAO_OCIOSA, agora_ms);  // A água que infiltrou bastou
+        } else if (no_estado_ms >= cfg->molho_ms && valida) {
+            irrigacao_entrar(c, IRRIGACAO_PULSO, agora_ms);
+        }
+        break;
+    case IRRIGACAO_MANUAL:
+        if (c->ciclo_ligada_ms >= cfg->ciclo_max_ms) irrigacao_entrar(c, IRRIGACAO_OCIOSA, agora_ms);
+        break;
+    case IRRIGACAO_PAUSA:
+        if (no_estado_ms >= cfg->pausa_ms) irrigacao_entrar(c, IRRIGACAO_OCIOSA, agora_ms);
+        break;
+    case IRRIGACAO_BLOQUEADA:
+        if (no_estado_ms >= cfg->bloqueio_ms) irrigacao_entrar(c, IRRIGACAO_OCIOSA, agora_ms);
+        break;
+    default:
+        break;
+    }
+    return irrigacao_ligada(c);
+}
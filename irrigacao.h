@@ -0,0 +1,86 @@
+// irrigacao.h
+// Controle automático da irrigação em malha fechada sobre a umidade calibrada
+// do solo (décimos de %), com histerese e ciclos de pulso e molho.
+//
+// Um ciclo começa quando a umidade cai abaixo de `liga_pdm` e termina quando
+// ela chega a `desliga_pdm`. A água é dada em pulsos de `pulso_ms` separados
+// por `molho_ms` sem água, para que ela infiltre até o sensor antes da próxima
+// decisão (sem isso o solo encharca em cima e o sensor ainda lê seco). Travas:
+// um ciclo não passa de `ciclo_max_ms` de relé ligado (sensor solto ou sem
+// água na bomba); se passar, a irrigação fica bloqueada por `bloqueio_ms`.
+// Entre o fim de um ciclo e o começo do outro há pelo menos `desligado_min_ms`.
+// Uma leitura mais velha que `validade_ms` não liga nem mantém a água ligada.
+//
+// Os botões são comandos manuais que passam por cima do automático: ligar
+// irriga até desligar (ou até `ciclo_max_ms`), e desligar pausa o automático
+// por `pausa_ms`.
+//
+// Sem dependências do SDK: o firmware chama irrigacao_passo() de um
+// temporizador de hardware em ritmo fixo, e tools/irrigacao_sim.c chama o
+// mesmo código contra um modelo do solo.
+#ifndef IRRIGACAO_H
+#define IRRIGACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    IRRIGACAO_OCIOSA = 0,   // Desligada, esperando o solo secar
+    IRRIGACAO_PULSO,        // Relé ligado num pulso do ciclo
+    IRRIGACAO_MOLHO,        // Entre pulsos, esperando a água infiltrar
+    IRRIGACAO_MANUAL,       // Ligada pelo botão
+    IRRIGACAO_PAUSA,        // Desligada pelo botão, automático suspenso
+    IRRIGACAO_BLOQUEADA,    // Ciclo passou de ciclo_max_ms sem molhar o solo
+    IRRIGACAO_ESTADOS,
+} irrigacao_estado_t;
+
+typedef enum {
+    IRRIGACAO_NENHUM = 0,
+    IRRIGACAO_LIGAR,        // Botão A
+    IRRIGACAO_DESLIGAR,     // Botão B
+} irrigacao_comando_t;
+
+typedef struct {
+    int16_t liga_pdm;           // Começa um ciclo abaixo desta umidade
+    int16_t desliga_pdm;        // Termina o ciclo a partir desta umidade
+    uint32_t pulso_ms;
+    uint32_t molho_ms;
+    uint32_t ciclo_max_ms;      // Máximo de relé ligado num ciclo (e no modo manual)
+    uint32_t desligado_min_ms;  // Mínimo entre o fim de um ciclo e o começo do próximo
+    uint32_t pausa_ms;          // Automático suspenso depois do botão de desligar
+    uint32_t bloqueio_ms;       // Duração do bloqueio pela trava de tempo ligado
+    uint32_t validade_ms;       // Idade máxima da leitura de umidade
+} irrigacao_config_t;
+
+typedef struct {
+    uint32_t ciclos;
+    uint32_t pulsos;
+    uint32_t manuais;
+    uint32_t bloqueios;
+    uint32_t ligada_ms;         // Tempo total de relé ligado
+} irrigacao_stats_t;
+
+typedef struct {
+    const irrigacao_config_t *config;
+    irrigacao_estado_t estado;
+    uint32_t estado_desde_ms;
+    uint32_t ciclo_ligada_ms;   // Relé ligado no ciclo (ou na irrigação manual) atual
+    uint32_t desligou_ms;       // Fim do último ciclo
+    bool houve_ciclo;
+    uint32_t ultimo_passo_ms;
+    irrigacao_stats_t stats;
+} irrigacao_t;
+
+void irrigacao_init(irrigacao_t *c, const irrigacao_config_t *config, uint32_t agora_ms);
+
+// Um passo do controlador, com a umidade calibrada (décimos de %), a idade da
+// leitura e o comando dos botões. Retorna se o relé deve ficar ligado.
+bool irrigacao_passo(irrigacao_t *c, int16_t umidade_pdm, uint32_t idade_ms, irrigacao_comando_t comando,
+                     uint32_t agora_ms);
+
+bool irrigacao_ligada(const irrigacao_t *c);
+
+// Nome do estado para o display e as métricas ("pulso", "molho"...)
+const char *irrigacao_nome(irrigacao_estado_t estado);
+
+#endif
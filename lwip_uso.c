@@ -0,0 +1,73 @@
+// lwip_uso.c
+// Implementação das estatísticas de memória do lwIP (ver lwip_uso.h).
+#include <stdio.h>
+
+#include "lwip/opt.h"
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/stats.h"
+
+#include "lwip_uso.h"
+
+// Nomes dos pools na ordem de memp_t (os do lwIP só existem com LWIP_DEBUG)
+static const char *const nomes[MEMP_MAX] = {
+#define LWIP_MEMPOOL(nome, quantidade, tamanho, descricao) #nome,
+#include "lwip/priv/memp_std.h"
+};
+
+static uint16_t picos_vistos[MEMP_MAX];
+static uint16_t heap_pico_visto;
+
+lwip_uso_ram_t lwip_uso_ram(void) {
+    lwip_uso_ram_t ram = {.heap = LWIP_MEM_ALIGN_SIZE(MEM_SIZE), .pools = 0};
+    for (int i = 0; i < MEMP_MAX; ++i) {
+        ram.pools += (uint32_t)memp_pools[i]->num * (MEMP_SIZE + memp_pools[i]->size);
+    }
+    return ram;
+}
+
+void lwip_uso_imprimir(void) {
+    lwip_uso_ram_t ram = lwip_uso_ram();
+    printf("lwIP: %lu bytes de RAM (heap %lu, pools %lu)\n", (unsigned long)(ram.heap + ram.pools),
+           (unsigned long)ram.heap, (unsigned long)ram.pools);
+    for (int i = 0; i < MEMP_MAX; ++i) {
+        printf("  %-16s %3u x %4u bytes\n", nomes[i], memp_pools[i]->num, memp_pools[i]->size);
+    }
+}
+
+void lwip_uso_poll(void) {
+    for (int i = 0; i < MEMP_MAX; ++i) {
+        const struct stats_mem *s = lwip_stats.memp[i];
+        if (!s || s->max <= picos_vistos[i]) continue;
+        picos_vistos[i] = s->max;
+        printf("lwIP: pico de %s em %u de %u (falhas %u)\n", nomes[i], s->max, s->avail, (unsigned)s->err);
+    }
+    if (lwip_stats.mem.max > heap_pico_visto) {
+        heap_pico_visto = lwip_stats.mem.max;
+        printf("lwIP: pico do heap em %u de %u bytes (falhas %u)\n", lwip_stats.mem.max,
+               lwip_stats.mem.avail, (unsigned)lwip_stats.mem.err);
+    }
+}
+
+size_t lwip_uso_metricas(char *destino, size_t tamanho) {
+    lwip_uso_ram_t ram = lwip_uso_ram();
+    const struct stats_proto *link = &lwip_stats.link;
+    int n = snprintf(destino, tamanho,
+        "vaso_lwip_ram_bytes %lu\nvaso_lwip_heap_bytes %u\nvaso_lwip_heap_usado_bytes %u\n"
+        "vaso_lwip_heap_pico_bytes %u\nvaso_lwip_heap_falhas_total %u\n"
+        "vaso_lwip_quadros_recebidos_total %u\nvaso_lwip_quadros_enviados_total %u\n"
+        "vaso_lwip_quadros_descartados_total %u\n",
+        (unsigned long)(ram.heap + ram.pools), lwip_stats.mem.avail, lwip_stats.mem.used,
+        lwip_stats.mem.max, (unsigned)lwip_stats.mem.err, (unsigned)link->recv, (unsigned)link->xmit,
+        (unsigned)link->drop);
+    for (int i = 0; i < MEMP_MAX && n > 0 && (size_t)n < tamanho; ++i) {
+        const struct stats_mem *s = lwip_stats.memp[i];
+        if (!s) continue;
+        int m = snprintf(destino + n, tamanho - n,
+                         "vaso_lwip_pool_tamanho{pool=\"%s\"} %u\nvaso_lwip_pool_pico{pool=\"%s\"} %u\n"
+                         "vaso_lwip_pool_falhas_total{pool=\"%s\"} %u\n",
+                         nomes[i], s->avail, nomes[i], s->max, nomes[i], (unsigned)s->err);
+        n = m > 0 ? n + m : 0;
+    }
+    return n > 0 && (size_t)n < tamanho ? (size_t)n : 0;
+}
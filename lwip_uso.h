@@ -0,0 +1,31 @@
+// lwip_uso.h
+// Uso de memória do lwIP em tempo de execução, a partir dos contadores do
+// próprio lwIP (LWIP_STATS em lwipopts.h): heap, cada pool de tamanho fixo
+// (PCBs, segmentos TCP, pbufs recebidos...) e quadros da interface.
+//
+// Para dimensionar lwipopts.h pelo uso medido: o pico de cada pool sai no
+// monitor serial quando sobe e em /metrics junto com o tamanho e as falhas
+// de alocação (que indicam um pool pequeno demais).
+#ifndef LWIP_USO_H
+#define LWIP_USO_H
+
+#include "pico/stdlib.h"
+
+// Memória reservada pelo lwIP conforme lwipopts.h: heap e pools
+typedef struct {
+    uint32_t heap;
+    uint32_t pools;
+} lwip_uso_ram_t;
+
+lwip_uso_ram_t lwip_uso_ram(void);
+
+// Imprime a memória reservada e o tamanho de cada pool (chamar com o lwIP iniciado)
+void lwip_uso_imprimir(void);
+
+// Imprime os picos que subiram desde a última chamada. Chamar no laço principal.
+void lwip_uso_poll(void);
+
+// Acrescenta as métricas do lwIP no formato de texto do Prometheus; retorna o tamanho (0 em erro)
+size_t lwip_uso_metricas(char *destino, size_t tamanho);
+
+#endif
@@ -19,26 +19,35 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
+#define TCP_MSS                     1460
+
+// Memória do lwIP: os valores dos exemplos da Pico W. Reduzir só a partir dos
+// picos medidos na placa, que aparecem no monitor serial e em /metrics (ver lwip_uso.c).
 #define MEM_SIZE                    4000
+#define PBUF_POOL_SIZE              24
 #define MEMP_NUM_TCP_SEG            32
 #define MEMP_NUM_ARP_QUEUE          10
-#define PBUF_POOL_SIZE              24
+#define TCP_WND                     (8 * TCP_MSS)
+#define TCP_SND_BUF                 (8 * TCP_MSS)
+#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#define MEMP_NUM_TCP_PCB            8      // ThingSpeak/MQTT, 4 do servidor local e TIME_WAIT
+#define MEMP_NUM_UDP_PCB            4      // DHCP, DNS, SNTP e telemetria
+#define MEMP_NUM_PBUF               24     // Referências sem cópia (ThingSpeak, HTTP, telemetria)
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 2)  // + SNTP e MQTT
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
 #define LWIP_RAW                    1
-#define TCP_WND                     (8 * TCP_MSS)
-#define TCP_MSS                     1460
-#define TCP_SND_BUF                 (8 * TCP_MSS)
-#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
-#define MEM_STATS                   0
+// Contadores de uso exportados por lwip_uso.c (picos, falhas de alocação, quadros)
+#define LWIP_STATS                  1
+#define MEM_STATS                   1
 #define SYS_STATS                   0
-#define MEMP_STATS                  0
-#define LINK_STATS                  0
+#define MEMP_STATS                  1
+#define LINK_STATS                  1
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
 #define LWIP_DHCP                   1
@@ -47,13 +56,31 @@
 #define LWIP_UDP                    1
 #define LWIP_DNS                    1
 #define LWIP_TCP_KEEPALIVE          1
-#define LWIP_NETIF_TX_SINGLE_PBUF   1
+// 0: com 1, o lwIP copia para o heap todo tcp_write(), mesmo sem TCP_WRITE_FLAG_COPY,
+// e um lote de 4 KB não cabe em MEM_SIZE. O driver do CYW43 aceita cadeias de pbufs.
+#define LWIP_NETIF_TX_SINGLE_PBUF   0
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
 
+// Cliente MQTT (ENVIO_MQTT): uma amostra são 6 publicações, uma por tópico
+#define MQTT_REQ_MAX_IN_FLIGHT      8
+#define MQTT_OUTPUT_RINGBUF_SIZE    512
+
+// Cliente SNTP (relogio.c): a hora recebida vira uma diferença sobre time_us_64(),
+// sem mexer no relógio do sistema. O tempo de ida e volta é compensado.
+#include <stdint.h>
+void relogio_sntp_definir(uint32_t segundos, uint32_t microssegundos);
+void relogio_sntp_obter(uint32_t *segundos, uint32_t *microssegundos);
+#define SNTP_SERVER_DNS             1
+#define SNTP_SET_SYSTEM_TIME_US(s, us) relogio_sntp_definir((s), (us))
+#define SNTP_GET_SYSTEM_TIME(s, us) relogio_sntp_obter(&(s), &(us))
+#define SNTP_CHECK_RESPONSE         2             // Resposta deve ecoar a nossa consulta
+#define SNTP_COMP_ROUNDTRIP         1
+#define SNTP_UPDATE_DELAY           (60 * 60 * 1000)  // Nova sincronização a cada hora
+#define SNTP_RETRY_TIMEOUT          5000          // Sem resposta (ou sem rede): dobra até 50 s
+
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1
-#define LWIP_STATS                  1
 #define LWIP_STATS_DISPLAY          1
 #endif
 
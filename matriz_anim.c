@@ -0,0 +1,99 @@
+// matriz_anim.c
+// Tabelas de sprites e animações e o temporizador que as toca.
+#include <string.h>
+#include "matriz_anim.h"
+
+static const npSprite_t np_sprites[] = {
+  [SPRITE_APAGADO]      = {0, 0, 0, 0},
+  [SPRITE_FELIZ]        = {NP_OLHOS | NP_BOCA_FELIZ, 0, 255, 0},     // Verde
+  [SPRITE_TRISTE]       = {NP_OLHOS | NP_BOCA_TRISTE, 255, 0, 0},    // Vermelho
+  [SPRITE_TRISTE_FRACO] = {NP_OLHOS | NP_BOCA_TRISTE, 64, 0, 0},     // Vermelho fraco
+  [SPRITE_GOTA]         = {NP_GOTA, 0, 64, 255},                     // Azul
+  [SPRITE_ALERTA]       = {NP_EXCLAMACAO, 255, 160, 0},              // Laranja
+};
+
+static const npKeyframe_t np_quadros_feliz[] = {{SPRITE_FELIZ, 1000, 300}};
+static const npKeyframe_t np_quadros_triste[] = {{SPRITE_TRISTE, 800, 400}, {SPRITE_TRISTE_FRACO, 800, 400}};
+static const npKeyframe_t np_quadros_irrigando[] = {{SPRITE_GOTA, 600, 150}, {SPRITE_APAGADO, 200, 150}};
+static const npKeyframe_t np_quadros_alerta[] = {{SPRITE_ALERTA, 250, 0}, {SPRITE_APAGADO, 250, 0}};
+
+const npAnimacao_t np_anim_feliz = NP_ANIMACAO(np_quadros_feliz);
+const npAnimacao_t np_anim_triste = NP_ANIMACAO(np_quadros_triste);
+const npAnimacao_t np_anim_irrigando = NP_ANIMACAO(np_quadros_irrigando);
+const npAnimacao_t np_anim_alerta = NP_ANIMACAO(np_quadros_alerta);
+
+// Estado do motor (alterado apenas pelo temporizador, exceto np_anim_pedida)
+static const npAnimacao_t *volatile np_anim_pedida = NULL;  // Animação solicitada pelo laço principal
+static const npAnimacao_t *np_anim_atual = NULL;
+static uint8_t np_anim_quadro;                  // Quadro-chave atual
+static uint32_t np_anim_decorrido_ms;           // Tempo dentro do quadro-chave atual
+static npLED_t np_anim_origem[LED_COUNT];       // Quadro exibido quando o crossfade começou
+static npLED_t np_anim_enviado[LED_COUNT];      // Último quadro enviado (detecção de mudança)
+uint32_t np_anim_envios, np_anim_ignorados;     // Estatísticas de quadros enviados/iguais
+static struct repeating_timer np_anim_timer;
+
+static inline uint8_t npMistura(uint8_t de, uint8_t para, uint32_t t, uint32_t total) {
+  return (uint8_t)(de + ((int32_t)para - de) * (int32_t)t / (int32_t)total);
+}
+
+// Calcula o quadro atual em leds[]
+static void npAnimRender(void) {
+  const npKeyframe_t *k = &np_anim_atual->quadros[np_anim_quadro];
+  const npSprite_t *s = &np_sprites[k->sprite];
+
+  for (uint i = 0; i < LED_COUNT; ++i) {
+    bool aceso = s->mascara & (1u << i);
+    npLED_t alvo = {aceso ? s->g : 0, aceso ? s->r : 0, aceso ? s->b : 0};
+
+    if (np_anim_decorrido_ms < k->fade_ms) {
+      leds[i].G = npMistura(np_anim_origem[i].G, alvo.G, np_anim_decorrido_ms, k->fade_ms);
+      leds[i].R = npMistura(np_anim_origem[i].R, alvo.R, np_anim_decorrido_ms, k->fade_ms);
+      leds[i].B = npMistura(np_anim_origem[i].B, alvo.B, np_anim_decorrido_ms, k->fade_ms);
+    } else {
+      leds[i] = alvo;
+    }
+  }
+}
+
+static bool npAnimTick(struct repeating_timer *t) {
+  // Troca de animação: o crossfade parte do que está sendo exibido
+  if (np_anim_pedida != np_anim_atual) {
+    np_anim_atual = np_anim_pedida;
+    np_anim_quadro = 0;
+    np_anim_decorrido_ms = 0;
+    memcpy(np_anim_origem, np_anim_enviado, sizeof(np_anim_origem));
+  }
+  if (!np_anim_atual) return true;
+
+  // Avança para o próximo quadro-chave quando o atual termina
+  const npKeyframe_t *k = &np_anim_atual->quadros[np_anim_quadro];
+  if (np_anim_decorrido_ms >= (uint32_t)k->fade_ms + k->duracao_ms) {
+    np_anim_quadro = (np_anim_quadro + 1) % np_anim_atual->quantidade;
+    np_anim_decorrido_ms = 0;
+    memcpy(np_anim_origem, np_anim_enviado, sizeof(np_anim_origem));
+  }
+
+  npAnimRender();
+  np_anim_decorrido_ms += NP_ANIM_PERIODO_MS;
+
+  // Só envia para a matriz se o quadro mudou
+  if (memcmp(leds, np_anim_enviado, sizeof(np_anim_enviado)) != 0) {
+    memcpy(np_anim_enviado, leds, sizeof(np_anim_enviado));
+    npWrite();
+    ++np_anim_envios;
+  } else {
+    ++np_anim_ignorados;
+  }
+  return true;
+}
+
+// Inicia o temporizador da animação (depois de npInit)
+void npAnimInit() {
+  memset(np_anim_enviado, 0, sizeof(np_anim_enviado));
+  add_repeating_timer_ms(NP_ANIM_PERIODO_MS, npAnimTick, NULL, &np_anim_timer);
+}
+
+// Solicita uma animação; pedir a mesma que já está tocando não a reinicia
+void npAnimPlay(const npAnimacao_t *animacao) {
+  np_anim_pedida = animacao;
+}
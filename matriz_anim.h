@@ -0,0 +1,72 @@
+// matriz_anim.h
+// Motor de quadros e sprites para a matriz de LEDs 5x5 (usa matriz_led.h).
+//
+// As animações são sequências de quadros-chave com transição (crossfade) e
+// são tocadas por um temporizador repetitivo, independente do laço de leitura
+// dos sensores. A cada passo o quadro calculado é comparado com o último
+// enviado e, se for idêntico, nada é transmitido para a matriz.
+#ifndef MATRIZ_ANIM_H
+#define MATRIZ_ANIM_H
+
+#include "pico/stdlib.h"
+#include "matriz_led.h"
+
+#define NP_ANIM_PERIODO_MS 20  // Passo do temporizador da animação (50 quadros/s)
+
+// Índice do LED na coordenada (x, y) da matriz, com (0, 0) no canto inferior esquerdo.
+// A fita percorre a matriz em zigue-zague: linhas pares da direita para a esquerda.
+#define NP_XY(x, y) (((y) & 1) ? (y) * 5 + (x) : (y) * 5 + (4 - (x)))
+#define NP_BIT(x, y) (1u << NP_XY(x, y))
+
+// Sprite: máscara de 25 bits (um por LED) e a cor dos LEDs acesos
+typedef struct {
+  uint32_t mascara;
+  uint8_t r, g, b;
+} npSprite_t;
+
+#define NP_OLHOS (NP_BIT(1, 4) | NP_BIT(3, 4) | NP_BIT(1, 3) | NP_BIT(3, 3))
+#define NP_BOCA_FELIZ (NP_BIT(0, 1) | NP_BIT(4, 1) | NP_BIT(1, 0) | NP_BIT(2, 0) | NP_BIT(3, 0))
+#define NP_BOCA_TRISTE (NP_BIT(0, 0) | NP_BIT(4, 0) | NP_BIT(1, 1) | NP_BIT(2, 1) | NP_BIT(3, 1))
+#define NP_GOTA (NP_BIT(2, 4) | NP_BIT(1, 3) | NP_BIT(2, 3) | NP_BIT(3, 3) | 0x1Fu << 10 | 0x1Fu << 5 | \
+                 NP_BIT(1, 0) | NP_BIT(2, 0) | NP_BIT(3, 0))
+#define NP_EXCLAMACAO (NP_BIT(2, 4) | NP_BIT(2, 3) | NP_BIT(2, 2) | NP_BIT(2, 0))
+
+// Tabela de sprites definida em tempo de compilação
+enum {
+  SPRITE_APAGADO,
+  SPRITE_FELIZ,
+  SPRITE_TRISTE,
+  SPRITE_TRISTE_FRACO,
+  SPRITE_GOTA,
+  SPRITE_ALERTA,
+};
+
+// Quadro-chave: sprite exibido por `duracao_ms`, alcançado com crossfade de `fade_ms`
+typedef struct {
+  uint8_t sprite;
+  uint16_t duracao_ms;
+  uint16_t fade_ms;
+} npKeyframe_t;
+
+typedef struct {
+  const npKeyframe_t *quadros;
+  uint8_t quantidade;
+} npAnimacao_t;   // Animações sempre repetem; um único quadro é uma imagem estática
+
+#define NP_ANIMACAO(q) {q, sizeof(q) / sizeof(q[0])}
+
+// Animações prontas (definidas em matriz_anim.c)
+extern const npAnimacao_t np_anim_feliz;
+extern const npAnimacao_t np_anim_triste;
+extern const npAnimacao_t np_anim_irrigando;
+extern const npAnimacao_t np_anim_alerta;
+
+extern uint32_t np_anim_envios, np_anim_ignorados;  // Estatísticas de quadros enviados/iguais
+
+// Inicia o temporizador da animação (depois de npInit)
+void npAnimInit();
+
+// Solicita uma animação; pedir a mesma que já está tocando não a reinicia
+void npAnimPlay(const npAnimacao_t *animacao);
+
+#endif
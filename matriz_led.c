@@ -0,0 +1,68 @@
+// matriz_led.c
+// A matriz é uma única fita de 25 LEDs: usa a neopixel_library com uma fita,
+// que cuida do DMA, do latch sem bloqueio e da tabela de brilho com gama.
+#include "matriz_led.h"
+
+npLED_t leds[LED_COUNT];
+NP np_matriz;
+
+static uint32_t np_planos[2 * NP_PLANE_WORDS(LED_COUNT)];
+
+void npInit(uint pin) {
+  np_init(&np_matriz, pio0, pin, 1, LED_COUNT, leds, np_planos);
+  npSetBrightness(64);
+}
+
+void npSetBrightness(uint8_t brilho) {
+  np_set_brightness(&np_matriz, brilho);
+}
+
+void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) {
+  np_set(&np_matriz, 0, index, r, g, b);
+}
+
+void npClear() {
+  np_clear(&np_matriz);
+}
+
+// Nunca bloqueia: se um quadro ainda estiver em transmissão, o novo é enviado
+// assim que o latch terminar.
+void npWrite() {
+  np_show(&np_matriz);
+}
+
+// Função para desenhar uma carinha feliz em verde
+void npCarinhaFeliz() {
+
+    npClear();
+
+    int happy_face_indices[] = {
+        23,18,21,16,         // Olhos
+        9,3,2,1,5            // boca (felcidade)
+    };
+
+    for (int i = 0; i < sizeof(happy_face_indices) / sizeof(happy_face_indices[0]); i++) {
+        npSetLED(happy_face_indices[i], 0, 255, 0); // Verde
+    }
+
+    npWrite();
+
+}
+
+// Função para desenhar uma carinha triste em vermelho
+void npCarinhaTriste() {
+
+  npClear();
+
+  int sad_face_indices[] = {
+      23,18,21,16,         // Olhos
+      4,8,7,6,0            // boca (tristeza)
+  };
+
+  for (int i = 0; i < sizeof(sad_face_indices) / sizeof(sad_face_indices[0]); i++) {
+      npSetLED(sad_face_indices[i], 255, 0, 0); // Vermelho
+  }
+
+  npWrite();
+
+}
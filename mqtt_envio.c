@@ -0,0 +1,208 @@
+// mqtt_envio.c
+// Implementação da publicação MQTT (ver mqtt_envio.h).
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/cyw43_arch.h"
+#include "lwip/dns.h"
+#include "lwip/apps/mqtt.h"
+
+#include "mqtt_envio.h"
+
+typedef enum {
+    MQ_DESCONECTADO,
+    MQ_RESOLVENDO,
+    MQ_CONECTANDO,
+    MQ_CONECTADO,
+} mq_estado_t;
+
+static struct {
+    const char *broker;
+    uint16_t porta;
+    uint8_t qos;
+    const char *prefixo;
+    mqtt_client_t *cliente;
+    struct mqtt_connect_client_info_t info;
+    char topico_status[MQ_TOPICO_MAX];  // Recebe "offline" do broker (last will) se a placa sumir
+
+    mq_estado_t estado;
+    uint32_t estado_desde_ms;
+    ip_addr_t ip;
+    uint32_t proxima_tentativa_ms;
+    uint32_t backoff_ms;
+
+    uint64_t enviado_us[MQ_EM_VOO];     // Instante de cada publicação aguardando confirmação (0 = livre)
+
+    mq_stats_t stats;
+} mq;
+
+static inline uint32_t agora_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+// Agenda a próxima tentativa; a espera dobra a cada falha seguida
+static void mq_agendar(bool falha) {
+    if (falha) {
+        mq.backoff_ms = mq.backoff_ms ? mq.backoff_ms * 2 : MQ_BACKOFF_MIN_MS;
+        if (mq.backoff_ms > MQ_BACKOFF_MAX_MS) mq.backoff_ms = MQ_BACKOFF_MAX_MS;
+    }
+    mq.proxima_tentativa_ms = agora_ms() + (falha ? mq.backoff_ms : 0);
+}
+
+// As publicações em voo se perdem com a conexão: o lwIP as descarta sem chamar os callbacks
+static void mq_descartar_em_voo(void) {
+    for (uint i = 0; i < MQ_EM_VOO; ++i) {
+        if (mq.enviado_us[i]) {
+            mq.enviado_us[i] = 0;
+            ++mq.stats.falhas;
+        }
+    }
+}
+
+static void mq_conexao_callback(mqtt_client_t *cliente, void *arg, mqtt_connection_status_t status) {
+    if (status == MQTT_CONNECT_ACCEPTED) {
+        mq.estado = MQ_CONECTADO;
+        mq.backoff_ms = 0;
+        ++mq.stats.conexoes;
+        printf("MQTT: conectado ao broker\n");
+        mqtt_publish(cliente, mq.topico_status, "online", 6, 1, 1, NULL, NULL);
+        return;
+    }
+    printf("MQTT: conexão encerrada (status %d)\n", (int)status);
+    mq_descartar_em_voo();
+    mq.estado = MQ_DESCONECTADO;
+    mq_agendar(true);
+}
+
+static void mq_conectar(void) {
+    mq.estado = MQ_CONECTANDO;
+    mq.estado_desde_ms = agora_ms();
+    err_t err = mqtt_client_connect(mq.cliente, &mq.ip, mq.porta, mq_conexao_callback, NULL, &mq.info);
+    if (err != ERR_OK) {
+        printf("MQTT: erro %d ao conectar\n", err);
+        mq.estado = MQ_DESCONECTADO;
+        mq_agendar(true);
+    }
+}
+
+static void mq_dns_callback(const char *nome, const ip_addr_t *ipaddr, void *arg) {
+    if (mq.estado != MQ_RESOLVENDO) return;
+    if (ipaddr) {
+        mq.ip = *ipaddr;
+        mq_conectar();
+    } else {
+        printf("MQTT: falha no DNS\n");
+        mq.estado = MQ_DESCONECTADO;
+        mq_agendar(true);
+    }
+}
+
+static void mq_abrir(void) {
+    mq.estado = MQ_RESOLVENDO;
+    mq.estado_desde_ms = agora_ms();
+    ip_addr_t ip;
+    err_t err = dns_gethostbyname(mq.broker, &ip, mq_dns_callback, NULL);
+    if (err == ERR_OK) {
+        mq_dns_callback(mq.broker, &ip, NULL);      // IP literal ou já na tabela do lwIP
+    } else if (err != ERR_INPROGRESS) {
+        mq_dns_callback(mq.broker, NULL, NULL);
+    }
+}
+
+// QoS 1: chamado com o PUBACK; QoS 0: quando o TCP confirma o envio (ou no tempo limite do lwIP)
+static void mq_publicacao_callback(void *arg, err_t err) {
+    uint i = (uint)(uintptr_t)arg;
+    if (!mq.enviado_us[i]) return;
+    if (err == ERR_OK) {
+        uint32_t latencia = (uint32_t)(time_us_64() - mq.enviado_us[i]);
+        ++mq.stats.confirmadas;
+        mq.stats.latencia_ultima_us = latencia;
+        if (latencia > mq.stats.latencia_max_us) mq.stats.latencia_max_us = latencia;
+        mq.stats.latencia_total_us += latencia;
+    } else {
+        ++mq.stats.falhas;
+    }
+    mq.enviado_us[i] = 0;
+}
+
+void mq_init(const char *broker, uint16_t porta, const char *cliente_id, const char *prefixo, uint8_t qos) {
+    memset(&mq, 0, sizeof(mq));
+    mq.broker = broker;
+    mq.porta = porta;
+    mq.prefixo = prefixo;
+    mq.qos = qos ? 1 : 0;
+    snprintf(mq.topico_status, sizeof(mq.topico_status), "%s/status", prefixo);
+    mq.info.client_id = cliente_id;
+    mq.info.keep_alive = MQ_KEEPALIVE_S;
+    mq.info.will_topic = mq.topico_status;
+    mq.info.will_msg = "offline";
+    mq.info.will_qos = 1;
+    mq.info.will_retain = 1;
+
+    cyw43_arch_lwip_begin();
+    mq.cliente = mqtt_client_new();  // Única alocação, feita uma vez
+    cyw43_arch_lwip_end();
+}
+
+bool mq_publicar(const char *metrica, const char *valor) {
+    if (mq.estado != MQ_CONECTADO) {
+        ++mq.stats.descartadas;
+        return false;
+    }
+    char topico[MQ_TOPICO_MAX];
+    int n_topico = snprintf(topico, sizeof(topico), "%s/%s", mq.prefixo, metrica);
+    uint16_t n_valor = (uint16_t)strlen(valor);
+
+    uint i = 0;
+    while (i < MQ_EM_VOO && mq.enviado_us[i]) ++i;
+    if (i == MQ_EM_VOO || n_topico >= (int)sizeof(topico)) {
+        ++mq.stats.falhas;
+        return false;
+    }
+
+    // O lwIP copia tópico e valor para o seu buffer de saída
+    cyw43_arch_lwip_begin();
+    mq.enviado_us[i] = time_us_64();
+    err_t err = mqtt_publish(mq.cliente, topico, valor, n_valor, mq.qos, 1, mq_publicacao_callback,
+                             (void *)(uintptr_t)i);
+    if (err != ERR_OK) mq.enviado_us[i] = 0;
+    cyw43_arch_lwip_end();
+    if (err != ERR_OK) {
+        ++mq.stats.falhas;
+        return false;
+    }
+
+    // PUBLISH: cabeçalho fixo (2) + tamanho do tópico (2) + tópico + identificador (QoS 1) + valor
+    ++mq.stats.publicadas;
+    mq.stats.bytes += 2 + 2 + (uint32_t)n_topico + (mq.qos ? 2 : 0) + n_valor;
+    return true;
+}
+
+void mq_poll(void) {
+    if (!mq.cliente) return;
+    cyw43_arch_lwip_begin();
+    switch (mq.estado) {
+    case MQ_DESCONECTADO:
+        if ((int32_t)(agora_ms() - mq.proxima_tentativa_ms) >= 0) mq_abrir();
+        break;
+    case MQ_RESOLVENDO:
+        if (agora_ms() - mq.estado_desde_ms > MQ_TIMEOUT_MS) {
+            printf("MQTT: tempo esgotado ao resolver o broker\n");
+            mq.estado = MQ_DESCONECTADO;
+            mq_agendar(true);
+        }
+        break;
+    case MQ_CONECTANDO:  // O cliente do lwIP tem seu próprio tempo limite para o CONNACK
+    case MQ_CONECTADO:
+        break;
+    }
+    cyw43_arch_lwip_end();
+}
+
+bool mq_conectado(void) {
+    return mq.estado == MQ_CONECTADO;
+}
+
+const mq_stats_t *mq_stats(void) {
+    return &mq.stats;
+}
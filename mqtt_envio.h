@@ -0,0 +1,51 @@
+// mqtt_envio.h
+// Publicação das amostras num broker MQTT 3.1.1, alternativa ao ThingSpeak
+// escolhida na compilação (ENVIO_MQTT).
+//
+// Usa o cliente MQTT do lwIP (pico_lwip_mqtt) sobre uma única conexão TCP
+// mantida aberta com keep-alive; se ela cair, o cliente reconecta com espera
+// exponencial. Cada métrica tem seu tópico ("<prefixo>/temperatura", ...) e
+// a mensagem é só o valor em texto ("25.50"), sem cabeçalhos nem chave de API.
+//
+// Todo o trabalho com o lwIP acontece em mq_poll() (laço principal), em
+// mq_publicar() e nos callbacks do próprio lwIP.
+#ifndef MQTT_ENVIO_H
+#define MQTT_ENVIO_H
+
+#include "pico/stdlib.h"
+
+#define MQ_KEEPALIVE_S 60               // Intervalo do PINGREQ sem outras mensagens
+#define MQ_BACKOFF_MIN_MS 1000          // Espera após a primeira falha
+#define MQ_BACKOFF_MAX_MS 60000         // Espera máxima entre tentativas
+#define MQ_TIMEOUT_MS 15000             // Tempo máximo para resolver o nome do broker
+#define MQ_EM_VOO 8                     // Publicações aguardando confirmação (ver MQTT_REQ_MAX_IN_FLIGHT)
+#define MQ_TOPICO_MAX 64
+
+typedef struct {
+    uint32_t conexoes;            // Sessões aceitas pelo broker
+    uint32_t publicadas;          // Mensagens entregues ao cliente do lwIP
+    uint32_t confirmadas;         // QoS 1: PUBACK recebido; QoS 0: bytes confirmados pelo TCP
+    uint32_t falhas;              // Publicações recusadas ou perdidas com a conexão
+    uint32_t descartadas;         // Publicações pedidas sem conexão com o broker
+    uint32_t bytes;               // Bytes dos pacotes PUBLISH (cabeçalho MQTT + tópico + valor)
+    uint32_t latencia_ultima_us;  // Da publicação à confirmação
+    uint32_t latencia_max_us;
+    uint64_t latencia_total_us;   // Soma das latências (média = total / confirmadas)
+} mq_stats_t;
+
+// Define o broker (nome ou IP literal), a identificação do cliente, o prefixo
+// dos tópicos e o QoS (0 ou 1) das publicações; não faz acesso à rede.
+void mq_init(const char *broker, uint16_t porta, const char *cliente_id, const char *prefixo, uint8_t qos);
+
+// Publica `valor` em "<prefixo>/<metrica>" (com retain, para quem assinar depois).
+// Retorna false sem conexão ou sem espaço no cliente do lwIP.
+bool mq_publicar(const char *metrica, const char *valor);
+
+// Resolve o nome do broker, conecta e reconecta. Chamar no laço principal.
+void mq_poll(void);
+
+bool mq_conectado(void);
+
+const mq_stats_t *mq_stats(void);
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+**/
+
+#include <math.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "neopixel_library.h"
+
+// When the DMA finishes the joined TX FIFO still holds up to 8 words of 4 bits at 1.25 us
+#define NP_FIFO_US 40
+
+static NP *np_instances[NP_MAX_INSTANCES];
+static bool np_irq_installed = false;
+static int np_offsets[2] = {-1, -1};    // program offset in pio0 / pio1
+
+
+static void np_start_frame (NP *np, uint8_t buffer) {
+    np->tx = buffer;
+    np->pending = false;
+    dma_channel_transfer_from_buffer_now (np->dma, np->planes + buffer * NP_PLANE_WORDS(np->leds),
+                                          NP_PLANE_WORDS(np->leds));
+}
+
+
+// End of the latch: the strips now show the frame; send the queued one if any.
+static int64_t np_latch_done (alarm_id_t id, void *user_data) {
+    NP *np = user_data;
+    if (np->pending) {
+        np_start_frame (np, np->next);
+    } else {
+        np->tx = -1;
+    }
+    return 0;
+}
+
+
+// End of a DMA transfer: schedule the latch for when the FIFO has drained, without blocking.
+static void np_dma_handler (void) {
+    for (uint i = 0; i < NP_MAX_INSTANCES; ++i) {
+        NP *np = np_instances[i];
+        if (np && dma_channel_get_irq0_status (np->dma)) {
+            dma_channel_acknowledge_irq0 (np->dma);
+            if (add_alarm_in_us (NP_FIFO_US + NP_RESET_US, np_latch_done, np, true) < 0) {
+                // No free alarm slot: wait out the latch here rather than leave np->tx stuck busy.
+                busy_wait_us_32 (NP_FIFO_US + NP_RESET_US);
+                np_latch_done (0, np);
+            }
+        }
+    }
+}
+
+
+// Create a driver instance and populate the provided NP structure.
+// Returns: True on success.
+// np: A pointer to a blank NP structure to hold the driver parameters.
+// pio: The PIO hardware instance to try first (the other one is used if it is full).
+// pin_base: The pin of the first strip; strip n is on pin_base + n.
+// strips: The number of strips (1 to NP_MAX_STRIPS).
+// leds: The number of LEDs on the longest strip.
+// pixels: Storage for strips * leds pixels.
+// planes: Storage for 2 * NP_PLANE_WORDS(leds) words.
+bool np_init (NP *np, PIO pio, uint pin_base, uint strips, uint leds, np_pixel_t *pixels, uint32_t *planes) {
+    if (strips == 0 || strips > NP_MAX_STRIPS || leds == 0) {
+        return false;
+    }
+    uint slot = 0;
+    while (slot < NP_MAX_INSTANCES && np_instances[slot]) {
+        ++slot;
+    }
+    if (slot == NP_MAX_INSTANCES) {
+        return false;
+    }
+
+    // claim a state machine and load the program once per PIO block
+    bool claimed = false;
+    for (uint attempt = 0; attempt < 2; ++attempt, pio = (pio == pio0) ? pio1 : pio0) {
+        int *offset = &np_offsets[pio_get_index (pio)];
+        if (*offset < 0 && !pio_can_add_program (pio, &ws2812_parallel_program)) {
+            continue;
+        }
+        int sm = pio_claim_unused_sm (pio, false);
+        if (sm == -1) {
+            continue;
+        }
+        if (*offset < 0) {
+            *offset = pio_add_program (pio, &ws2812_parallel_program);
+        }
+        np->pio = pio;
+        np->sm = (uint)sm;
+        np->offset = (uint)*offset;
+        claimed = true;
+        break;
+    }
+    if (!claimed) {
+        return false;
+    }
+
+    np->pin_base = pin_base;
+    np->strips = strips;
+    np->leds = leds;
+    np->pixels = pixels;
+    np->planes = planes;
+    np->tx = -1;
+    np->next = 0;
+    np->pending = false;
+    np_set_brightness (np, 255);
+    np_clear (np);
+
+    ws2812_parallel_sm_init (np->pio, np->sm, np->offset, pin_base, strips, 800000.f);
+
+    // 32-bit DMA from memory to the state machine FIFO, paced by its DREQ
+    np->dma = dma_claim_unused_channel (true);
+    dma_channel_config c = dma_channel_get_default_config (np->dma);
+    channel_config_set_transfer_data_size (&c, DMA_SIZE_32);
+    channel_config_set_read_increment (&c, true);
+    channel_config_set_write_increment (&c, false);
+    channel_config_set_dreq (&c, pio_get_dreq (np->pio, np->sm, true));
+    dma_channel_configure (np->dma, &c, &np->pio->txf[np->sm], NULL, NP_PLANE_WORDS(leds), false);
+
+    if (!np_irq_installed) {
+        irq_add_shared_handler (DMA_IRQ_0, np_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        np_irq_installed = true;
+    }
+    np_instances[slot] = np;
+    dma_channel_set_irq0_enabled (np->dma, true);
+    irq_set_enabled (DMA_IRQ_0, true);
+    return true;
+}
+
+
+// Set the global brightness (0 to 255). A gamma 2.2 curve is applied on top of it.
+// np: A pointer to an NP driver struct.
+void np_set_brightness (NP *np, uint8_t brightness) {
+    for (uint i = 0; i < 256; ++i) {
+        np->lut[i] = (uint8_t)(powf (i / 255.0f, 2.2f) * brightness + 0.5f);
+    }
+}
+
+
+// Set one pixel in the frame being prepared (nothing is sent until np_show).
+// np: A pointer to an NP driver struct.
+// strip: The strip number (0 is the one on pin_base).
+// index: The LED position along the strip.
+void np_set (NP *np, uint strip, uint index, uint8_t r, uint8_t g, uint8_t b) {
+    np_pixel_t *p = &np->pixels[strip * np->leds + index];
+    p->R = r;
+    p->G = g;
+    p->B = b;
+}
+
+
+// Turn every pixel of the frame being prepared off.
+// np: A pointer to an NP driver struct.
+void np_clear (NP *np) {
+    memset (np->pixels, 0, np->strips * np->leds * sizeof (np_pixel_t));
+}
+
+
+// Transpose an 8x8 bit matrix: byte s of the input is the colour byte of strip s,
+// byte k of the result holds bit k of every strip (bit s = strip s).
+static inline uint64_t np_transpose8 (uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;  x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull; x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull; x = x ^ t ^ (t << 28);
+    return x;
+}
+
+
+// Convert LED `index` of every strip into 24 bit-planes (six words, MSB first).
+static void np_pack_led (NP *np, uint index, uint32_t *out) {
+    uint64_t g = 0, r = 0, b = 0;
+    const np_pixel_t *p = &np->pixels[index];
+    for (uint s = 0; s < np->strips; ++s, p += np->leds) {
+        g |= (uint64_t)np->lut[p->G] << (8 * s);
+        r |= (uint64_t)np->lut[p->R] << (8 * s);
+        b |= (uint64_t)np->lut[p->B] << (8 * s);
+    }
+    const uint64_t planes[3] = {np_transpose8 (g), np_transpose8 (r), np_transpose8 (b)};
+    for (uint c = 0; c < 3; ++c) {
+        // the OSR shifts right, so the plane for bit 7 goes in the low byte of the first word
+        *out++ = __builtin_bswap32 ((uint32_t)(planes[c] >> 32));
+        *out++ = __builtin_bswap32 ((uint32_t)planes[c]);
+    }
+}
+
+
+// Convert the frame to bit-planes and start sending it by DMA. Never blocks: if a
+// frame is still being sent, the new one follows as soon as the latch ends.
+// All strips are refreshed together, so a frame takes as long as the longest strip;
+// shorter strips simply ignore the extra bits clocked past their last LED.
+// np: A pointer to an NP driver struct.
+void np_show (NP *np) {
+    // Use the buffer that is not being sent. A frame queued in it is dropped
+    // before it is overwritten, since the new frame replaces it.
+    uint32_t irq = save_and_disable_interrupts ();
+    uint8_t free_buffer = np->tx == 0 ? 1 : 0;
+    np->pending = false;
+    restore_interrupts (irq);
+
+    uint32_t *out = np->planes + free_buffer * NP_PLANE_WORDS(np->leds);
+    for (uint i = 0; i < np->leds; ++i, out += 6) {
+        np_pack_led (np, i, out);
+    }
+
+    irq = save_and_disable_interrupts ();
+    if (np->tx < 0) {
+        np_start_frame (np, free_buffer);
+    } else {
+        np->next = free_buffer;
+        np->pending = true;
+    }
+    restore_interrupts (irq);
+}
+
+
+// Returns: True while a frame is being sent or latched, or one is queued.
+// np: A pointer to an NP driver struct.
+bool np_busy (NP *np) {
+    return np->tx >= 0 || np->pending;
+}
@@ -0,0 +1,44 @@
+#ifndef NEOPIXEL_LIBRARY_H
+#define NEOPIXEL_LIBRARY_H
+
+#include "hardware/pio.h"
+#include "hardware/clocks.h"            // for clock_get_hz() in generated header
+#include "neopixel_library.pio.h"       // generated by pioasm
+
+#define NP_MAX_STRIPS 8                 // one bit per strip in each bit-plane
+#define NP_MAX_INSTANCES 4
+
+// Words of bit-plane data per frame: 24 bit-planes per LED, four planes per word.
+#define NP_PLANE_WORDS(leds) (6 * (leds))
+
+// Strip reset (latch) time in microseconds. Newer WS2812B parts need > 280 us.
+#define NP_RESET_US 300
+
+typedef struct {
+    uint8_t G, R, B;
+} np_pixel_t;
+
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint offset;
+    uint pin_base;
+    uint strips;                // strips on consecutive pins starting at pin_base
+    uint leds;                  // LEDs on the longest strip
+    np_pixel_t *pixels;         // strips * leds pixels: pixels[strip * leds + index]
+    uint32_t *planes;           // 2 * NP_PLANE_WORDS(leds) words (double buffer)
+    uint8_t lut[256];           // brightness and gamma correction
+    int dma;
+    volatile int8_t tx;         // buffer being sent (DMA or latch); -1 = idle
+    volatile uint8_t next;      // buffer holding the frame queued behind it
+    volatile bool pending;      // a frame is waiting in `next`
+} NP;
+
+bool np_init (NP *np, PIO pio, uint pin_base, uint strips, uint leds, np_pixel_t *pixels, uint32_t *planes);
+void np_set_brightness (NP *np, uint8_t brightness);
+void np_set (NP *np, uint strip, uint index, uint8_t r, uint8_t g, uint8_t b);
+void np_clear (NP *np);
+void np_show (NP *np);
+bool np_busy (NP *np);
+
+#endif
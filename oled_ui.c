@@ -0,0 +1,289 @@
+// oled_ui.c
+// Implementação da camada de widgets do display (ver oled_ui.h).
+#include <string.h>
+
+#include "oled_ui.h"
+
+//-----------------------------------------------------------------------------------------------------
+// Inicialização dos widgets
+//-----------------------------------------------------------------------------------------------------
+static void ui_base(ui_widget_t *w, ui_tipo_t tipo, uint8_t x, uint8_t y) {
+    memset(w, 0, sizeof(*w));
+    w->tipo = tipo;
+    w->x = x;
+    w->y = y;
+    w->sujo = true;
+}
+
+void ui_label(ui_widget_t *w, uint8_t x, uint8_t y, const char *texto) {
+    ui_base(w, UI_LABEL, x, y);
+    strncpy(w->texto, texto, UI_TEXTO_MAX - 1);
+}
+
+void ui_value(ui_widget_t *w, uint8_t x, uint8_t y, uint8_t digitos, uint8_t casas, const char *unidade) {
+    ui_base(w, UI_VALUE, x, y);
+    w->digitos = digitos;
+    w->casas = casas;
+    w->unidade = unidade;
+}
+
+void ui_icon(ui_widget_t *w, uint8_t x, uint8_t y, const ssd1306_image_t *icone) {
+    ui_base(w, UI_ICON, x, y);
+    w->icone = icone;
+}
+
+void ui_bar(ui_widget_t *w, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura, int32_t min, int32_t max) {
+    ui_base(w, UI_BAR, x, y);
+    w->largura = largura;
+    w->altura = altura;
+    w->min = min;
+    w->max = max > min ? max : min + 1;
+    w->valor = min;
+}
+
+void ui_sparkline(ui_widget_t *w, ui_historico_t *historico, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura,
+                  int32_t min, int32_t max) {
+    ui_base(w, UI_SPARKLINE, x, y);
+    w->largura = largura <= UI_HISTORICO_MAX ? largura : UI_HISTORICO_MAX;
+    w->altura = altura;
+    w->min = min;
+    w->max = max > min ? max : min + 1;
+    w->historico = historico;
+    memset(historico, 0, sizeof(*historico));
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Atualização dos valores (detecção de mudança)
+//-----------------------------------------------------------------------------------------------------
+
+// Quantos pixels da barra ficam preenchidos para o valor atual (sem contar a borda)
+static uint8_t ui_bar_fill(const ui_widget_t *w, int32_t valor) {
+    if (valor <= w->min) return 0;
+    if (valor >= w->max) return w->largura - 2;
+    return (uint8_t)(((int64_t)(valor - w->min) * (w->largura - 2)) / (w->max - w->min));
+}
+
+void ui_set_text(ui_widget_t *w, const char *texto) {
+    if (strncmp(w->texto, texto, UI_TEXTO_MAX - 1) == 0) return; // Mesmo texto: nada a fazer
+    strncpy(w->texto, texto, UI_TEXTO_MAX - 1);
+    w->sujo = true;
+}
+
+void ui_set_value(ui_widget_t *w, int32_t valor) {
+    if (w->valor == valor) return;
+
+    // Na barra, só redesenha se a quantidade de pixels preenchidos mudar
+    if (w->tipo == UI_BAR && !w->sujo && ui_bar_fill(w, valor) == w->preenchido) {
+        w->valor = valor;
+        return;
+    }
+
+    w->valor = valor;
+    w->sujo = true;
+}
+
+void ui_set_icon(ui_widget_t *w, const ssd1306_image_t *icone) {
+    if (w->icone == icone) return;
+    w->icone = icone;
+    w->sujo = true;
+}
+
+void ui_push_sample(ui_widget_t *w, int16_t valor) {
+    ui_historico_t *h = w->historico;
+
+    h->amostras[h->proximo] = valor;
+    h->proximo = (h->proximo + 1) % w->largura;
+    if (h->quantidade < w->largura) ++h->quantidade;
+    if (w->pendentes < 255) ++w->pendentes;
+}
+
+void ui_invalidate(ui_widget_t *w) {
+    w->sujo = true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Formatação numérica sem printf
+//-----------------------------------------------------------------------------------------------------
+uint ui_format_fixed(char *destino, uint tamanho, int32_t valor, uint8_t casas, uint8_t digitos) {
+    char tmp[16];
+    uint n = 0;
+    bool negativo = valor < 0;
+    uint32_t v = negativo ? (uint32_t)(-(int64_t)valor) : (uint32_t)valor;
+
+    // Gera os dígitos de trás para frente
+    for (uint8_t i = 0; i < casas; ++i) {
+        tmp[n++] = '0' + (v % 10);
+        v /= 10;
+    }
+    if (casas) tmp[n++] = '.';
+    do {
+        tmp[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v);
+    if (negativo) tmp[n++] = '-';
+
+    // Alinha à direita preenchendo com espaços até a largura mínima
+    uint largura = digitos + (casas ? casas + 1 : 0);
+    while (n < largura && n < sizeof(tmp)) tmp[n++] = ' ';
+
+    uint escritos = 0;
+    while (n && escritos + 1 < tamanho) destino[escritos++] = tmp[--n];
+    if (tamanho) destino[escritos] = '\0';
+    return escritos;
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Desenho
+//-----------------------------------------------------------------------------------------------------
+static void ui_draw(ssd1306_t *oled, ui_widget_t *w) {
+    char buffer[UI_TEXTO_MAX + 16];
+    uint n;
+
+    switch (w->tipo) {
+    case UI_LABEL:
+        ssd1306_draw_string(oled, w->x, w->y, 1, w->texto);
+        w->largura = strlen(w->texto) * UI_FONTE_LARGURA;
+        w->altura = UI_FONTE_ALTURA;
+        break;
+
+    case UI_VALUE:
+        n = ui_format_fixed(buffer, sizeof(buffer), w->valor, w->casas, w->digitos);
+        if (w->unidade) strncpy(buffer + n, w->unidade, sizeof(buffer) - n - 1);
+        buffer[sizeof(buffer) - 1] = '\0';
+        ssd1306_draw_string(oled, w->x, w->y, 1, buffer);
+        w->largura = strlen(buffer) * UI_FONTE_LARGURA;
+        w->altura = UI_FONTE_ALTURA;
+        break;
+
+    case UI_ICON:
+        if (w->icone) {
+            ssd1306_blit_image(oled, w->icone, w->x, w->y, SSD1306_BLIT_COPY);
+            w->largura = w->icone->width;
+            w->altura = w->icone->height;
+        } else {
+            w->largura = w->altura = 0;
+        }
+        break;
+
+    case UI_BAR:
+        w->preenchido = ui_bar_fill(w, w->valor);
+        ssd1306_draw_empty_square(oled, w->x, w->y, w->largura - 1, w->altura - 1);
+        if (w->preenchido)
+            ssd1306_draw_square(oled, w->x + 1, w->y + 1, w->preenchido, w->altura - 2);
+        break;
+
+    case UI_SPARKLINE:
+        break; // Desenhado em ui_render_sparkline()
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Gráfico de histórico (sparkline)
+//-----------------------------------------------------------------------------------------------------
+
+// Linha do gráfico (0 = topo) correspondente a um valor
+static uint8_t ui_spark_linha(const ui_widget_t *w, int32_t valor) {
+    if (valor <= w->min) return w->altura - 1;
+    if (valor >= w->max) return 0;
+    return (w->altura - 1) - (uint8_t)(((int64_t)(valor - w->min) * (w->altura - 1)) / (w->max - w->min));
+}
+
+// Desenha uma coluna inteira do gráfico byte a byte: apaga as páginas da coluna
+// e traça o segmento vertical entre a amostra anterior e a desta coluna.
+// A coluna do cursor (próxima a ser escrita) fica sempre em branco.
+static void ui_spark_coluna(ssd1306_t *oled, const ui_widget_t *w, uint8_t coluna) {
+    const ui_historico_t *h = w->historico;
+    const uint8_t paginas = w->altura >> 3;
+    uint8_t *destino = &oled->buffer[(w->y >> 3) * oled->width + w->x + coluna];
+
+    // Idade da amostra nesta coluna (0 = mais recente); o cursor não conta
+    uint8_t idade = (h->proximo + w->largura - 1 - coluna) % w->largura;
+    uint8_t visiveis = h->quantidade < w->largura ? h->quantidade : w->largura - 1;
+
+    int topo = -1, base = -1;
+    if (idade < visiveis) {
+        topo = base = ui_spark_linha(w, h->amostras[coluna]);
+        if (idade + 1 < visiveis) {
+            int anterior = ui_spark_linha(w, h->amostras[(coluna + w->largura - 1) % w->largura]);
+            if (anterior < topo) topo = anterior;
+            if (anterior > base) base = anterior;
+        }
+    }
+
+    // A coluna do buffer circular é a própria coluna na tela: o que estava ali é a amostra
+    // mais antiga, então as páginas são apagadas antes de traçar o novo segmento
+    for (uint8_t pagina = 0; pagina < paginas; ++pagina)
+        destino[pagina * oled->width] = 0;
+    if (topo < 0) return;
+
+    for (uint8_t pagina = topo >> 3; pagina <= base >> 3; ++pagina) {
+        int inicio = pagina * 8;
+        int de = topo > inicio ? topo - inicio : 0;
+        int ate = base < inicio + 7 ? base - inicio : 7;
+        destino[pagina * oled->width] |= (uint8_t)((0xff << de) & (0xff >> (7 - ate)));
+    }
+}
+
+// Envia ao display as colunas [de, de + n) do gráfico, que podem dar a volta no buffer circular
+static void ui_spark_enviar(ssd1306_t *oled, const ui_widget_t *w, uint8_t de, uint8_t n) {
+    if (de + n <= w->largura) {
+        ssd1306_show_area(oled, w->x + de, w->y, n, w->altura);
+    } else {
+        ssd1306_show_area(oled, w->x + de, w->y, w->largura - de, w->altura);
+        ssd1306_show_area(oled, w->x, w->y, de + n - w->largura, w->altura);
+    }
+}
+
+static void ui_render_sparkline(ssd1306_t *oled, ui_widget_t *w) {
+    const uint8_t cursor = w->historico->proximo;
+
+    if (w->sujo || w->pendentes + 1 >= w->largura) {
+        // Primeiro desenho (ou atraso maior que o gráfico): redesenha tudo
+        for (uint8_t coluna = 0; coluna < w->largura; ++coluna)
+            ui_spark_coluna(oled, w, coluna);
+        ssd1306_show_area(oled, w->x, w->y, w->largura, w->altura);
+    } else {
+        // Só as colunas novas e o cursor à frente delas
+        uint8_t primeira = (cursor + w->largura - w->pendentes) % w->largura;
+        for (uint8_t i = 0; i <= w->pendentes; ++i)
+            ui_spark_coluna(oled, w, (primeira + i) % w->largura);
+        ui_spark_enviar(oled, w, primeira, w->pendentes + 1);
+    }
+
+    w->pendentes = 0;
+    w->sujo = false;
+}
+
+uint ui_render(ssd1306_t *oled, ui_widget_t *const *widgets, uint quantidade) {
+    uint redesenhados = 0;
+
+    for (uint i = 0; i < quantidade; ++i) {
+        ui_widget_t *w = widgets[i];
+
+        if (w->tipo == UI_SPARKLINE) {
+            if (w->sujo || w->pendentes) {
+                ui_render_sparkline(oled, w);
+                ++redesenhados;
+            }
+            continue;
+        }
+
+        if (!w->sujo) continue;
+
+        // Apaga a área do desenho anterior, redesenha e envia a união das duas caixas
+        uint8_t largura_antiga = w->largura;
+        uint8_t altura_antiga = w->altura;
+        ssd1306_clear_square(oled, w->x, w->y, largura_antiga, altura_antiga);
+
+        ui_draw(oled, w);
+
+        uint8_t largura = w->largura > largura_antiga ? w->largura : largura_antiga;
+        uint8_t altura = w->altura > altura_antiga ? w->altura : altura_antiga;
+        ssd1306_show_area(oled, w->x, w->y, largura, altura);
+
+        w->sujo = false;
+        ++redesenhados;
+    }
+
+    return redesenhados;
+}
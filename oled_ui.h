@@ -0,0 +1,90 @@
+// oled_ui.h
+// Camada de widgets em modo retido para o display SSD1306.
+//
+// Cada widget guarda o último valor desenhado e a sua caixa delimitadora.
+// Em ui_render() apenas os widgets cujo valor mudou são apagados, redesenhados
+// e enviados ao display com ssd1306_show_area(); sem mudanças, nada é feito.
+#ifndef OLED_UI_H
+#define OLED_UI_H
+
+#include "ssd1306.h"
+
+#define UI_TEXTO_MAX 24     // Tamanho máximo dos textos (incluindo o '\0')
+#define UI_FONTE_LARGURA 6  // Largura de um caractere da fonte 8x5 (5 + 1 de espaçamento)
+#define UI_FONTE_ALTURA 8   // Altura de um caractere da fonte 8x5
+#define UI_HISTORICO_MAX 128 // Amostras guardadas por gráfico de histórico (uma por coluna)
+
+// Tipos de widget suportados
+typedef enum {
+    UI_LABEL,   // Texto (fixo ou alterado com ui_set_text)
+    UI_VALUE,   // Valor numérico em ponto fixo com unidade (ex.: "25.50 C")
+    UI_ICON,    // Imagem no formato de páginas (ssd1306_image_t)
+    UI_BAR,     // Barra horizontal proporcional a um valor entre min e max
+    UI_SPARKLINE // Gráfico de histórico que cresce uma coluna por amostra
+} ui_tipo_t;
+
+// Histórico de um gráfico em buffer circular de tamanho fixo (sem heap).
+// O índice de cada amostra no buffer é também a coluna em que ela é desenhada:
+// a origem do gráfico gira junto com o buffer, então cada nova amostra só
+// desenha a própria coluna e apaga a seguinte (cursor), sem deslocar as demais.
+typedef struct {
+    int16_t amostras[UI_HISTORICO_MAX];
+    uint8_t proximo;     // Coluna da próxima amostra
+    uint8_t quantidade;  // Amostras válidas no buffer
+} ui_historico_t;
+
+typedef struct {
+    ui_tipo_t tipo;
+    uint8_t x, y;                 // Canto superior esquerdo
+    uint8_t largura, altura;      // Caixa ocupada pelo último desenho
+    bool sujo;                    // Precisa ser redesenhado no próximo ui_render()
+
+    // UI_LABEL
+    char texto[UI_TEXTO_MAX];     // Último texto desenhado
+
+    // UI_VALUE e UI_BAR
+    int32_t valor;                // Valor atual (ponto fixo com `casas` decimais)
+    uint8_t casas;                // Casas decimais do valor
+    uint8_t digitos;              // Largura mínima da parte inteira (alinha à direita)
+    const char *unidade;          // Sufixo exibido após o valor (pode ser NULL)
+    int32_t min, max;             // Faixa da barra
+    uint8_t preenchido;           // Pixels preenchidos no último desenho da barra
+
+    // UI_ICON
+    const ssd1306_image_t *icone; // Última imagem desenhada
+
+    // UI_SPARKLINE (usa também largura, altura, min e max)
+    ui_historico_t *historico;    // Buffer circular com as amostras
+    uint8_t pendentes;            // Amostras ainda não desenhadas
+} ui_widget_t;
+
+// Inicialização dos widgets (todos começam "sujos" para o primeiro desenho)
+void ui_label(ui_widget_t *w, uint8_t x, uint8_t y, const char *texto);
+void ui_value(ui_widget_t *w, uint8_t x, uint8_t y, uint8_t digitos, uint8_t casas, const char *unidade);
+void ui_icon(ui_widget_t *w, uint8_t x, uint8_t y, const ssd1306_image_t *icone);
+void ui_bar(ui_widget_t *w, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura, int32_t min, int32_t max);
+// y e altura do gráfico devem ser múltiplos de 8 (páginas do display); largura <= UI_HISTORICO_MAX
+void ui_sparkline(ui_widget_t *w, ui_historico_t *historico, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura,
+                  int32_t min, int32_t max);
+
+// Atualização dos valores; só marcam o widget se o resultado visível mudar
+void ui_set_text(ui_widget_t *w, const char *texto);
+void ui_set_value(ui_widget_t *w, int32_t valor);
+void ui_set_icon(ui_widget_t *w, const ssd1306_image_t *icone);
+
+// Acrescenta uma amostra ao gráfico; o próximo ui_render() desenha e envia
+// apenas a nova coluna e o cursor à frente dela (custo O(1) por amostra)
+void ui_push_sample(ui_widget_t *w, int16_t valor);
+
+// Força o redesenho de um widget (ex.: após limpar o display)
+void ui_invalidate(ui_widget_t *w);
+
+// Redesenha e envia ao display apenas os widgets alterados.
+// Retorna a quantidade de widgets redesenhados.
+uint ui_render(ssd1306_t *oled, ui_widget_t *const *widgets, uint quantidade);
+
+// Formata um valor em ponto fixo sem printf (ex.: 2550, 2 casas -> "25.50").
+// Retorna o número de caracteres escritos (sem o '\0').
+uint ui_format_fixed(char *destino, uint tamanho, int32_t valor, uint8_t casas, uint8_t digitos);
+
+#endif
@@ -4,12 +4,55 @@
  * SPDX-License-Identifier: BSD-3-Clause
 **/
 
+#include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "hardware/pio.h"
 
 #include "onewire_library.h"
 
+static int ow_offsets[2] = {-1, -1};    // program offset in pio0 / pio1 used by bus groups
+
+
+// Restart the state machine with empty FIFOs after a timeout.
+static void ow_recover (OW *ow) {
+    ow->timeouts += 1;
+    pio_sm_set_enabled (ow->pio, ow->sm, false);
+    pio_sm_clear_fifos (ow->pio, ow->sm);
+    onewire_sm_init (ow->pio, ow->sm, ow->offset, ow->gpio, ow->bits);
+}
+
+
+// Queue a word for the state machine, waiting at most OW_TIMEOUT_US for room.
+// Returns: true on success.
+static bool ow_put (OW *ow, uint32_t data) {
+    absolute_time_t deadline = make_timeout_time_us (OW_TIMEOUT_US);
+    while (pio_sm_is_tx_fifo_full (ow->pio, ow->sm)) {
+        if (time_reached (deadline)) {
+            ow_recover (ow);
+            return false;
+        }
+    }
+    pio_sm_put (ow->pio, ow->sm, data);
+    return true;
+}
+
+
+// Take a word from the state machine, waiting at most OW_TIMEOUT_US.
+// Returns: true on success (on a timeout *data is all ones, as on an idle bus).
+static bool ow_get (OW *ow, uint32_t *data) {
+    absolute_time_t deadline = make_timeout_time_us (OW_TIMEOUT_US);
+    while (pio_sm_is_rx_fifo_empty (ow->pio, ow->sm)) {
+        if (time_reached (deadline)) {
+            ow_recover (ow);
+            *data = 0xffffffff;
+            return false;
+        }
+    }
+    *data = pio_sm_get (ow->pio, ow->sm);
+    return true;
+}
+
 
 // Create a driver instance and populate the provided OW structure.
 // Returns: True on success.
@@ -29,6 +72,8 @@ bool ow_init (OW *ow, PIO pio, uint offset, uint gpio) {
     ow->offset = offset;
     ow->sm = (uint)sm;
     ow->jmp_reset = onewire_reset_instr (ow->offset);   // assemble the bus reset instruction
+    ow->bits = 8;
+    ow->timeouts = 0;
     onewire_sm_init (ow->pio, ow->sm, ow->offset, ow->gpio, 8); // set 8 bits per word
     return true;
 }
@@ -38,8 +83,10 @@ bool ow_init (OW *ow, PIO pio, uint offset, uint gpio) {
 // ow: A pointer to an OW driver struct.
 // data: The word to be sent.
 void ow_send (OW *ow, uint data) {
-    pio_sm_put_blocking (ow->pio, ow->sm, (uint32_t)data);
-    pio_sm_get_blocking (ow->pio, ow->sm);  // discard the response
+    uint32_t response;
+    if (ow_put (ow, (uint32_t)data)) {
+        ow_get (ow, &response);             // discard the response
+    }
 }
 
 
@@ -47,8 +94,11 @@ void ow_send (OW *ow, uint data) {
 // Returns: the word read (LSB first).
 // ow: pointer to an OW driver struct
 uint8_t ow_read (OW *ow) {
-    pio_sm_put_blocking (ow->pio, ow->sm, 0xff);    // generate read slots
-    return (uint8_t)(pio_sm_get_blocking (ow->pio, ow->sm) >> 24);  // shift response into bits 0..7
+    uint32_t response = 0xffffffff;
+    if (ow_put (ow, 0xff)) {                // generate read slots
+        ow_get (ow, &response);
+    }
+    return (uint8_t)(response >> 24);       // shift response into bits 0..7
 }
 
 
@@ -56,8 +106,9 @@ uint8_t ow_read (OW *ow) {
 // Returns: true if any slaves responded.
 // ow: pointer to an OW driver struct
 bool ow_reset (OW *ow) {
-    pio_sm_exec_wait_blocking (ow->pio, ow->sm, ow->jmp_reset);
-    if ((pio_sm_get_blocking (ow->pio, ow->sm) & 1) == 0) {     // apply pin mask (see pio program)
+    uint32_t response;
+    pio_sm_exec (ow->pio, ow->sm, ow->jmp_reset);
+    if (ow_get (ow, &response) && (response & 1) == 0) {       // apply pin mask (see pio program)
         return true;    // a slave pulled the bus low
     }
     return false;
@@ -79,6 +130,7 @@ int ow_romsearch (OW *ow, uint64_t *romcodes, int maxdevs, uint command) {
     int num_found = 0;
     bool finished = false;
 
+    ow->bits = 1;
     onewire_sm_init (ow->pio, ow->sm, ow->offset, ow->gpio, 1); // set driver to 1-bit mode
 
     while (finished == false && (maxdevs == 0 || num_found < maxdevs )) {
@@ -130,6 +182,110 @@ int ow_romsearch (OW *ow, uint64_t *romcodes, int maxdevs, uint command) {
         num_found += 1;
     }                                       // end of while loop
 
+    ow->bits = 8;
     onewire_sm_init (ow->pio, ow->sm, ow->offset, ow->gpio, 8); // restore 8-bit mode
     return num_found;
-}
\ No newline at end of file
+}
+
+
+// Add a bus to a group, claiming a state machine and loading the program once per PIO block.
+// Returns: True on success.
+// group: A pointer to a zeroed OW_GROUP structure.
+// pio: The PIO hardware instance to try first (the other one is used if it is full).
+// gpio: The pin to use for the bus.
+bool ow_group_add (OW_GROUP *group, PIO pio, uint gpio) {
+    if (group->count == OW_GROUP_MAX) {
+        return false;
+    }
+    for (uint attempt = 0; attempt < 2; ++attempt, pio = (pio == pio0) ? pio1 : pio0) {
+        int *offset = &ow_offsets[pio_get_index (pio)];
+        if (*offset < 0) {
+            if (!pio_can_add_program (pio, &onewire_program)) {
+                continue;
+            }
+            *offset = pio_add_program (pio, &onewire_program);
+        }
+        if (ow_init (&group->bus[group->count], pio, (uint)*offset, gpio)) {
+            group->count += 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Reset the buses selected by mask (bit n = group->bus[n]) at the same time.
+// Returns: the mask of buses on which any slave responded.
+uint ow_group_reset (OW_GROUP *group, uint mask) {
+    uint present = 0;
+    uint32_t response;
+    for (uint i = 0; i < group->count; i += 1) {
+        if (mask & (1u << i)) {
+            pio_sm_exec (group->bus[i].pio, group->bus[i].sm, group->bus[i].jmp_reset);
+        }
+    }
+    for (uint i = 0; i < group->count; i += 1) {
+        if ((mask & (1u << i)) && ow_get (&group->bus[i], &response) && (response & 1) == 0) {
+            present |= 1u << i;
+        }
+    }
+    return present;
+}
+
+
+// Send data[n] on bus n for the buses selected by mask.
+void ow_group_send_each (OW_GROUP *group, uint mask, const uint8_t *data) {
+    uint sent = 0;
+    uint32_t response;
+    for (uint i = 0; i < group->count; i += 1) {
+        if ((mask & (1u << i)) && ow_put (&group->bus[i], data[i])) {
+            sent |= 1u << i;
+        }
+    }
+    for (uint i = 0; i < group->count; i += 1) {
+        if (sent & (1u << i)) {
+            ow_get (&group->bus[i], &response);     // discard the response
+        }
+    }
+}
+
+
+// Send the same word on the buses selected by mask.
+void ow_group_send (OW_GROUP *group, uint mask, uint data) {
+    uint8_t each[OW_GROUP_MAX];
+    memset (each, (uint8_t)data, sizeof (each));
+    ow_group_send_each (group, mask, each);
+}
+
+
+// Send romcodes[n] on bus n (e.g. after OW_MATCH_ROM) for the buses selected by mask.
+void ow_group_send_rom (OW_GROUP *group, uint mask, const uint64_t *romcodes) {
+    uint8_t data[OW_GROUP_MAX];
+    for (int b = 0; b < 64; b += 8) {
+        for (uint i = 0; i < group->count; i += 1) {
+            data[i] = (uint8_t)(romcodes[i] >> b);
+        }
+        ow_group_send_each (group, mask, data);
+    }
+}
+
+
+// Read a word from each bus selected by mask into data[n] (0xff on a timeout).
+void ow_group_read (OW_GROUP *group, uint mask, uint8_t *data) {
+    uint sent = 0;
+    uint32_t response;
+    for (uint i = 0; i < group->count; i += 1) {
+        if (mask & (1u << i)) {
+            data[i] = 0xff;
+            if (ow_put (&group->bus[i], 0xff)) {    // generate read slots
+                sent |= 1u << i;
+            }
+        }
+    }
+    for (uint i = 0; i < group->count; i += 1) {
+        if (sent & (1u << i)) {
+            ow_get (&group->bus[i], &response);
+            data[i] = (uint8_t)(response >> 24);
+        }
+    }
+}
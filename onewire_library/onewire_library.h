@@ -1,17 +1,46 @@
+#ifndef ONEWIRE_LIBRARY_H
+#define ONEWIRE_LIBRARY_H
+
 #include "hardware/pio.h"
 #include "hardware/clocks.h"            // for clock_get_hz() in generated header
 #include "onewire_library.pio.h"        // generated by pioasm
 
+// Longest wait for the state machine to take or return a word (a bus reset takes 960 us).
+// On a timeout the state machine is restarted: reads return 0xff and a reset reports no slaves.
+#define OW_TIMEOUT_US 2000
+
 typedef struct {
     PIO pio;
     uint sm;
     uint jmp_reset;
     int offset;
     int gpio;
+    uint bits;                  // bits per word the state machine is set up for
+    uint timeouts;              // words that timed out since ow_init
 } OW;
 
 bool ow_init (OW *ow, PIO pio, uint offset, uint gpio);
 void ow_send (OW *ow, uint data);
 uint8_t ow_read (OW *ow);
 bool ow_reset (OW *ow);
-int ow_romsearch (OW *ow, uint64_t *romcodes, int maxdevs, uint command);
\ No newline at end of file
+int ow_romsearch (OW *ow, uint64_t *romcodes, int maxdevs, uint command);
+
+// A bus group drives several OW instances (one GPIO and state machine each) in
+// lockstep: every word is queued on all buses before any response is collected,
+// so the state machines run the slots at the same time and an operation on the
+// whole group takes as long as on a single bus.
+#define OW_GROUP_MAX 8                  // four state machines in each of pio0 and pio1
+
+typedef struct {
+    OW bus[OW_GROUP_MAX];
+    uint count;
+} OW_GROUP;
+
+bool ow_group_add (OW_GROUP *group, PIO pio, uint gpio);
+uint ow_group_reset (OW_GROUP *group, uint mask);
+void ow_group_send (OW_GROUP *group, uint mask, uint data);
+void ow_group_send_each (OW_GROUP *group, uint mask, const uint8_t *data);
+void ow_group_send_rom (OW_GROUP *group, uint mask, const uint64_t *romcodes);
+void ow_group_read (OW_GROUP *group, uint mask, uint8_t *data);
+
+#endif
@@ -0,0 +1,76 @@
+// politica.c
+// Implementação da política de envio das amostras (ver politica.h).
+#include <math.h>
+#include <string.h>
+
+#include "politica.h"
+
+void politica_init(politica_t *p, const politica_config_t *config, uint32_t agora_ms) {
+    memset(p, 0, sizeof(*p));
+    p->config = config;
+    p->credito_ms = config->rajada * config->intervalo_ms;  // Começa com o crédito cheio
+    p->credito_desde_ms = agora_ms;
+}
+
+// Acumula o crédito do tempo passado, até o limite da rajada
+static void politica_recarregar(politica_t *p, uint32_t agora_ms) {
+    uint32_t limite = p->config->rajada * p->config->intervalo_ms;
+    uint32_t passado = agora_ms - p->credito_desde_ms;
+    p->credito_ms = passado >= limite - p->credito_ms ? limite : p->credito_ms + passado;
+    p->credito_desde_ms = agora_ms;
+}
+
+politica_motivo_t politica_avaliar(politica_t *p, const float *valores, uint32_t agora_ms) {
+    const politica_config_t *c = p->config;
+    ++p->stats.avaliacoes;
+    politica_recarregar(p, agora_ms);
+
+    politica_motivo_t motivo = POLITICA_NADA;
+    if (!p->houve_envio) {
+        motivo = POLITICA_PULSACAO;
+    } else {
+        for (uint8_t i = 0; i < c->campos; ++i) {
+            if (c->banda[i] == 0) {
+                if (valores[i] != p->enviados[i]) motivo = POLITICA_EVENTO;
+            } else if (fabsf(valores[i] - p->enviados[i]) >= c->banda[i] && motivo < POLITICA_BANDA) {
+                motivo = POLITICA_BANDA;
+            }
+        }
+        if (motivo == POLITICA_NADA && agora_ms - p->ultimo_envio_ms >= c->pulsacao_ms) {
+            motivo = POLITICA_PULSACAO;
+        }
+    }
+    // Um evento adiado continua pendente mesmo que o estado volte (relé
+    // oscilando): a próxima amostra com crédito registra que houve mudança
+    if (p->pendente && p->pendente_motivo == POLITICA_EVENTO && motivo < POLITICA_EVENTO) {
+        motivo = POLITICA_EVENTO;
+    }
+    if (motivo == POLITICA_NADA) {
+        p->pendente = false;  // Voltou para perto do último envio enquanto esperava
+        p->pendente_motivo = POLITICA_NADA;
+        return POLITICA_NADA;
+    }
+
+    // A pulsação sai mesmo sem crédito: é no máximo uma a cada `pulsacao_ms`
+    if (p->credito_ms < c->intervalo_ms && motivo != POLITICA_PULSACAO) {
+        if (!p->pendente) {
+            p->pendente = true;
+            p->pendente_desde_ms = agora_ms;
+            ++p->stats.adiados;
+        }
+        if (motivo > p->pendente_motivo) p->pendente_motivo = motivo;
+        return POLITICA_NADA;
+    }
+    p->credito_ms = p->credito_ms >= c->intervalo_ms ? p->credito_ms - c->intervalo_ms : 0;
+    if (p->pendente) {
+        uint32_t atraso = agora_ms - p->pendente_desde_ms;
+        if (atraso > p->stats.atraso_max_ms) p->stats.atraso_max_ms = atraso;
+        p->pendente = false;
+        p->pendente_motivo = POLITICA_NADA;
+    }
+    memcpy(p->enviados, valores, sizeof(float) * c->campos);
+    p->houve_envio = true;
+    p->ultimo_envio_ms = agora_ms;
+    ++p->stats.envios[motivo];
+    return motivo;
+}
@@ -0,0 +1,66 @@
+// politica.h
+// Política de envio das amostras: decide, a cada leitura, se ela deve ser
+// registrada e enviada, em vez de enviar numa cadência fixa.
+//
+// Cada campo tem uma banda morta: uma amostra sai quando algum valor se afasta
+// do último enviado por pelo menos a banda. Campos discretos (banda 0) saem
+// na hora em que mudam (relé, plantinha feliz, luz). Sem mudanças, uma amostra
+// de pulsação sai a cada `pulsacao_ms`, para o destino saber que a placa está
+// viva. Um balde de fichas limita a taxa: cada envio gasta `intervalo_ms` de
+// crédito, o crédito acumula até `rajada` envios, e um envio sem crédito
+// fica pendente até haver crédito, com os valores mais novos. Um evento
+// pendente não se perde se o estado voltar antes do envio.
+//
+// Sem dependências do SDK: o mesmo código roda na simulação de tools/politica_sim.c.
+#ifndef POLITICA_H
+#define POLITICA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define POLITICA_CAMPOS_MAX 8
+
+typedef enum {
+    POLITICA_NADA = 0,
+    POLITICA_PULSACAO,    // Nada mudou por `pulsacao_ms` (ou primeira amostra)
+    POLITICA_BANDA,       // Um valor contínuo saiu da banda morta
+    POLITICA_EVENTO,      // Um estado discreto mudou: enviar sem esperar o lote
+    POLITICA_MOTIVOS,
+} politica_motivo_t;
+
+typedef struct {
+    uint8_t campos;
+    float banda[POLITICA_CAMPOS_MAX];  // Variação mínima de cada campo; 0 = discreto
+    uint32_t pulsacao_ms;              // Intervalo máximo sem envio
+    uint32_t intervalo_ms;             // Intervalo médio mínimo entre envios
+    uint8_t rajada;                    // Envios seguidos permitidos com o crédito cheio
+} politica_config_t;
+
+typedef struct {
+    uint32_t avaliacoes;
+    uint32_t envios[POLITICA_MOTIVOS];   // Por motivo (envios[POLITICA_NADA] não é usado)
+    uint32_t adiados;                    // Envios que esperaram crédito
+    uint32_t atraso_max_ms;              // Maior espera por crédito
+} politica_stats_t;
+
+typedef struct {
+    const politica_config_t *config;
+    float enviados[POLITICA_CAMPOS_MAX]; // Valores da última amostra enviada
+    bool houve_envio;
+    uint32_t ultimo_envio_ms;
+    uint32_t credito_ms;
+    uint32_t credito_desde_ms;           // Última atualização do crédito
+    bool pendente;
+    uint32_t pendente_desde_ms;
+    politica_motivo_t pendente_motivo;   // O mais urgente desde que ficou pendente
+    politica_stats_t stats;
+} politica_t;
+
+void politica_init(politica_t *p, const politica_config_t *config, uint32_t agora_ms);
+
+// Compara a leitura (`config->campos` valores, discretos como 0/1) com a última
+// enviada. Retorna o motivo do envio, ou POLITICA_NADA; com um motivo, a leitura
+// passa a ser a última enviada.
+politica_motivo_t politica_avaliar(politica_t *p, const float *valores, uint32_t agora_ms);
+
+#endif
@@ -0,0 +1,171 @@
+// regras.c
+// Implementação da tabela de regras do estado da plantinha (ver regras.h).
+#include <string.h>
+
+#include "regras.h"
+
+_Static_assert(sizeof(regras_cabecalho_t) == 16, "formato da tabela na flash");
+_Static_assert(sizeof(regras_perfil_t) == 16, "formato da tabela na flash");
+_Static_assert(sizeof(regras_regra_t) == 12, "formato da tabela na flash");
+
+// Perfil padrão: as condições que eram fixas em decidir_estado_plantinha()
+static const regras_regra_t regras_padrao[] = {
+    {.entrada = REGRAS_UMIDADE, .min = 389, .max = INT16_MAX},   // Tensão a partir de LIMIAR_UMIDADE, sem teto
+    {.entrada = REGRAS_TEMPERATURA, .min = 2000, .max = 3500},
+    {.entrada = REGRAS_LUZ, .min = 1, .max = 1},
+};
+static const regras_perfil_t perfil_padrao = {.nome = "padrao", .primeira = 0, .quantidade = 3};
+static const uint8_t vaso_padrao = 0;
+
+uint16_t regras_crc16(const uint8_t *dados, size_t tamanho) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < tamanho; ++i) {
+        crc ^= (uint16_t)(dados[i] << 8);
+        for (int b = 0; b < 8; ++b) crc = crc & 0x8000 ? (uint16_t)(crc << 1) ^ 0x1021 : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+bool regras_carregar(regras_tabela_t *tabela, const void *dados, size_t tamanho) {
+    const regras_cabecalho_t *c = dados;
+    if (tamanho < sizeof(*c) || c->magica != REGRAS_MAGICA || c->versao != REGRAS_VERSAO || !c->perfis) {
+        return false;
+    }
+    if (c->roms && c->roms != c->vasos) return false;
+    size_t corpo = c->perfis * sizeof(regras_perfil_t) + c->regras * sizeof(regras_regra_t) + c->vasos + c->roms * 8;
+    if (c->tamanho != corpo || sizeof(*c) + corpo > tamanho) return false;
+    const uint8_t *p = (const uint8_t *)dados + sizeof(*c);
+    if (regras_crc16(p, corpo) != c->crc) return false;
+
+    regras_tabela_t t = {
+        .perfis = c->perfis,
+        .regras = c->regras,
+        .vasos = c->vasos,
+        .perfil = (const regras_perfil_t *)p,
+        .regra = (const regras_regra_t *)(p + c->perfis * sizeof(regras_perfil_t)),
+        .vaso = p + c->perfis * sizeof(regras_perfil_t) + c->regras * sizeof(regras_regra_t),
+    };
+    if (c->roms) t.rom = t.vaso + t.vasos;
+    for (uint8_t i = 0; i < t.perfis; ++i) {
+        const regras_perfil_t *perfil = &t.perfil[i];
+        if (perfil->quantidade > REGRAS_POR_PERFIL_MAX || perfil->primeira + perfil->quantidade > t.regras) {
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < t.regras; ++i) {
+        if (t.regra[i].entrada >= REGRAS_ENTRADAS || t.regra[i].min > t.regra[i].max || t.regra[i].histerese < 0) {
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < t.vasos; ++i) {
+        if (t.vaso[i] >= t.perfis) return false;
+    }
+    *tabela = t;
+    return true;
+}
+
+void regras_tabela_padrao(regras_tabela_t *tabela) {
+    *tabela = (regras_tabela_t){
+        .perfis = 1,
+        .regras = sizeof(regras_padrao) / sizeof(regras_padrao[0]),
+        .vasos = 1,
+        .perfil = &perfil_padrao,
+        .regra = regras_padrao,
+        .vaso = &vaso_padrao,
+    };
+}
+
+uint8_t regras_perfil_do_vaso(const regras_tabela_t *tabela, uint8_t vaso) {
+    return vaso < tabela->vasos ? tabela->vaso[vaso] : 0;
+}
+
+// Lido byte a byte: os códigos não ficam alinhados na tabela
+uint64_t regras_rom_do_vaso(const regras_tabela_t *tabela, uint8_t vaso) {
+    if (!tabela->rom || vaso >= tabela->vasos) return 0;
+    uint64_t rom = 0;
+    for (int b = 7; b >= 0; --b) rom = rom << 8 | tabela->rom[vaso * 8 + b];
+    return rom;
+}
+
+void regras_vaso_init(regras_vaso_t *v, const regras_tabela_t *tabela, uint8_t perfil) {
+    const regras_perfil_t *p = &tabela->perfil[perfil];
+    memset(v, 0, sizeof(*v));
+    v->regra = &tabela->regra[p->primeira];
+    v->quantidade = p->quantidade;
+    v->perfil = p->nome;
+    v->feliz = true;
+    v->motivo = -1;
+    for (int e = 0; e < REGRAS_ENTRADAS; ++e) {
+        v->de[e] = INT16_MIN;
+        v->ate[e] = INT16_MAX;
+    }
+    // Faixa vazia nas entradas com regras: a primeira leitura sempre é avaliada
+    for (uint8_t i = 0; i < v->quantidade; ++i) {
+        v->de[v->regra[i].entrada] = INT16_MAX;
+        v->ate[v->regra[i].entrada] = INT16_MIN;
+    }
+}
+
+// Falhas pelas durações, próximo prazo e o estado da plantinha; retorna se o estado mudou
+static bool regras_recalcular(regras_vaso_t *v, uint32_t agora_ms) {
+    bool feliz = true;
+    v->motivo = -1;
+    v->tem_prazo = false;
+    for (uint8_t i = 0; i < v->quantidade; ++i) {
+        if (!v->conhecida[i] || v->dentro[i]) {
+            v->falha[i] = false;
+            continue;
+        }
+        uint32_t vence_ms = v->fora_desde_ms[i] + v->regra[i].duracao_s * 1000u;
+        v->falha[i] = (int32_t)(agora_ms - vence_ms) >= 0;
+        if (v->falha[i]) {
+            if (feliz) v->motivo = (int8_t)i;
+            feliz = false;
+        } else if (!v->tem_prazo || (int32_t)(vence_ms - v->prazo_ms) < 0) {
+            v->tem_prazo = true;
+            v->prazo_ms = vence_ms;
+        }
+    }
+    bool mudou = feliz != v->feliz;
+    v->feliz = feliz;
+    if (mudou) ++v->stats.mudancas;
+    return mudou;
+}
+
+bool regras_atualizar(regras_vaso_t *v, regras_entrada_t entrada, int16_t valor, uint32_t agora_ms) {
+    ++v->stats.entradas;
+    if (valor >= v->de[entrada] && valor <= v->ate[entrada]) return false;  // Nenhum limiar cruzado
+    ++v->stats.avaliacoes;
+
+    int32_t de = INT16_MIN, ate = INT16_MAX;
+    for (uint8_t i = 0; i < v->quantidade; ++i) {
+        const regras_regra_t *r = &v->regra[i];
+        if (r->entrada != entrada) continue;
+        bool dentro = v->conhecida[i] && !v->dentro[i]
+                          ? valor >= r->min + r->histerese && valor <= r->max - r->histerese
+                          : valor >= r->min && valor <= r->max;
+        if (!v->conhecida[i] || dentro != v->dentro[i]) {
+            if (!dentro) v->fora_desde_ms[i] = agora_ms;
+            v->dentro[i] = dentro;
+            v->conhecida[i] = true;
+        }
+        // Valores em que esta regra fica como está
+        if (dentro) {
+            if (r->min > de) de = r->min;
+            if (r->max < ate) ate = r->max;
+        } else if (valor < r->min + r->histerese) {
+            if (r->min + r->histerese - 1 < ate) ate = r->min + r->histerese - 1;
+        } else if (r->max - r->histerese + 1 > de) {
+            de = r->max - r->histerese + 1;
+        }
+    }
+    v->de[entrada] = (int16_t)de;
+    v->ate[entrada] = (int16_t)ate;
+    return regras_recalcular(v, agora_ms);
+}
+
+bool regras_tempo(regras_vaso_t *v, uint32_t agora_ms) {
+    if (!v->tem_prazo || (int32_t)(agora_ms - v->prazo_ms) < 0) return false;
+    ++v->stats.avaliacoes;
+    return regras_recalcular(v, agora_ms);
+}
@@ -0,0 +1,127 @@
+// regras.h
+// Estado da plantinha por uma tabela de regras do perfil da planta, em vez de
+// condições fixas no código.
+//
+// Cada regra confere uma entrada (temperatura, umidade ou luz) contra uma faixa
+// [min, max], com histerese: depois de sair da faixa, a entrada precisa voltar
+// `histerese` para dentro dela para a regra voltar a valer. Com `duracao_s`, a
+// regra só falha depois de a entrada ficar fora da faixa por esse tempo
+// ("seco por mais de 10 minutos"). A plantinha está feliz sem nenhuma regra em falha.
+//
+// A avaliação é incremental: para cada entrada, o vaso guarda a faixa de valores
+// em que nenhuma regra muda. Uma leitura dentro dela só custa duas comparações,
+// e as regras da entrada só são reavaliadas quando ela cruza um limiar. Os prazos
+// de duração são conferidos contra o mais próximo deles.
+//
+// Os perfis vêm de uma tabela binária gravada na flash (formato abaixo, gerada
+// por tools/regras/regras_gerar.c), com várias plantas e o perfil de cada vaso,
+// trocada sem recompilar. Sem tabela válida, vale o perfil padrão, igual às
+// condições antigas do firmware.
+//
+// Sem dependências do SDK: o gerador da tabela usa o mesmo código para conferi-la.
+#ifndef REGRAS_H
+#define REGRAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define REGRAS_MAGICA 0x31524752u       // "RGR1" em little-endian
+#define REGRAS_VERSAO 1
+#define REGRAS_NOME_MAX 12
+#define REGRAS_POR_PERFIL_MAX 16
+
+// Entradas das regras, em inteiros
+typedef enum {
+    REGRAS_TEMPERATURA = 0,             // Centésimos de °C
+    REGRAS_UMIDADE,                     // Décimos de % (umidade calibrada)
+    REGRAS_LUZ,                         // 1 = há luz
+    REGRAS_ENTRADAS,
+} regras_entrada_t;
+
+// Formato na flash (little-endian, sem preenchimento): cabeçalho, perfis, regras,
+// o índice do perfil de cada vaso e, opcionalmente, o código ROM do DS18B20 de
+// cada vaso (8 bytes, 0 = vaso sem sensor; usado pelo modo frota). O
+// CRC-16/CCITT cobre tudo depois do cabeçalho.
+typedef struct {
+    uint32_t magica;
+    uint8_t versao;
+    uint8_t perfis;
+    uint8_t regras;
+    uint8_t vasos;
+    uint16_t tamanho;                   // Bytes depois do cabeçalho
+    uint16_t crc;
+    uint8_t roms;                       // Vasos com código ROM: 0 (sem mapa) ou `vasos`
+    uint8_t reservado[3];
+} regras_cabecalho_t;                   // 16 bytes
+
+typedef struct {
+    char nome[REGRAS_NOME_MAX];         // Terminado em zero se for mais curto
+    uint8_t primeira;                   // Índice da primeira regra do perfil
+    uint8_t quantidade;
+    uint16_t reservado;
+} regras_perfil_t;                      // 16 bytes
+
+typedef struct {
+    uint8_t entrada;                    // regras_entrada_t
+    uint8_t reservado;
+    uint16_t duracao_s;                 // Tempo fora da faixa até a regra falhar
+    int16_t min, max;
+    int16_t histerese;
+    uint16_t reservado2;
+} regras_regra_t;                       // 12 bytes
+
+typedef struct {
+    uint8_t perfis, regras, vasos;
+    const regras_perfil_t *perfil;
+    const regras_regra_t *regra;
+    const uint8_t *vaso;                // Perfil de cada vaso
+    const uint8_t *rom;                 // Código ROM de cada vaso, 8 bytes; NULL sem mapa
+} regras_tabela_t;
+
+typedef struct {
+    uint32_t entradas;                  // Leituras recebidas
+    uint32_t avaliacoes;                // Leituras que cruzaram um limiar ou prazos vencidos
+    uint32_t mudancas;                  // Trocas entre feliz e triste
+} regras_stats_t;
+
+// Estado das regras de um vaso
+typedef struct {
+    const regras_regra_t *regra;
+    uint8_t quantidade;
+    const char *perfil;
+    bool dentro[REGRAS_POR_PERFIL_MAX];   // Na faixa, com a histerese
+    bool falha[REGRAS_POR_PERFIL_MAX];    // Fora da faixa há mais de duracao_s
+    bool conhecida[REGRAS_POR_PERFIL_MAX];
+    uint32_t fora_desde_ms[REGRAS_POR_PERFIL_MAX];
+    int16_t de[REGRAS_ENTRADAS], ate[REGRAS_ENTRADAS];  // Faixa de cada entrada sem mudanças
+    bool tem_prazo;
+    uint32_t prazo_ms;                  // Próximo vencimento de uma duração
+    bool feliz;
+    int8_t motivo;                      // Primeira regra em falha, -1 sem falhas
+    regras_stats_t stats;
+} regras_vaso_t;
+
+// Confere e interpreta uma tabela na memória (a flash pelo XIP, por exemplo), sem copiá-la
+bool regras_carregar(regras_tabela_t *tabela, const void *dados, size_t tamanho);
+
+// Tabela com o perfil padrão: umidade a partir de 38,9 % (1,5 V), 20 a 35 °C e luz
+void regras_tabela_padrao(regras_tabela_t *tabela);
+
+// Índice do perfil do vaso; vasos além da tabela usam o perfil 0
+uint8_t regras_perfil_do_vaso(const regras_tabela_t *tabela, uint8_t vaso);
+
+// Código ROM do DS18B20 do vaso; 0 se o vaso não tem sensor ou a tabela não tem mapa
+uint64_t regras_rom_do_vaso(const regras_tabela_t *tabela, uint8_t vaso);
+
+void regras_vaso_init(regras_vaso_t *v, const regras_tabela_t *tabela, uint8_t perfil);
+
+// Nova leitura de uma entrada; retorna true se o estado (feliz ou triste) mudou
+bool regras_atualizar(regras_vaso_t *v, regras_entrada_t entrada, int16_t valor, uint32_t agora_ms);
+
+// Confere os prazos de duração; retorna true se o estado mudou. Chamar a cada volta.
+bool regras_tempo(regras_vaso_t *v, uint32_t agora_ms);
+
+uint16_t regras_crc16(const uint8_t *dados, size_t tamanho);
+
+#endif
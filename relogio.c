@@ -0,0 +1,105 @@
+// relogio.c
+// Implementação da hora real por SNTP (ver relogio.h).
+#include <stdio.h>
+
+#include "pico/cyw43_arch.h"
+#include "hardware/sync.h"
+#include "lwip/apps/sntp.h"
+
+#include "relogio.h"
+
+static struct {
+    int64_t diferenca_us;         // Hora UNIX (us) menos time_us_64()
+    bool sincronizado;
+    relogio_stats_t stats;
+} relogio;
+
+// A diferença é escrita no contexto do lwIP e lida no laço principal: como são
+// 64 bits, a leitura é feita com as interrupções desligadas
+static int64_t relogio_diferenca(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    int64_t diferenca = relogio.diferenca_us;
+    restore_interrupts(irq);
+    return diferenca;
+}
+
+void relogio_init(const char *servidor) {
+    cyw43_arch_lwip_begin();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, servidor);
+    sntp_init();
+    cyw43_arch_lwip_end();
+}
+
+bool relogio_sincronizado(void) {
+    return relogio.sincronizado;
+}
+
+uint32_t relogio_unix_s(uint64_t instante_us) {
+    if (!relogio.sincronizado) return 0;
+    return (uint32_t)(((int64_t)instante_us + relogio_diferenca()) / 1000000);
+}
+
+uint32_t relogio_agora_s(void) {
+    return relogio_unix_s(time_us_64());
+}
+
+// Data civil a partir dos dias desde 1970-01-01 (algoritmo de H. Hinnant, só inteiros)
+void relogio_iso8601(char *destino, uint32_t unix_s) {
+    uint32_t dias = unix_s / 86400, resto = unix_s % 86400;
+    uint32_t z = dias + 719468;
+    uint32_t era = z / 146097;
+    uint32_t dia_era = z - era * 146097;
+    uint32_t ano_era = (dia_era - dia_era / 1460 + dia_era / 36524 - dia_era / 146096) / 365;
+    uint32_t dia_ano = dia_era - (365 * ano_era + ano_era / 4 - ano_era / 100);
+    uint32_t mp = (5 * dia_ano + 2) / 153;
+    uint32_t dia = dia_ano - (153 * mp + 2) / 5 + 1;
+    uint32_t mes = mp < 10 ? mp + 3 : mp - 9;
+    uint32_t ano = ano_era + era * 400 + (mes <= 2);
+
+    uint32_t campos[6] = {ano, mes, dia, resto / 3600, resto / 60 % 60, resto % 60};
+    static const char separadores[6] = {'-', '-', 'T', ':', ':', 'Z'};
+    char *p = destino;
+    for (int i = 0; i < 6; ++i) {
+        if (i == 0) {
+            *p++ = (char)('0' + ano / 1000 % 10);
+            *p++ = (char)('0' + ano / 100 % 10);
+        }
+        *p++ = (char)('0' + campos[i] / 10 % 10);
+        *p++ = (char)('0' + campos[i] % 10);
+        *p++ = separadores[i];
+    }
+}
+
+const relogio_stats_t *relogio_stats(void) {
+    return &relogio.stats;
+}
+
+// Contexto do lwIP: resposta do servidor, já compensada pelo tempo de ida e volta
+void relogio_sntp_definir(uint32_t segundos, uint32_t microssegundos) {
+    uint64_t agora = time_us_64();
+    int64_t nova = (int64_t)segundos * 1000000 + microssegundos - (int64_t)agora;
+    if (relogio.sincronizado) {
+        // Diferença entre a hora recebida e a prevista pelo contador local
+        int64_t ajuste = nova - relogio.diferenca_us;
+        if (ajuste > INT32_MAX) ajuste = INT32_MAX;
+        if (ajuste < -INT32_MAX) ajuste = -INT32_MAX;
+        relogio.stats.ultimo_ajuste_us = (int32_t)ajuste;
+        int32_t modulo = (int32_t)(ajuste < 0 ? -ajuste : ajuste);
+        if (modulo > relogio.stats.maior_ajuste_us) relogio.stats.maior_ajuste_us = modulo;
+    } else {
+        printf("Relógio sincronizado por SNTP: %lu\n", (unsigned long)segundos);
+    }
+    relogio.diferenca_us = nova;
+    relogio.sincronizado = true;
+    relogio.stats.ultima_s = (uint32_t)(agora / 1000000);
+    ++relogio.stats.sincronizacoes;
+}
+
+// Contexto do lwIP: hora local no envio e na chegada das consultas. Antes da
+// primeira sincronização é o tempo desde o boot; o lwIP só usa as diferenças.
+void relogio_sntp_obter(uint32_t *segundos, uint32_t *microssegundos) {
+    uint64_t agora = (uint64_t)((int64_t)time_us_64() + relogio.diferenca_us);
+    *segundos = (uint32_t)(agora / 1000000);
+    *microssegundos = (uint32_t)(agora % 1000000);
+}
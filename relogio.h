@@ -0,0 +1,47 @@
+// relogio.h
+// Hora real (UTC) obtida por SNTP pelo cliente do lwIP.
+//
+// O relógio do sistema não é alterado: guardamos apenas a diferença entre a
+// hora do servidor e o contador de microssegundos desde o boot (time_us_64()),
+// que é monotônico. Uma amostra registra o instante do contador na coleta e é
+// convertida para hora real só no envio, com a diferença vigente. Assim, as
+// amostras coletadas antes da primeira sincronização (ou durante uma queda da
+// rede) também recebem a hora exata, desde que a placa não reinicie.
+//
+// O lwIP chama relogio_sntp_definir() a cada resposta do servidor (SNTP_UPDATE_DELAY
+// em lwipopts.h) e relogio_sntp_obter() para compensar o tempo de ida e volta.
+#ifndef RELOGIO_H
+#define RELOGIO_H
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint32_t sincronizacoes;
+    uint32_t ultima_s;            // Instante da última sincronização (segundos desde o boot)
+    int32_t ultimo_ajuste_us;     // Correção aplicada na última sincronização (deriva do cristal)
+    int32_t maior_ajuste_us;      // Maior correção em módulo, fora a primeira
+} relogio_stats_t;
+
+// Inicia o cliente SNTP com o servidor (nome ou IP). Chamar com o lwIP já iniciado;
+// as consultas seguem sozinhas no contexto do lwIP, com novas tentativas sem rede.
+void relogio_init(const char *servidor);
+
+bool relogio_sincronizado(void);
+
+// Converte um instante do contador desde o boot (us) em segundos UNIX; 0 sem sincronização
+uint32_t relogio_unix_s(uint64_t instante_us);
+
+// Hora UNIX atual em segundos; 0 sem sincronização
+uint32_t relogio_agora_s(void);
+
+// Escreve "AAAA-MM-DDTHH:MM:SSZ" (RELOGIO_ISO8601 caracteres, sem terminador)
+#define RELOGIO_ISO8601 20
+void relogio_iso8601(char *destino, uint32_t unix_s);
+
+const relogio_stats_t *relogio_stats(void);
+
+// Chamadas pelo cliente SNTP do lwIP (ver lwipopts.h)
+void relogio_sntp_definir(uint32_t segundos, uint32_t microssegundos);
+void relogio_sntp_obter(uint32_t *segundos, uint32_t *microssegundos);
+
+#endif
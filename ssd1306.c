@@ -39,8 +39,12 @@ inline static void swap(int32_t *a, int32_t *b) {
     *b=*t;
 }
 
+// Give up on a write after 100 us per byte (a byte takes 90 us at 100 kHz) plus 1 ms,
+// so a display holding SDA low or a stuck bus does not hang the caller.
+#define SSD1306_TIMEOUT_US(len) (1000+100*(len))
+
 inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
+    switch(i2c_write_timeout_us(i2c, addr, src, len, false, SSD1306_TIMEOUT_US(len))) {
     case PICO_ERROR_GENERIC:
         printf("[%s] addr not acknowledged!\n", name);
         break;
@@ -58,11 +62,27 @@ inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
     fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
 }
 
+inline static void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t len) {
+    uint8_t d[8];
+    d[0]=0x00; // Co=0, D/C#=0: all following bytes are commands
+
+    while(len) {
+        size_t n=len<sizeof(d)-1?len:sizeof(d)-1;
+        memcpy(d+1, cmds, n);
+        fancy_write(p->i2c_i, p->address, d, n+1, "ssd1306_write_cmds");
+        cmds+=n;
+        len-=n;
+    }
+}
+
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
     p->width=width;
     p->height=height;
     p->pages=height/8;
     p->address=address;
+    p->screens=height<SSD1306_GDDRAM_ROWS?SSD1306_GDDRAM_ROWS/height:1;
+    p->draw_screen=0;
+    p->start_line=0;
 
     p->i2c_i=i2c_instance;
 
@@ -136,6 +156,75 @@ inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
     ssd1306_write(p, SET_NORM_INV | (inv & 1));
 }
 
+void ssd1306_set_draw_screen(ssd1306_t *p, uint8_t screen) {
+    if(screen<p->screens)
+        p->draw_screen=screen;
+}
+
+void ssd1306_set_start_line(ssd1306_t *p, uint8_t line) {
+    p->start_line=line&(SSD1306_GDDRAM_ROWS-1);
+    ssd1306_write(p, SET_DISP_START_LINE|p->start_line);
+}
+
+void ssd1306_select_screen(ssd1306_t *p, uint8_t screen) {
+    if(screen<p->screens)
+        ssd1306_set_start_line(p, screen*p->height);
+}
+
+bool ssd1306_slide_to_screen(ssd1306_t *p, uint8_t screen, uint8_t step) {
+    if(screen>=p->screens)
+        return true;
+
+    // always move forwards through GDDRAM, wrapping around after the last row
+    uint8_t target=screen*p->height;
+    uint8_t distance=(target-p->start_line)&(SSD1306_GDDRAM_ROWS-1);
+    if(!distance)
+        return true;
+
+    if(!step)                           // 0: jump straight to the screen
+        step=distance;
+    ssd1306_set_start_line(p, p->start_line+(step<distance?step:distance));
+    return step>=distance;
+}
+
+void ssd1306_scroll_horizontal(ssd1306_t *p, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_step_t step) {
+    uint8_t cmds[]= {
+        SET_SCROLL_OFF,
+        left?SET_SCROLL_H_LEFT:SET_SCROLL_H_RIGHT,
+        0x00,                           // dummy byte
+        start_page,
+        step,
+        end_page,
+        0x00,                           // dummy bytes
+        0xff,
+        SET_SCROLL_ON
+    };
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
+}
+
+void ssd1306_scroll_diagonal(ssd1306_t *p, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_step_t step, uint8_t vertical_offset) {
+    uint8_t cmds[]= {
+        SET_SCROLL_OFF,
+        left?SET_SCROLL_VH_LEFT:SET_SCROLL_VH_RIGHT,
+        0x00,                           // dummy byte
+        start_page,
+        step,
+        end_page,
+        vertical_offset&(SSD1306_GDDRAM_ROWS-1),
+        SET_SCROLL_ON
+    };
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
+}
+
+void ssd1306_set_vertical_scroll_area(ssd1306_t *p, uint8_t fixed_rows, uint8_t scroll_rows) {
+    uint8_t cmds[]= {SET_VSCROLL_AREA, fixed_rows, scroll_rows};
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
+}
+
+void ssd1306_scroll_stop(ssd1306_t *p) {
+    ssd1306_write(p, SET_SCROLL_OFF);
+}
+
 inline void ssd1306_clear(ssd1306_t *p) {
     memset(p->buffer, 0, p->bufsize);
 }
@@ -290,17 +379,105 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
+static inline void ssd1306_blit_byte(ssd1306_t *p, int32_t x, int32_t page, uint8_t val, uint8_t mask, ssd1306_blit_mode_t mode) {
+    if(x<0 || x>=p->width || page<0 || page>=p->pages || !mask) return;
+
+    uint8_t *dst=&p->buffer[x+p->width*page];
+    if(mode==SSD1306_BLIT_COPY)
+        *dst=(*dst&~mask)|(val&mask);
+    else
+        *dst|=val&mask;
+}
+
+void ssd1306_blit_image(ssd1306_t *p, const ssd1306_image_t *img, int32_t x, int32_t y, ssd1306_blit_mode_t mode) {
+    const uint32_t pages=(img->height+7)>>3;
+    const uint32_t total=pages*img->width;
+    const uint8_t last_mask=img->height&7?(1<<(img->height&7))-1:0xff;
+    const int32_t page_base=y>>3; // arithmetic shift, floor for negative y
+    const uint8_t shift=y&7;
+
+    const uint8_t *src=img->data;
+    const uint8_t *end=img->data+img->size;
+    uint32_t n=0;
+
+    while(n<total && src<end) {
+        uint32_t count;
+        bool repeat;
+        if(img->flags&SSD1306_IMG_RLE) {
+            uint8_t c=*src++;
+            repeat=c&0x80;
+            count=(c&0x7f)+1;
+        } else {
+            repeat=false;
+            count=total;
+        }
+
+        for(; count && n<total && src<end; --count, ++n) {
+            const uint8_t val=*src;
+            if(!repeat) ++src;
+
+            const uint32_t page=n/img->width;
+            const int32_t col=x+(int32_t)(n-page*img->width);
+            const uint8_t mask=page==pages-1?last_mask:0xff;
+
+            if(!shift) {
+                ssd1306_blit_byte(p, col, page_base+page, val, mask, mode);
+            } else {
+                ssd1306_blit_byte(p, col, page_base+page, val<<shift, mask<<shift, mode);
+                ssd1306_blit_byte(p, col, page_base+page+1, val>>(8-shift), mask>>(8-shift), mode);
+            }
+        }
+        if(repeat) ++src;
+    }
+}
+
 void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
+    const uint8_t page_offset=p->draw_screen*p->pages;
+    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, page_offset, page_offset+p->pages-1};
     if(p->width==64) {
         payload[1]+=32;
         payload[2]+=32;
     }
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+    ssd1306_write_cmds(p, payload, sizeof(payload));
 
     *(p->buffer-1)=0x40;
 
     fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
 }
+
+void ssd1306_show_area(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if(x>=p->width || y>=p->height || !width || !height) return;
+    if(x+width>p->width) width=p->width-x;
+    if(y+height>p->height) height=p->height-y;
+
+    const uint32_t page_start=y>>3;
+    const uint32_t page_end=(y+height-1)>>3;
+    const uint8_t page_offset=p->draw_screen*p->pages;
+
+    uint8_t payload[]= {SET_COL_ADDR, x, x+width-1, SET_PAGE_ADDR, page_offset+page_start, page_offset+page_end};
+    if(p->width==64) {
+        payload[1]+=32;
+        payload[2]+=32;
+    }
+
+    ssd1306_write_cmds(p, payload, sizeof(payload));
+
+    if(width==p->width) {
+        // full rows are contiguous in the buffer: borrow the byte in front of
+        // the first page for the data control byte and send everything at once
+        uint8_t *start=p->buffer+page_start*p->width-1;
+        uint8_t saved=*start;
+        *start=0x40;
+        fancy_write(p->i2c_i, p->address, start, (page_end-page_start+1)*p->width+1, "ssd1306_show_area");
+        *start=saved;
+        return;
+    }
+
+    uint8_t row[256]; // width is at most 255 (uint8_t)
+    row[0]=0x40;
+    for(uint32_t page=page_start; page<=page_end; ++page) {
+        memcpy(row+1, p->buffer+page*p->width+x, width);
+        fancy_write(p->i2c_i, p->address, row, width+1, "ssd1306_show_area");
+    }
+}
@@ -53,9 +53,35 @@ typedef enum {
     SET_DISP_CLK_DIV = 0xD5,
     SET_PRECHARGE = 0xD9,
     SET_VCOM_DESEL = 0xDB,
-    SET_CHARGE_PUMP = 0x8D
+    SET_CHARGE_PUMP = 0x8D,
+    SET_SCROLL_H_RIGHT = 0x26,
+    SET_SCROLL_H_LEFT = 0x27,
+    SET_SCROLL_VH_RIGHT = 0x29,
+    SET_SCROLL_VH_LEFT = 0x2A,
+    SET_SCROLL_OFF = 0x2E,
+    SET_SCROLL_ON = 0x2F,
+    SET_VSCROLL_AREA = 0xA3
 } ssd1306_command_t;
 
+/**
+*	@brief number of rows of the controller's display RAM (GDDRAM)
+*/
+#define SSD1306_GDDRAM_ROWS 64
+
+/**
+*	@brief frames between scroll steps of the hardware scroll
+*/
+typedef enum {
+    SSD1306_SCROLL_2_FRAMES = 0x07,
+    SSD1306_SCROLL_3_FRAMES = 0x04,
+    SSD1306_SCROLL_4_FRAMES = 0x05,
+    SSD1306_SCROLL_5_FRAMES = 0x00,
+    SSD1306_SCROLL_25_FRAMES = 0x06,
+    SSD1306_SCROLL_64_FRAMES = 0x01,
+    SSD1306_SCROLL_128_FRAMES = 0x02,
+    SSD1306_SCROLL_256_FRAMES = 0x03
+} ssd1306_scroll_step_t;
+
 /**
 *	@brief holds the configuration
 */
@@ -68,8 +94,37 @@ typedef struct {
     bool external_vcc; 	/**< whether display uses external vcc */ 
     uint8_t *buffer;	/**< display buffer */
     size_t bufsize;		/**< buffer size */
+    uint8_t screens;	/**< screens of height rows fitting in GDDRAM (calculated on initialization) */
+    uint8_t draw_screen;	/**< GDDRAM screen written by ssd1306_show and ssd1306_show_area */
+    uint8_t start_line;	/**< current display start line */
 } ssd1306_t;
 
+/**
+*	@brief flags of ssd1306_image_t
+*/
+#define SSD1306_IMG_RLE 0x01	/**< data is run-length encoded (see tools/img2page.py) */
+
+/**
+*	@brief image in native page format (8 vertical pixels per byte, LSB on top)
+*
+*	generated from BMP/PNG files by tools/img2page.py
+*/
+typedef struct {
+    uint8_t width;		/**< width of image in pixels */
+    uint8_t height;		/**< height of image in pixels */
+    uint8_t flags;		/**< SSD1306_IMG_RLE if data is compressed */
+    uint16_t size;		/**< size of data in bytes */
+    const uint8_t *data;	/**< page-ordered image data */
+} ssd1306_image_t;
+
+/**
+*	@brief how image bytes are combined with the buffer
+*/
+typedef enum {
+    SSD1306_BLIT_COPY,	/**< image replaces buffer contents (clears unset pixels) */
+    SSD1306_BLIT_OR	/**< image pixels are added to buffer contents */
+} ssd1306_blit_mode_t;
+
 /**
 *	@brief initialize display
 *
@@ -135,6 +190,104 @@ void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 */
 void ssd1306_show(ssd1306_t *p);
 
+/**
+	@brief send only the pages covering the given area of the buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of area
+	@param[in] y : y position of area (rounded down to page boundary)
+	@param[in] width : width of area
+	@param[in] height : height of area (rounded up to page boundary)
+*/
+void ssd1306_show_area(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief select GDDRAM screen written by ssd1306_show and ssd1306_show_area
+
+	The controller RAM has SSD1306_GDDRAM_ROWS rows, so displays with fewer rows
+	(e.g. 128x32) keep several pre-rendered screens resident. A 128x64 display
+	has exactly one screen.
+
+	@param[in] p : instance of display
+	@param[in] screen : screen index, 0 <= screen < p->screens
+*/
+void ssd1306_set_draw_screen(ssd1306_t *p, uint8_t screen);
+
+/**
+	@brief show a resident GDDRAM screen by moving the display start line
+
+	@param[in] p : instance of display
+	@param[in] screen : screen index, 0 <= screen < p->screens
+*/
+void ssd1306_select_screen(ssd1306_t *p, uint8_t screen);
+
+/**
+	@brief move start line one step towards a resident screen (vertical slide)
+
+	call periodically (e.g. once per frame) until it returns true
+
+	@param[in] p : instance of display
+	@param[in] screen : screen index, 0 <= screen < p->screens
+	@param[in] step : rows moved per call, 0 to jump to the screen at once
+
+	@return bool.
+	@retval true if screen is fully shown
+	@retval false if more steps are needed
+*/
+bool ssd1306_slide_to_screen(ssd1306_t *p, uint8_t screen, uint8_t step);
+
+/**
+	@brief set display start line (GDDRAM row shown on the top row)
+
+	@param[in] p : instance of display
+	@param[in] line : start line, 0 to SSD1306_GDDRAM_ROWS-1
+*/
+void ssd1306_set_start_line(ssd1306_t *p, uint8_t line);
+
+/**
+	@brief start continuous hardware horizontal scroll of a range of pages
+
+	GDDRAM contents are rotated by the controller; rewrite the area after
+	ssd1306_scroll_stop to restore it.
+
+	@param[in] p : instance of display
+	@param[in] left : scroll to the left if true, otherwise to the right
+	@param[in] start_page : first page to scroll
+	@param[in] end_page : last page to scroll
+	@param[in] step : frames between scroll steps
+*/
+void ssd1306_scroll_horizontal(ssd1306_t *p, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_step_t step);
+
+/**
+	@brief start continuous hardware vertical and horizontal scroll
+
+	rows outside the area set with ssd1306_set_vertical_scroll_area stay fixed
+
+	@param[in] p : instance of display
+	@param[in] left : scroll to the left if true, otherwise to the right
+	@param[in] start_page : first page to scroll horizontally
+	@param[in] end_page : last page to scroll horizontally
+	@param[in] step : frames between scroll steps
+	@param[in] vertical_offset : rows scrolled vertically per step (1 to 63)
+*/
+void ssd1306_scroll_diagonal(ssd1306_t *p, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_step_t step, uint8_t vertical_offset);
+
+/**
+	@brief set area used by vertical scroll
+
+	@param[in] p : instance of display
+	@param[in] fixed_rows : rows on top that do not scroll
+	@param[in] scroll_rows : rows in scroll area
+*/
+void ssd1306_set_vertical_scroll_area(ssd1306_t *p, uint8_t fixed_rows, uint8_t scroll_rows);
+
+/**
+	@brief stop hardware scroll
+
+	@param[in] p : instance of display
+*/
+void ssd1306_scroll_stop(ssd1306_t *p);
+
 /**
 	@brief clear display buffer
 
@@ -225,6 +378,17 @@ void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const
 */
 void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long size);
 
+/**
+	@brief draw page-format image, copying whole bytes into the buffer
+
+	@param[in] p : instance of display
+	@param[in] img : image to draw
+	@param[in] x : x position of upper left corner
+	@param[in] y : y position of upper left corner (fastest when multiple of 8)
+	@param[in] mode : SSD1306_BLIT_COPY or SSD1306_BLIT_OR
+*/
+void ssd1306_blit_image(ssd1306_t *p, const ssd1306_image_t *img, int32_t x, int32_t y, ssd1306_blit_mode_t mode);
+
 /**
 	@brief draw char with given font
 
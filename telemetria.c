@@ -0,0 +1,99 @@
+// telemetria.c
+// Implementação do envio de telemetria por UDP (ver telemetria.h).
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/cyw43_arch.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+
+#include "telemetria.h"
+
+static struct {
+    ip_addr_t coletor;
+    uint16_t porta;
+    uint32_t dispositivo;
+    uint32_t sequencia;
+    struct udp_pcb *pcb;
+    tlm_amostra_t lote[TLM_MAX_AMOSTRAS];
+    uint8_t quantidade;
+    uint32_t primeira_ms;         // Chegada da amostra mais antiga do lote
+    bool urgente;
+    uint8_t datagrama[TLM_DATAGRAMA_MAX];
+    telemetria_stats_t stats;
+} tlm;
+
+void telemetria_init(const char *coletor, uint16_t porta, uint32_t dispositivo) {
+    memset(&tlm, 0, sizeof(tlm));
+    if (!ipaddr_aton(coletor, &tlm.coletor)) printf("Telemetria: endereço do coletor inválido\n");
+    tlm.porta = porta;
+    tlm.dispositivo = dispositivo;
+}
+
+void telemetria_adicionar(const tlm_amostra_t *amostra) {
+    // Uma amostra longe demais da primeira (delta de 16 bits) fecha o lote atual
+    if (tlm.quantidade && amostra->instante_s - tlm.lote[0].instante_s > UINT16_MAX) {
+        tlm.primeira_ms -= TELEMETRIA_ESPERA_MAX_S * 1000;  // Força o envio
+        telemetria_poll();
+        tlm.stats.descartadas += tlm.quantidade;            // Não saiu: não cabe junto da nova
+        tlm.quantidade = 0;
+    }
+    if (tlm.quantidade == TLM_MAX_AMOSTRAS) {
+        // Sem rede por muito tempo: descarta a mais antiga (o histórico continua na flash)
+        memmove(tlm.lote, tlm.lote + 1, sizeof(tlm.lote[0]) * (TLM_MAX_AMOSTRAS - 1));
+        --tlm.quantidade;
+        ++tlm.stats.descartadas;
+    }
+    if (!tlm.quantidade) tlm.primeira_ms = to_ms_since_boot(get_absolute_time());
+    tlm.lote[tlm.quantidade++] = *amostra;
+}
+
+// Codifica e envia um datagrama; retorna false se o lwIP recusou
+static bool tlm_enviar(uint32_t dispositivo, uint32_t sequencia, const tlm_amostra_t *amostras, uint8_t n) {
+    size_t tamanho = tlm_codificar(tlm.datagrama, sequencia, dispositivo, amostras, n);
+    cyw43_arch_lwip_begin();
+    if (!tlm.pcb) tlm.pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    // PBUF_REF: o lwIP monta os cabeçalhos num pbuf próprio e aponta para o datagrama estático
+    struct pbuf *p = tlm.pcb ? pbuf_alloc(PBUF_TRANSPORT, (u16_t)tamanho, PBUF_REF) : NULL;
+    err_t err = ERR_MEM;
+    if (p) {
+        p->payload = tlm.datagrama;
+        err = udp_sendto(tlm.pcb, p, &tlm.coletor, tlm.porta);
+        pbuf_free(p);
+    }
+    cyw43_arch_lwip_end();
+
+    if (err != ERR_OK) {
+        ++tlm.stats.falhas;
+        return false;
+    }
+    ++tlm.stats.datagramas;
+    tlm.stats.amostras += n;
+    tlm.stats.bytes += (uint32_t)tamanho;
+    return true;
+}
+
+void telemetria_poll(void) {
+    if (!tlm.quantidade) return;
+    uint32_t espera_ms = to_ms_since_boot(get_absolute_time()) - tlm.primeira_ms;
+    if (tlm.quantidade < TELEMETRIA_LOTE && espera_ms < TELEMETRIA_ESPERA_MAX_S * 1000 && !tlm.urgente) return;
+
+    if (!tlm_enviar(tlm.dispositivo, tlm.sequencia, tlm.lote, tlm.quantidade)) return;  // O lote fica para a próxima chamada
+    ++tlm.sequencia;
+    tlm.quantidade = 0;
+    tlm.urgente = false;
+}
+
+bool telemetria_enviar_de(uint32_t dispositivo, uint32_t *sequencia, const tlm_amostra_t *amostras, uint8_t n) {
+    if (!tlm_enviar(dispositivo, *sequencia, amostras, n)) return false;
+    ++*sequencia;
+    return true;
+}
+
+void telemetria_enviar_agora(void) {
+    tlm.urgente = true;
+}
+
+const telemetria_stats_t *telemetria_stats(void) {
+    return &tlm.stats;
+}
@@ -0,0 +1,43 @@
+// telemetria.h
+// Envio das amostras por UDP a um coletor na rede local, no formato binário de
+// telemetria_protocolo.h (ativado na compilação com ENVIO_UDP).
+//
+// As amostras se acumulam em memória e saem num único datagrama quando há
+// TELEMETRIA_LOTE delas ou quando a mais antiga espera TELEMETRIA_ESPERA_MAX_S.
+// Não há confirmação: o coletor detecta perdas pela sequência dos datagramas.
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include "pico/stdlib.h"
+#include "telemetria_protocolo.h"
+
+#define TELEMETRIA_LOTE 10               // Amostras por datagrama
+#define TELEMETRIA_ESPERA_MAX_S 600      // Espera máxima da amostra mais antiga
+
+typedef struct {
+    uint32_t datagramas;          // Datagramas entregues ao lwIP
+    uint32_t amostras;            // Amostras nesses datagramas
+    uint32_t bytes;               // Bytes UDP (sem os cabeçalhos IP/UDP)
+    uint32_t falhas;              // Envios recusados pelo lwIP
+    uint32_t descartadas;         // Amostras perdidas com o lote cheio e sem rede
+} telemetria_stats_t;
+
+// Define o coletor (IP literal) e a identificação do dispositivo; não faz acesso à rede
+void telemetria_init(const char *coletor, uint16_t porta, uint32_t dispositivo);
+
+void telemetria_adicionar(const tlm_amostra_t *amostra);
+
+// Envia o lote quando estiver cheio ou antigo. Chamar no laço principal com a rede ativa.
+void telemetria_poll(void);
+
+// Envia o lote no próximo telemetria_poll(), sem esperar encher
+void telemetria_enviar_agora(void);
+
+// Envia já um datagrama de outro dispositivo (um vaso do modo frota), fora do
+// lote, com a sequência dele, que avança se o envio for aceito. Conta nas mesmas
+// estatísticas; retorna false se o lwIP recusou.
+bool telemetria_enviar_de(uint32_t dispositivo, uint32_t *sequencia, const tlm_amostra_t *amostras, uint8_t n);
+
+const telemetria_stats_t *telemetria_stats(void);
+
+#endif
@@ -0,0 +1,80 @@
+// telemetria_protocolo.c
+// Codificação e verificação dos datagramas de telemetria (ver telemetria_protocolo.h).
+#include "telemetria_protocolo.h"
+
+static inline void escrever16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void escrever32(uint8_t *p, uint32_t v) {
+    escrever16(p, (uint16_t)v);
+    escrever16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t ler16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t ler32(const uint8_t *p) {
+    return ler16(p) | (uint32_t)ler16(p + 2) << 16;
+}
+
+// Tabela de 16 entradas (meio byte por vez): rápida o bastante para o coletor
+// e pequena para a flash da placa
+static const uint16_t crc_tabela[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t tlm_crc16(const uint8_t *dados, size_t tamanho) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < tamanho; ++i) {
+        crc = (uint16_t)(crc << 4) ^ crc_tabela[(crc >> 12) ^ (dados[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ crc_tabela[(crc >> 12) ^ (dados[i] & 0x0F)];
+    }
+    return crc;
+}
+
+size_t tlm_codificar(uint8_t *saida, uint32_t sequencia, uint32_t dispositivo,
+                     const tlm_amostra_t *amostras, uint8_t n) {
+    uint32_t base = amostras[0].instante_s;
+    escrever16(saida, TLM_MAGICA);
+    saida[2] = TLM_VERSAO;
+    saida[3] = n;
+    escrever32(saida + 4, sequencia);
+    escrever32(saida + 8, dispositivo);
+    escrever32(saida + 12, base);
+
+    uint8_t *p = saida + TLM_CABECALHO;
+    for (uint8_t i = 0; i < n; ++i, p += TLM_AMOSTRA) {
+        escrever16(p, (uint16_t)(amostras[i].instante_s - base));
+        escrever16(p + 2, (uint16_t)amostras[i].temperatura_centi);
+        escrever16(p + 4, amostras[i].umidade_mv);
+        p[6] = amostras[i].estados;
+    }
+    escrever16(p, tlm_crc16(saida, (size_t)(p - saida)));
+    return (size_t)(p - saida) + TLM_CRC;
+}
+
+tlm_resultado_t tlm_decodificar(const uint8_t *dados, size_t tamanho, tlm_cabecalho_t *cabecalho,
+                                tlm_amostra_t *amostras) {
+    if (tamanho < TLM_DATAGRAMA(1)) return TLM_CURTO;
+    if (ler16(dados) != TLM_MAGICA || dados[2] != TLM_VERSAO) return TLM_MAGICA_ERRADA;
+    uint8_t n = dados[3];
+    if (n == 0 || n > TLM_MAX_AMOSTRAS || tamanho != TLM_DATAGRAMA(n)) return TLM_TAMANHO;
+    if (tlm_crc16(dados, tamanho - TLM_CRC) != ler16(dados + tamanho - TLM_CRC)) return TLM_CRC_ERRADO;
+
+    cabecalho->quantidade = n;
+    cabecalho->sequencia = ler32(dados + 4);
+    cabecalho->dispositivo = ler32(dados + 8);
+    uint32_t base = ler32(dados + 12);
+    const uint8_t *p = dados + TLM_CABECALHO;
+    for (uint8_t i = 0; i < n; ++i, p += TLM_AMOSTRA) {
+        amostras[i].instante_s = base + ler16(p);
+        amostras[i].temperatura_centi = (int16_t)ler16(p + 2);
+        amostras[i].umidade_mv = ler16(p + 4);
+        amostras[i].estados = p[6];
+    }
+    return TLM_OK;
+}
@@ -0,0 +1,72 @@
+// telemetria_protocolo.h
+// Formato binário dos datagramas UDP de telemetria, sem dependências do SDK:
+// o mesmo código é usado pelo firmware (telemetria.c) e pelas ferramentas de
+// host (coletor e gerador de carga em tools/telemetria/).
+//
+// Todos os campos são little-endian. Um datagrama leva várias amostras:
+//
+//   cabeçalho (16 bytes)
+//     0  u16  mágica 0x5654 ("TV")
+//     2  u8   versão (TLM_VERSAO)
+//     3  u8   quantidade de amostras (1 a TLM_MAX_AMOSTRAS)
+//     4  u32  sequência, +1 a cada datagrama do dispositivo (detecta perdas)
+//     8  u32  identificação do dispositivo
+//     12 u32  instante da primeira amostra (s)
+//   amostras (7 bytes cada)
+//     0  u16  segundos desde o instante do cabeçalho
+//     2  i16  temperatura do solo em centésimos de grau (TLM_SEM_TEMPERATURA = sem leitura)
+//     4  u16  tensão do sensor de umidade em mV
+//     6  u8   estados (bits 0-3: úmido, luz, irrigando, feliz)
+//   CRC-16/CCITT-FALSE (2 bytes) de todos os bytes anteriores
+#ifndef TELEMETRIA_PROTOCOLO_H
+#define TELEMETRIA_PROTOCOLO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TLM_MAGICA 0x5654u
+#define TLM_VERSAO 1
+#define TLM_CABECALHO 16
+#define TLM_AMOSTRA 7
+#define TLM_CRC 2
+#define TLM_MAX_AMOSTRAS 32
+#define TLM_DATAGRAMA_MAX (TLM_CABECALHO + TLM_MAX_AMOSTRAS * TLM_AMOSTRA + TLM_CRC)
+#define TLM_DATAGRAMA(n) ((size_t)TLM_CABECALHO + (size_t)(n) * TLM_AMOSTRA + TLM_CRC)
+#define TLM_SEM_TEMPERATURA INT16_MIN  // Vaso sem DS18B20 ou sem leitura válida
+
+typedef struct {
+    uint32_t instante_s;
+    int16_t temperatura_centi;
+    uint16_t umidade_mv;
+    uint8_t estados;
+} tlm_amostra_t;
+
+typedef struct {
+    uint32_t sequencia;
+    uint32_t dispositivo;
+    uint8_t quantidade;
+} tlm_cabecalho_t;
+
+// Resultado de tlm_decodificar
+typedef enum {
+    TLM_OK = 0,
+    TLM_CURTO,          // Menor que um datagrama com uma amostra
+    TLM_MAGICA_ERRADA,  // Não é deste protocolo (ou versão desconhecida)
+    TLM_TAMANHO,        // Tamanho não bate com a quantidade de amostras
+    TLM_CRC_ERRADO,
+} tlm_resultado_t;
+
+uint16_t tlm_crc16(const uint8_t *dados, size_t tamanho);
+
+// Codifica `n` amostras (1 a TLM_MAX_AMOSTRAS, em ordem de tempo e com no máximo
+// 65535 s entre a primeira e a última) em `saida`. Retorna o tamanho do datagrama.
+size_t tlm_codificar(uint8_t *saida, uint32_t sequencia, uint32_t dispositivo,
+                     const tlm_amostra_t *amostras, uint8_t n);
+
+// Verifica e decodifica um datagrama; as amostras vão para `amostras`
+// (TLM_MAX_AMOSTRAS posições) com o instante absoluto já calculado.
+tlm_resultado_t tlm_decodificar(const uint8_t *dados, size_t tamanho, tlm_cabecalho_t *cabecalho,
+                                tlm_amostra_t *amostras);
+
+#endif
@@ -0,0 +1,477 @@
+// thingspeak.c
+// Implementação do cliente HTTP persistente (ver thingspeak.h).
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+#include "pico/cyw43_arch.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/dns.h"
+
+#include "thingspeak.h"
+
+typedef enum {
+    TS_DESCONECTADO,
+    TS_RESOLVENDO,
+    TS_CONECTANDO,
+    TS_CONECTADO,
+} ts_estado_t;
+
+// Estados do leitor de respostas (o fluxo pode chegar em pedaços arbitrários)
+typedef enum {
+    RESP_CABECALHO,      // Linha de status e cabeçalhos, até a linha vazia
+    RESP_CORPO,          // Corpo com Content-Length
+    RESP_CHUNK_TAMANHO,  // Linha com o tamanho do próximo bloco (chunked)
+    RESP_CHUNK_DADOS,
+    RESP_CHUNK_FIM,      // CRLF depois dos dados do bloco
+    RESP_TRAILER,        // Cabeçalhos finais depois do bloco de tamanho zero
+} ts_resposta_estado_t;
+
+static struct {
+    const char *host;
+    uint16_t porta;
+    ts_estado_t estado;
+    struct tcp_pcb *pcb;
+    uint32_t estado_desde_ms;     // Início da resolução ou da conexão (tempo limite)
+    bool fechando;                // O servidor pediu Connection: close
+
+    // Cache de DNS
+    ip_addr_t ip;
+    bool ip_valido;
+    uint32_t ip_expira_ms;
+
+    // Reconexão
+    uint32_t proxima_tentativa_ms;
+    uint32_t backoff_ms;
+
+    // Fila circular de requisições; as `enviadas` primeiras já foram escritas na conexão atual.
+    // Cada posição guarda o cabeçalho montado por último; um POST para o mesmo caminho e
+    // tipo só atualiza o Content-Length, de largura fixa.
+    char req[TS_FILA][TS_REQ_MAX];
+    uint16_t tamanho[TS_FILA];
+    const char *modelo_caminho[TS_FILA];
+    const char *modelo_tipo[TS_FILA];
+    uint16_t modelo_campo[TS_FILA];   // Posição do valor do Content-Length
+    const void *corpo_req[TS_FILA];   // Corpo do POST (do chamador) e seu tamanho
+    uint16_t corpo_req_tamanho[TS_FILA];
+    ts_resposta_fn resposta[TS_FILA];
+    void *resposta_arg[TS_FILA];
+    uint64_t enviado_us[TS_FILA];
+    uint8_t inicio, quantidade, enviadas;
+    uint8_t reenviar;             // Requisições que já tinham sido enviadas numa conexão anterior
+
+    // Leitor da resposta atual
+    ts_resposta_estado_t resp;
+    char linha[64];
+    uint8_t linha_tamanho;
+    uint32_t restante;
+    bool chunked;
+    uint16_t status;
+    char corpo[16];               // Início do corpo (o ThingSpeak responde com o número da entrada)
+    uint8_t corpo_tamanho;
+
+    ts_stats_t stats;
+} ts;
+
+static inline uint32_t agora_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void ts_conectar(void);
+
+// Agenda a próxima tentativa; a espera dobra a cada falha seguida
+static void ts_agendar(bool falha) {
+    if (falha) {
+        ts.backoff_ms = ts.backoff_ms ? ts.backoff_ms * 2 : TS_BACKOFF_MIN_MS;
+        if (ts.backoff_ms > TS_BACKOFF_MAX_MS) ts.backoff_ms = TS_BACKOFF_MAX_MS;
+        ++ts.stats.falhas;
+    }
+    ts.proxima_tentativa_ms = agora_ms() + (falha ? ts.backoff_ms : 0);
+}
+
+// Desfaz a conexão atual. As requisições sem resposta voltam a ser não enviadas.
+// Retorna ERR_ABRT se o pcb precisou ser abortado (valor a devolver de um callback).
+static err_t ts_desconectar(bool falha) {
+    err_t err = ERR_OK;
+    if (ts.pcb) {
+        tcp_arg(ts.pcb, NULL);
+        tcp_recv(ts.pcb, NULL);
+        tcp_sent(ts.pcb, NULL);
+        tcp_err(ts.pcb, NULL);
+        // As requisições são escritas sem cópia: com alguma ainda sem resposta, o lwIP
+        // poderia retransmitir de buffers que serão reaproveitados, então a conexão é abortada
+        if (ts.enviadas || tcp_close(ts.pcb) != ERR_OK) {
+            tcp_abort(ts.pcb);
+            err = ERR_ABRT;
+        }
+        ts.pcb = NULL;
+    }
+    ts.reenviar = ts.enviadas;
+    ts.enviadas = 0;
+    ts.estado = TS_DESCONECTADO;
+    ts.fechando = false;
+    ts_agendar(falha || ts.reenviar > 0);
+    return err;
+}
+
+// Aborta a conexão sem passar pelo callback de erro (usado nos tempos limite)
+static void ts_abortar(void) {
+    if (ts.pcb) {
+        tcp_err(ts.pcb, NULL);
+        tcp_abort(ts.pcb);
+        ts.pcb = NULL;
+    }
+    ts_desconectar(true);
+}
+
+// Escreve na conexão as requisições da fila que ainda não foram enviadas
+static void ts_escrever(void) {
+    if (ts.estado != TS_CONECTADO || ts.fechando) return;
+
+    bool escreveu = false;
+    while (ts.enviadas < ts.quantidade) {
+        uint i = (ts.inicio + ts.enviadas) % TS_FILA;
+        uint16_t corpo = ts.corpo_req_tamanho[i];
+        if (tcp_sndbuf(ts.pcb) < ts.tamanho[i] + corpo) break;  // Continua no callback de envio
+        // Sem cópia: cabeçalho e corpo ficam intactos até a resposta, que só chega depois do
+        // ACK da requisição (o lwIP processa o ACK antes de entregar os dados)
+        if (tcp_write(ts.pcb, ts.req[i], ts.tamanho[i], corpo ? TCP_WRITE_FLAG_MORE : 0) != ERR_OK) break;
+        if (corpo && tcp_write(ts.pcb, ts.corpo_req[i], corpo, 0) != ERR_OK) {
+            ts_abortar();  // Cabeçalho sem corpo na conexão: recomeça numa nova
+            return;
+        }
+        ts.enviado_us[i] = time_us_64();
+        if (ts.reenviar) {
+            --ts.reenviar;
+            ++ts.stats.reenvios;
+        }
+        ++ts.enviadas;
+        escreveu = true;
+    }
+    if (escreveu) tcp_output(ts.pcb);
+}
+
+static void ts_resposta_inicio(void) {
+    ts.resp = RESP_CABECALHO;
+    ts.linha_tamanho = 0;
+    ts.restante = 0;
+    ts.chunked = false;
+    ts.status = 0;
+    ts.corpo_tamanho = 0;
+}
+
+// Resposta completa: libera a requisição mais antiga da fila
+static void ts_resposta_fim(void) {
+    if (ts.enviadas) {
+        uint32_t latencia = (uint32_t)(time_us_64() - ts.enviado_us[ts.inicio]);
+        ts.stats.latencia_ultima_us = latencia;
+        ts.stats.latencia_total_us += latencia;
+        if (latencia > ts.stats.latencia_max_us) ts.stats.latencia_max_us = latencia;
+        ++ts.stats.respostas;
+
+        ts.corpo[ts.corpo_tamanho] = '\0';
+        printf("ThingSpeak: HTTP %u, %s, %lu us\n", ts.status, ts.corpo, (unsigned long)latencia);
+
+        ts_resposta_fn resposta = ts.resposta[ts.inicio];
+        void *arg = ts.resposta_arg[ts.inicio];
+        ts.inicio = (ts.inicio + 1) % TS_FILA;
+        --ts.quantidade;
+        --ts.enviadas;
+        ts.backoff_ms = 0;
+        if (resposta) resposta(arg, ts.status);
+    }
+    ts_resposta_inicio();
+}
+
+// Comparação sem diferenciar maiúsculas do início de uma linha de cabeçalho
+static bool ts_cabecalho(const char *linha, const char *nome) {
+    while (*nome) {
+        if (tolower((unsigned char)*linha++) != *nome++) return false;
+    }
+    return true;
+}
+
+static void ts_cabecalho_linha(void) {
+    ts.linha[ts.linha_tamanho] = '\0';
+    if (ts.status == 0 && strncmp(ts.linha, "HTTP/", 5) == 0) {
+        const char *espaco = strchr(ts.linha, ' ');
+        ts.status = espaco ? (uint16_t)atoi(espaco + 1) : 0;
+    } else if (ts_cabecalho(ts.linha, "content-length:")) {
+        ts.restante = (uint32_t)strtoul(ts.linha + 15, NULL, 10);
+    } else if (ts_cabecalho(ts.linha, "transfer-encoding:") && strstr(ts.linha, "chunked")) {
+        ts.chunked = true;
+    } else if (ts_cabecalho(ts.linha, "connection:") && strstr(ts.linha, "close")) {
+        ts.fechando = true;  // Nada mais é escrito; o restante da fila vai numa nova conexão
+    }
+}
+
+// Processa um trecho da resposta; as linhas são acumuladas (e truncadas) em ts.linha
+static void ts_ler(const uint8_t *dados, uint tamanho) {
+    for (uint i = 0; i < tamanho; ++i) {
+        uint8_t c = dados[i];
+        switch (ts.resp) {
+        case RESP_CORPO:
+        case RESP_CHUNK_DADOS:
+            if (ts.corpo_tamanho < sizeof(ts.corpo) - 1) ts.corpo[ts.corpo_tamanho++] = (char)c;
+            if (--ts.restante == 0) {
+                if (ts.resp == RESP_CORPO) ts_resposta_fim();
+                else ts.resp = RESP_CHUNK_FIM;
+            }
+            break;
+
+        case RESP_CHUNK_FIM:
+            if (c == '\n') ts.resp = RESP_CHUNK_TAMANHO;
+            break;
+
+        default:
+            if (c != '\n') {
+                if (c != '\r' && ts.linha_tamanho < sizeof(ts.linha) - 1) ts.linha[ts.linha_tamanho++] = (char)c;
+                break;
+            }
+            // Fim de linha
+            ts.linha[ts.linha_tamanho] = '\0';
+            bool vazia = ts.linha_tamanho == 0;
+            if (ts.resp == RESP_CABECALHO) {
+                if (!vazia) {
+                    ts_cabecalho_linha();
+                } else if (ts.chunked) {
+                    ts.resp = RESP_CHUNK_TAMANHO;
+                } else if (ts.restante) {
+                    ts.resp = RESP_CORPO;
+                } else {
+                    ts_resposta_fim();
+                }
+            } else if (ts.resp == RESP_CHUNK_TAMANHO) {
+                ts.restante = (uint32_t)strtoul(ts.linha, NULL, 16);
+                ts.resp = ts.restante ? RESP_CHUNK_DADOS : RESP_TRAILER;
+            } else if (vazia) {  // RESP_TRAILER
+                ts_resposta_fim();
+            }
+            ts.linha_tamanho = 0;
+            break;
+        }
+    }
+}
+
+static err_t ts_recv_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    if (p == NULL) {
+        // O servidor fechou: é uma falha apenas se ainda havia respostas a receber
+        return ts_desconectar(ts.enviadas > 0);
+    }
+    for (struct pbuf *q = p; q; q = q->next) {
+        ts_ler(q->payload, q->len);
+    }
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    ts_escrever();
+    return ts.pcb == tpcb ? ERR_OK : ERR_ABRT;  // ts_escrever pode ter abortado a conexão
+}
+
+// Espaço liberado no buffer de envio: continua escrevendo a fila
+static err_t ts_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t tamanho) {
+    ts_escrever();
+    return ts.pcb == tpcb ? ERR_OK : ERR_ABRT;
+}
+
+// Erro fatal: o lwIP já liberou o pcb
+static void ts_err_callback(void *arg, err_t err) {
+    printf("ThingSpeak: conexão perdida (%d)\n", err);
+    ts.pcb = NULL;
+    ts_desconectar(true);
+}
+
+static err_t ts_connected_callback(void *arg, struct tcp_pcb *tpcb, err_t err) {
+    if (err != ERR_OK) {
+        return ts_desconectar(true);
+    }
+    ts.estado = TS_CONECTADO;
+    ts.fechando = false;
+    ts_resposta_inicio();
+    ts_escrever();
+    return ts.pcb == tpcb ? ERR_OK : ERR_ABRT;
+}
+
+static void ts_dns_callback(const char *nome, const ip_addr_t *ipaddr, void *arg) {
+    if (ts.estado != TS_RESOLVENDO) return;
+    if (ipaddr) {
+        ts.ip = *ipaddr;
+        ts.ip_valido = true;
+        ts.ip_expira_ms = agora_ms() + TS_DNS_TTL_MS;
+        ts_conectar();
+    } else if (ts.ip_valido) {
+        printf("ThingSpeak: falha no DNS, usando o endereço anterior\n");
+        ts_conectar();
+    } else {
+        printf("ThingSpeak: falha no DNS\n");
+        ts.estado = TS_DESCONECTADO;
+        ts_agendar(true);
+    }
+}
+
+static void ts_conectar(void) {
+    ts.pcb = tcp_new_ip_type(IP_GET_TYPE(&ts.ip));
+    if (!ts.pcb) {
+        ts.estado = TS_DESCONECTADO;
+        ts_agendar(true);
+        return;
+    }
+    tcp_arg(ts.pcb, NULL);
+    tcp_recv(ts.pcb, ts_recv_callback);
+    tcp_sent(ts.pcb, ts_sent_callback);
+    tcp_err(ts.pcb, ts_err_callback);
+
+    // Keep-alive TCP para descobrir conexões mortas entre os envios
+    ip_set_option(ts.pcb, SOF_KEEPALIVE);
+    ts.pcb->keep_idle = 20000;
+    ts.pcb->keep_intvl = 5000;
+
+    ts.estado = TS_CONECTANDO;
+    ts.estado_desde_ms = agora_ms();
+    ++ts.stats.conexoes;
+    if (tcp_connect(ts.pcb, &ts.ip, ts.porta, ts_connected_callback) != ERR_OK) {
+        ts_desconectar(true);
+    }
+}
+
+// Inicia uma conexão usando o endereço em cache ou uma nova consulta DNS
+static void ts_abrir(void) {
+    if (ts.ip_valido && (int32_t)(ts.ip_expira_ms - agora_ms()) > 0) {
+        ts_conectar();
+        return;
+    }
+    ts.estado = TS_RESOLVENDO;
+    ts.estado_desde_ms = agora_ms();
+    ++ts.stats.consultas_dns;
+    ip_addr_t ip;
+    err_t err = dns_gethostbyname(ts.host, &ip, ts_dns_callback, NULL);
+    if (err == ERR_OK) {
+        ts_dns_callback(ts.host, &ip, NULL);      // Já estava na tabela do lwIP (ou é um IP literal)
+    } else if (err != ERR_INPROGRESS) {
+        ts_dns_callback(ts.host, NULL, NULL);
+    }
+}
+
+void ts_init(const char *host, uint16_t porta) {
+    memset(&ts, 0, sizeof(ts));
+    ts.host = host;
+    ts.porta = porta;
+    ts.estado = TS_DESCONECTADO;
+}
+
+// Monta o cabeçalho de um POST na posição `i`, com o Content-Length em largura fixa
+static bool ts_modelo_post(uint i, const char *caminho, const char *tipo) {
+    int n = snprintf(ts.req[i], TS_REQ_MAX,
+                     "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: %s\r\nContent-Length: %*s\r\n\r\n",
+                     caminho, ts.host, tipo, TS_LARGURA_TAMANHO, "");
+    if (n <= 0 || n >= TS_REQ_MAX) return false;
+    ts.tamanho[i] = (uint16_t)n;
+    ts.modelo_caminho[i] = caminho;
+    ts.modelo_tipo[i] = tipo;
+    ts.modelo_campo[i] = (uint16_t)(n - 4 - TS_LARGURA_TAMANHO);
+    return true;
+}
+
+// Coloca uma requisição na fila (POST se houver corpo, GET caso contrário)
+static bool ts_enfileirar(const char *caminho, const char *tipo, const void *corpo, uint16_t tamanho,
+                          ts_resposta_fn resposta, void *arg) {
+    cyw43_arch_lwip_begin();
+    bool ok = false;
+    if (ts.quantidade < TS_FILA) {
+        uint i = (ts.inicio + ts.quantidade) % TS_FILA;
+        if (corpo) {
+            // O cabeçalho só é montado de novo se o caminho ou o tipo mudaram
+            ok = (ts.modelo_caminho[i] == caminho && ts.modelo_tipo[i] == tipo) ||
+                 ts_modelo_post(i, caminho, tipo);
+            if (ok) ts_campo_inteiro(ts.req[i] + ts.modelo_campo[i], TS_LARGURA_TAMANHO, tamanho, 0);
+        } else {
+            int n = snprintf(ts.req[i], TS_REQ_MAX, "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", caminho, ts.host);
+            ts.modelo_caminho[i] = ts.modelo_tipo[i] = NULL;
+            ok = n > 0 && n < TS_REQ_MAX;
+            if (ok) ts.tamanho[i] = (uint16_t)n;
+        }
+        if (ok) {
+            ts.corpo_req[i] = corpo;
+            ts.corpo_req_tamanho[i] = corpo ? tamanho : 0;
+            ts.resposta[i] = resposta;
+            ts.resposta_arg[i] = arg;
+            ++ts.quantidade;
+            ts_escrever();
+        }
+    }
+    if (!ok) ++ts.stats.descartadas;
+    cyw43_arch_lwip_end();
+    return ok;
+}
+
+bool ts_get(const char *caminho) {
+    return ts_enfileirar(caminho, NULL, NULL, 0, NULL, NULL);
+}
+
+bool ts_post(const char *caminho, const char *tipo, const void *corpo, uint16_t tamanho,
+             ts_resposta_fn resposta, void *arg) {
+    return ts_enfileirar(caminho, tipo, corpo, tamanho, resposta, arg);
+}
+
+void ts_poll(void) {
+    cyw43_arch_lwip_begin();
+    uint32_t agora = agora_ms();
+
+    switch (ts.estado) {
+    case TS_DESCONECTADO:
+        // Conecta apenas quando há algo a enviar e a espera do backoff terminou
+        if (ts.quantidade && (int32_t)(agora - ts.proxima_tentativa_ms) >= 0) ts_abrir();
+        break;
+
+    case TS_RESOLVENDO:
+    case TS_CONECTANDO:
+        if (agora - ts.estado_desde_ms > TS_TIMEOUT_MS) {
+            printf("ThingSpeak: tempo esgotado ao %s\n", ts.estado == TS_RESOLVENDO ? "resolver" : "conectar");
+            ts_abortar();
+        }
+        break;
+
+    case TS_CONECTADO:
+        // Resposta que não chega: descarta a conexão e reenvia numa nova
+        if (ts.enviadas && time_us_64() - ts.enviado_us[ts.inicio] > TS_TIMEOUT_MS * 1000ull) {
+            printf("ThingSpeak: sem resposta, reconectando\n");
+            ts_abortar();
+        } else {
+            ts_escrever();
+        }
+        break;
+    }
+    cyw43_arch_lwip_end();
+}
+
+uint ts_pendentes(void) {
+    return ts.quantidade;
+}
+
+const ts_stats_t *ts_stats(void) {
+    return &ts.stats;
+}
+
+bool ts_campo_inteiro(char *campo, uint largura, int32_t valor, uint casas) {
+    bool negativo = valor < 0;
+    uint32_t resto = negativo ? (uint32_t)-(int64_t)valor : (uint32_t)valor;
+    int pos = (int)largura - 1;
+    uint digitos = 0;
+    // Da direita para a esquerda, com pelo menos um dígito antes da vírgula decimal
+    do {
+        if (casas && digitos == casas) {
+            if (pos < 0) break;
+            campo[pos--] = '.';
+        }
+        if (pos < 0) break;
+        campo[pos--] = (char)('0' + resto % 10);
+        resto /= 10;
+        ++digitos;
+    } while (resto || digitos <= casas);
+    if (negativo && pos >= 0) campo[pos--] = '-';
+    else if (negativo) resto = 1;
+    while (pos >= 0) campo[pos--] = ' ';
+    return resto == 0;
+}
@@ -0,0 +1,70 @@
+// thingspeak.h
+// Cliente HTTP/1.1 com conexão persistente para os envios ao ThingSpeak.
+//
+// Em vez de resolver o DNS e abrir uma conexão TCP nova a cada envio, o
+// cliente mantém uma única conexão aberta (keep-alive), guarda o endereço
+// resolvido com validade (TTL) e envia as requisições da fila uma atrás da
+// outra sem esperar as respostas (pipelining). Quando o servidor fecha a
+// conexão, as requisições ainda sem resposta são reenviadas numa nova conexão,
+// aberta com espera exponencial (backoff) em caso de falhas seguidas.
+//
+// Todo o trabalho com o lwIP acontece em ts_poll() (laço principal) e nos
+// callbacks do próprio lwIP, nunca em interrupções de temporizador.
+#ifndef THINGSPEAK_H
+#define THINGSPEAK_H
+
+#include "pico/stdlib.h"
+
+#define TS_FILA 4                           // Requisições aguardando resposta
+#define TS_REQ_MAX 384                      // Tamanho máximo da linha de requisição + cabeçalhos
+#define TS_DNS_TTL_MS (60 * 60 * 1000)      // Validade do endereço resolvido
+#define TS_BACKOFF_MIN_MS 1000              // Espera após a primeira falha
+#define TS_BACKOFF_MAX_MS 60000             // Espera máxima entre tentativas
+#define TS_TIMEOUT_MS 15000                 // Tempo máximo para conectar ou receber uma resposta
+#define TS_LARGURA_TAMANHO 5                // Dígitos do Content-Length (alinhado com espaços)
+
+// Estatísticas do cliente (zeradas apenas no ts_init)
+typedef struct {
+    uint32_t respostas;           // Respostas HTTP completas recebidas
+    uint32_t conexoes;            // Conexões TCP abertas
+    uint32_t consultas_dns;       // Consultas DNS feitas (as demais usaram o cache)
+    uint32_t reenvios;            // Requisições reenviadas após a conexão cair
+    uint32_t falhas;              // Conexões perdidas com requisições pendentes ou tentativas sem sucesso
+    uint32_t descartadas;         // Requisições recusadas com a fila cheia
+    uint32_t latencia_ultima_us;  // Do envio da requisição ao fim da resposta
+    uint32_t latencia_max_us;
+    uint64_t latencia_total_us;   // Soma das latências (média = total / respostas)
+} ts_stats_t;
+
+// Chamada quando a resposta de uma requisição chega (status HTTP). O corpo
+// passado a ts_post() pode ser reutilizado a partir deste momento.
+typedef void (*ts_resposta_fn)(void *arg, uint16_t status);
+
+// Define o servidor (nome ou IP literal) e a porta; não faz acesso à rede
+void ts_init(const char *host, uint16_t porta);
+
+// Enfileira um GET para `caminho` (ex.: "/update?api_key=..."). Retorna false com a fila cheia.
+bool ts_get(const char *caminho);
+
+// Enfileira um POST com `corpo`, que não é copiado: deve continuar válido até `resposta`
+// ser chamada, pois é reenviado se a conexão cair antes da resposta. O cabeçalho é
+// reaproveitado enquanto `caminho` e `tipo` forem os mesmos ponteiros, então o
+// conteúdo dessas strings não deve mudar.
+bool ts_post(const char *caminho, const char *tipo, const void *corpo, uint16_t tamanho,
+             ts_resposta_fn resposta, void *arg);
+
+// Resolve o nome, conecta, reconecta e verifica os tempos limite. Chamar no laço principal.
+void ts_poll(void);
+
+// Quantidade de requisições na fila (enviadas ou não)
+uint ts_pendentes(void);
+
+const ts_stats_t *ts_stats(void);
+
+// Escreve `valor` alinhado à direita em `largura` caracteres, preenchendo com espaços
+// e com `casas` decimais (ex.: 2515 com 2 casas = "  25.15"), sem printf. Usado para
+// atualizar campos de largura fixa em requisições já montadas. Retorna false se o
+// valor não coube (o campo fica com os dígitos menos significativos).
+bool ts_campo_inteiro(char *campo, uint largura, int32_t valor, uint casas);
+
+#endif
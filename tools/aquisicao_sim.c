@@ -0,0 +1,116 @@
+// aquisicao_sim.c
+// Simulação de um dia do laço principal lendo os sensores com o intervalo
+// adaptativo de aquisicao.c, comparada com a leitura de todos os canais a cada volta.
+//
+// Os sinais são sintéticos: temperatura com ciclo diário e a quantização do
+// DS18B20, e a tensão de umidade com ruído do ADC, subindo depressa nas duas
+// irrigações do dia (7 h e 19 h, 2 minutos cada) e caindo devagar enquanto o
+// solo seca. O relé ligado acelera os dois canais, como no firmware.
+// Mede leituras por dia, ocupação do 1-Wire, corrente média estimada e o maior
+// erro entre o valor real e a última leitura, no dia todo e durante a irrigação.
+//
+// Compilação:  gcc -O2 -Wall -I. tools/aquisicao_sim.c aquisicao.c -lm -o aquisicao_sim
+// Uso:         ./aquisicao_sim [intervalo_max_temperatura_s intervalo_max_umidade_s]
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "aquisicao.h"
+
+#define ESPERA_MS 500                   // sleep_ms() no fim de cada volta
+#define DS18B20_US 760000               // Conversão de 750 ms e a leitura do scratchpad
+#define ADC_US 10
+#define DIA_MS (24u * 60 * 60 * 1000)
+#define POS_IRRIGACAO_MS (5 * 60 * 1000)
+
+static float ruido(float amplitude) {
+    return amplitude * (2.0f * rand() / RAND_MAX - 1.0f);
+}
+
+static bool irrigando(uint32_t t) {
+    return fmod(t / 3600000.0 + 5, 12.0) < 2.0 / 60;
+}
+
+static float temperatura_real(uint32_t t) {
+    return 22.0f + 3.0f * (float)sin((t / 3600000.0 - 9) / 24 * 2 * M_PI);
+}
+
+// Sobe 1 V em 2 minutos de irrigação, depois cai 0,8 V em 12 horas
+static float umidade_real(uint32_t t) {
+    double desde_min = fmod(t / 3600000.0 + 5, 12.0) * 60;
+    if (desde_min < 2) return (float)(1.1 + 0.5 * desde_min);
+    return (float)(2.1 - 0.8 * (desde_min - 2) / (12 * 60 - 2));
+}
+
+typedef struct {
+    unsigned leituras;
+    uint64_t ocupado_us;
+    double erro_max, erro_max_irrigando;
+} resultado_t;
+
+static void erro(resultado_t *r, double e, bool irrigacao) {
+    if (e > r->erro_max) r->erro_max = e;
+    if (irrigacao && e > r->erro_max_irrigando) r->erro_max_irrigando = e;
+}
+
+static void mostrar(const char *nome, const resultado_t *r, const char *unidade, unsigned corrente_ua) {
+    printf("  %-12s %7u leituras  ocupação %7.3f%%  %6.1f µA  erro máx %.3f %s (irrigando %.3f)\n", nome,
+           r->leituras, 100.0 * r->ocupado_us / 1000.0 / DIA_MS, (double)r->ocupado_us / 1000.0 / DIA_MS * corrente_ua,
+           r->erro_max, unidade, r->erro_max_irrigando);
+}
+
+int main(int argc, char **argv) {
+    aquisicao_config_t temp = {"temperatura", 1000, 60000, 0.07f, 0.1f, 1000};
+    aquisicao_config_t umid = {"umidade", 500, 30000, 0.02f, 0.05f, 300};
+    if (argc == 3) {
+        temp.intervalo_max_ms = (uint32_t)(atof(argv[1]) * 1000);
+        umid.intervalo_max_ms = (uint32_t)(atof(argv[2]) * 1000);
+    }
+
+    for (int adaptativo = 0; adaptativo < 2; ++adaptativo) {
+        srand(1);
+        aquisicao_canal_t ct, cu;
+        aquisicao_init(&ct, &temp, 0);
+        aquisicao_init(&cu, &umid, 0);
+        resultado_t rt = {0}, ru = {0};
+        float t_lida = 0, u_lida = 0;
+        unsigned voltas = 0;
+        uint64_t ocupado_laco_us = 0;
+        for (uint32_t t = 0; t < DIA_MS; ++voltas) {
+            bool irrigacao = irrigando(t);
+            if (adaptativo && irrigacao) {
+                aquisicao_acelerar(&ct, t, POS_IRRIGACAO_MS);
+                aquisicao_acelerar(&cu, t, POS_IRRIGACAO_MS);
+            }
+            uint32_t volta_us = 0;
+            if (!adaptativo || aquisicao_devida(&cu, t)) {
+                u_lida = umidade_real(t) + ruido(0.01f);
+                aquisicao_registrar(&cu, u_lida, t, ADC_US);
+                ++ru.leituras;
+                ru.ocupado_us += ADC_US;
+                volta_us += ADC_US;
+            }
+            if (!adaptativo || aquisicao_devida(&ct, t)) {
+                t_lida = roundf((temperatura_real(t) + ruido(0.05f)) * 16) / 16;
+                aquisicao_registrar(&ct, t_lida, t, DS18B20_US);
+                ++rt.leituras;
+                rt.ocupado_us += DS18B20_US;
+                volta_us += DS18B20_US;
+            }
+            erro(&rt, fabs(temperatura_real(t) - t_lida), irrigacao);
+            erro(&ru, fabs(umidade_real(t) - u_lida), irrigacao);
+            ocupado_laco_us += volta_us;
+            t += volta_us / 1000 + ESPERA_MS;
+        }
+        printf("%s: %u voltas, laço ocupado %.1f%% do tempo\n",
+               adaptativo ? "Adaptativo" : "Toda volta", voltas, 100.0 * ocupado_laco_us / 1000.0 / DIA_MS);
+        mostrar("temperatura", &rt, "°C", temp.corrente_ua);
+        mostrar("umidade", &ru, "V", umid.corrente_ua);
+        if (adaptativo) {
+            printf("  intervalo máx: temperatura %u s, umidade %u s; acelerações %u e %u\n",
+                   temp.intervalo_max_ms / 1000, umid.intervalo_max_ms / 1000, ct.stats.aceleracoes,
+                   cu.stats.aceleracoes);
+        }
+    }
+    return 0;
+}
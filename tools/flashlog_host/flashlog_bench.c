@@ -0,0 +1,134 @@
+// flashlog_bench.c
+// Exercita o flashlog.c do firmware sobre uma flash emulada: mede bytes por
+// registro e registros por setor com leituras sintéticas realistas, confere as
+// consultas por intervalo, a volta do círculo, o desgaste por setor e a perda
+// máxima numa queda de energia. Salva a região em flashlog.bin para o flashlog_dump.
+//
+// Compilação e execução (a partir da raiz do repositório):
+//   gcc -O2 -Wall -Itools/flashlog_host/include -I.
+//       tools/flashlog_host/flashlog_bench.c tools/flashlog_host/flashlog_flash.c
+//       flashlog.c flashlog_codec.c -lm -o flashlog_bench
+//   ./flashlog_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "hardware/flash.h"
+#include "flashlog.h"
+
+// Gerador de leituras: ciclo diário de temperatura com resolução de 1/16 °C do DS18B20,
+// umidade que cai devagar com ruído do ADC e sobe nas irrigações, luz de dia.
+typedef struct {
+    double umidade_v;
+    uint32_t irrigando_ate_s;
+} simulacao_t;
+
+static flashlog_registro_t gerar(simulacao_t *sim, uint32_t instante_s) {
+    double hora = fmod(instante_s / 3600.0, 24.0);
+    double temperatura = 24.0 + 4.0 * sin((hora - 9.0) / 24.0 * 2 * M_PI) + (rand() % 3 - 1) * 0.0625;
+    int16_t temperatura_16 = (int16_t)lround(temperatura * 16.0);
+
+    sim->umidade_v -= 0.00004 * 30;
+    if (sim->umidade_v < 1.4 && sim->irrigando_ate_s < instante_s) sim->irrigando_ate_s = instante_s + 120;
+    bool irrigando = instante_s < sim->irrigando_ate_s;
+    if (irrigando) sim->umidade_v += 0.05;
+    if (sim->umidade_v > 2.6) sim->umidade_v = 2.6;
+    int ruido_mv = rand() % 17 - 8;  // ±8 mV de ruído do ADC
+
+    bool luz = hora >= 6.0 && hora < 18.0;
+    bool umido = sim->umidade_v >= 1.5;
+    bool feliz = umido && temperatura >= 20 && temperatura <= 35 && luz;
+
+    return (flashlog_registro_t){
+        .instante_s = instante_s,
+        .temperatura_centi = (int16_t)(temperatura_16 * 100 / 16),
+        .umidade_mv = (uint16_t)(sim->umidade_v * 1000 + ruido_mv),
+        .estados = (umido ? FLASHLOG_UMIDO : 0) | (luz ? FLASHLOG_LUZ : 0) |
+                   (irrigando ? FLASHLOG_IRRIGANDO : 0) | (feliz ? FLASHLOG_FELIZ : 0),
+    };
+}
+
+static int iguais(const flashlog_registro_t *a, const flashlog_registro_t *b) {
+    return a->instante_s == b->instante_s && a->temperatura_centi == b->temperatura_centi &&
+           a->umidade_mv == b->umidade_mv && a->estados == b->estados;
+}
+
+static void cenario(const char *nome, uint32_t intervalo_s, uint32_t dias) {
+    memset(flashlog_host_flash, 0xFF, sizeof(flashlog_host_flash));
+    memset(flashlog_host_apagamentos, 0, sizeof(flashlog_host_apagamentos));
+    flashlog_host_programacoes = 0;
+    srand(1);
+    flashlog_init();
+
+    uint32_t total = dias * 86400u / intervalo_s;
+    flashlog_registro_t *gerados = malloc(total * sizeof(*gerados));
+    simulacao_t sim = {2.4, 0};
+    for (uint32_t i = 0; i < total; ++i) {
+        gerados[i] = gerar(&sim, 1000 + i * intervalo_s);
+        flashlog_adicionar(&gerados[i]);
+    }
+    const flashlog_stats_t *s = flashlog_stats();
+    double bytes_registro = (double)s->bytes / s->registros;
+    double por_setor = (FLASHLOG_SETOR - sizeof(flashlog_cabecalho_t)) / bytes_registro;
+    double dias_regiao = por_setor * (FLASHLOG_SETORES - 1) * intervalo_s / 86400.0;
+
+    uint32_t min = UINT32_MAX, max = 0;
+    for (uint i = 0; i < FLASHLOG_SETORES; ++i) {
+        uint32_t a = flashlog_host_apagamentos[FLASHLOG_OFFSET / FLASH_SECTOR_SIZE + i];
+        if (a < min) min = a;
+        if (a > max) max = a;
+    }
+
+    printf("%s: %u registros em %u dias\n", nome, total, dias);
+    printf("  %.2f bytes/registro (struct em RAM: %zu), %.0f registros/setor, %.1f dias na regiao de %u KB\n",
+           bytes_registro, sizeof(flashlog_registro_t), por_setor, dias_regiao, FLASHLOG_TAMANHO / 1024);
+    printf("  %u paginas gravadas, %u setores apagados, apagamentos por setor entre %u e %u\n",
+           s->paginas_gravadas, s->setores_apagados, min, max);
+
+    // Consultas por intervalo comparadas com os registros gerados
+    uint32_t mais_antigo = flashlog_ultimo_instante() - (uint32_t)(dias_regiao * 0.9 * 86400);
+    int erros = 0, consultas = 200;
+    uint64_t lidos = 0;
+    clock_t inicio = clock();
+    for (int c = 0; c < consultas; ++c) {
+        uint32_t de = mais_antigo + (uint32_t)(rand() % (int)(dias_regiao * 0.8 * 86400));
+        uint32_t ate = de + 3600 * (1 + rand() % 6);
+        flashlog_consulta_t q;
+        flashlog_registro_t r;
+        uint32_t i = (de - 1000 + intervalo_s - 1) / intervalo_s;
+        flashlog_consultar(&q, de, ate);
+        while (flashlog_proximo(&q, &r)) {
+            if (i >= total || !iguais(&r, &gerados[i])) ++erros;
+            ++i;
+            ++lidos;
+        }
+        if (i < total && gerados[i].instante_s <= ate) ++erros;
+    }
+    double ms = (double)(clock() - inicio) * 1000.0 / CLOCKS_PER_SEC;
+    printf("  %d consultas de 1-6 h: %llu registros, %d divergencias, %.3f ms por consulta (host)\n",
+           consultas, (unsigned long long)lidos, erros, ms / consultas);
+
+    // Queda de energia: a página em RAM é perdida, o log continua do último registro gravado
+    uint32_t antes = flashlog_ultimo_instante();
+    flashlog_init();
+    uint32_t depois = flashlog_ultimo_instante();
+    printf("  reboot sem sync: ultimo registro recuperado %u s antes do ultimo adicionado (limite %u s)\n",
+           antes - depois, FLASHLOG_SYNC_S);
+
+    free(gerados);
+}
+
+int main(void) {
+    cenario("amostras a cada 30 s", 30, 40);
+    cenario("amostras a cada 10 s", 10, 14);
+
+    FILE *f = fopen("flashlog.bin", "wb");
+    if (f) {
+        fwrite(flashlog_host_flash + FLASHLOG_OFFSET, 1, FLASHLOG_TAMANHO, f);
+        fclose(f);
+        printf("regiao salva em flashlog.bin\n");
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+// flashlog_dump.c
+// Decodifica uma cópia da região do histórico (flashlog.h) para CSV.
+//
+// Cópia da placa com o picotool (região padrão: últimos 256 KB de uma flash de 2 MB):
+//   picotool save -r 0x101C0000 0x10200000 flashlog.bin
+// Compilação e uso (a partir da raiz do repositório):
+//   gcc -O2 -Wall -I. tools/flashlog_host/flashlog_dump.c flashlog_codec.c -o flashlog_dump
+//   ./flashlog_dump flashlog.bin [de_s ate_s] > historico.csv
+//   ./flashlog_dump -s flashlog.bin      (resumo por setor)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flashlog_codec.h"
+
+int main(int argc, char **argv) {
+    int resumo = argc > 1 && strcmp(argv[1], "-s") == 0;
+    int a = resumo ? 2 : 1;
+    if (argc <= a) {
+        fprintf(stderr, "uso: %s [-s] copia.bin [de_s ate_s]\n", argv[0]);
+        return 1;
+    }
+    uint32_t de = argc > a + 2 ? (uint32_t)strtoul(argv[a + 1], NULL, 10) : 0;
+    uint32_t ate = argc > a + 2 ? (uint32_t)strtoul(argv[a + 2], NULL, 10) : UINT32_MAX;
+
+    FILE *f = fopen(argv[a], "rb");
+    if (!f) {
+        perror(argv[a]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long tamanho = ftell(f);
+    rewind(f);
+    unsigned setores = (unsigned)(tamanho / FLASHLOG_SETOR);
+    uint8_t *regiao = malloc((size_t)setores * FLASHLOG_SETOR);
+    uint16_t *ordem = malloc(setores * sizeof(uint16_t));
+    if (!regiao || !ordem || fread(regiao, FLASHLOG_SETOR, setores, f) != setores) {
+        fprintf(stderr, "falha ao ler %s\n", argv[a]);
+        return 1;
+    }
+    fclose(f);
+
+    unsigned validos = flashlog_ordenar(regiao, setores, ordem);
+    if (resumo) {
+        printf("%u de %u setores com cabecalho valido\n", validos, setores);
+        printf("%6s %10s %12s %12s %9s %8s\n", "setor", "sequencia", "primeiro_s", "ultimo_s", "registros", "bytes");
+    } else {
+        printf("instante_s,temperatura_c,umidade_v,umido,luz,irrigando,feliz\n");
+    }
+
+    unsigned long total = 0, bytes = 0;
+    for (unsigned k = 0; k < validos; ++k) {
+        const uint8_t *setor = regiao + (size_t)ordem[k] * FLASHLOG_SETOR;
+        flashlog_cabecalho_t cabecalho;
+        memcpy(&cabecalho, setor, sizeof(cabecalho));
+        flashlog_estado_t estado;
+        flashlog_estado_inicio(&estado, &cabecalho);
+
+        const uint8_t *p = setor + sizeof(cabecalho), *fim = setor + FLASHLOG_SETOR;
+        flashlog_registro_t r;
+        unsigned registros = 0;
+        size_t n;
+        while ((n = flashlog_decodificar(p, fim, &estado, &r)) != 0) {
+            p += n;
+            ++registros;
+            if (resumo || r.instante_s < de || r.instante_s > ate) continue;
+            printf("%u,%.2f,%.3f,%d,%d,%d,%d\n", r.instante_s, r.temperatura_centi / 100.0, r.umidade_mv / 1000.0,
+                   !!(r.estados & FLASHLOG_UMIDO), !!(r.estados & FLASHLOG_LUZ),
+                   !!(r.estados & FLASHLOG_IRRIGANDO), !!(r.estados & FLASHLOG_FELIZ));
+        }
+        size_t usados = (size_t)(p - setor - sizeof(cabecalho));
+        if (resumo) {
+            printf("%6u %10u %12u %12u %9u %8zu\n", ordem[k], cabecalho.sequencia, cabecalho.instante_s,
+                   estado.instante_s, registros, usados);
+        }
+        total += registros;
+        bytes += usados;
+    }
+    if (resumo && total) {
+        printf("%lu registros, %.2f bytes por registro\n", total, (double)bytes / total);
+    }
+    free(regiao);
+    free(ordem);
+    return 0;
+}
@@ -0,0 +1,35 @@
+// flashlog_flash.c
+// Flash NOR emulada para compilar flashlog.c no computador.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/flash.h"
+
+uint8_t flashlog_host_flash[PICO_FLASH_SIZE_BYTES];
+uint32_t flashlog_host_apagamentos[PICO_FLASH_SIZE_BYTES / FLASH_SECTOR_SIZE];
+uint32_t flashlog_host_programacoes;
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "apagamento desalinhado em 0x%x\n", flash_offs);
+        abort();
+    }
+    memset(flashlog_host_flash + flash_offs, 0xFF, count);
+    for (size_t s = 0; s < count / FLASH_SECTOR_SIZE; ++s) ++flashlog_host_apagamentos[flash_offs / FLASH_SECTOR_SIZE + s];
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "gravação desalinhada em 0x%x\n", flash_offs);
+        abort();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t atual = flashlog_host_flash[flash_offs + i];
+        if ((atual & data[i]) != data[i]) {
+            fprintf(stderr, "gravação exigiria levar bits de 0 para 1 em 0x%zx\n", flash_offs + i);
+            abort();
+        }
+        flashlog_host_flash[flash_offs + i] = atual & data[i];
+    }
+    ++flashlog_host_programacoes;
+}
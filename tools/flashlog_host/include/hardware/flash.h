@@ -0,0 +1,22 @@
+// Shim de host: flash NOR emulada num vetor em RAM (ver flashlog_flash.c).
+// A gravação só leva bits de 1 para 0, como no chip, e o apagamento é por setor.
+#ifndef FLASHLOG_HOST_HARDWARE_FLASH_H
+#define FLASHLOG_HOST_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+#define FLASH_PAGE_SIZE 256u
+#define FLASH_SECTOR_SIZE 4096u
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+extern uint8_t flashlog_host_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)flashlog_host_flash)
+
+// Contadores da flash emulada
+extern uint32_t flashlog_host_apagamentos[PICO_FLASH_SIZE_BYTES / FLASH_SECTOR_SIZE];
+extern uint32_t flashlog_host_programacoes;
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif
@@ -0,0 +1,15 @@
+// Shim de host: no computador não há XIP nem outro núcleo a parar.
+#ifndef FLASHLOG_HOST_PICO_FLASH_H
+#define FLASHLOG_HOST_PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+#define PICO_OK 0
+
+static inline int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+#endif
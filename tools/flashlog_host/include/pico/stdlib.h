@@ -0,0 +1,11 @@
+// Shim de host: subconjunto de pico/stdlib.h usado por flashlog.c.
+#ifndef FLASHLOG_HOST_PICO_STDLIB_H
+#define FLASHLOG_HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#endif
@@ -0,0 +1,168 @@
+// http_bench.c
+// Gerador de carga para o servidor HTTP local: mede requisições por segundo e
+// latência contra a placa ou contra o build de host (http_servidor_host.c).
+//
+// Cada conexão mantém uma requisição em andamento (keep-alive); com -n, cada
+// requisição usa uma conexão nova, como um navegador ou um coletor sem keep-alive.
+//
+// Compilação:  gcc -O2 -Wall tools/http_host/http_bench.c -o http_bench
+// Uso:         ./http_bench [-c conexoes] [-t segundos] [-n] ip porta caminho
+// Exemplos:    ./http_bench -c 4 -t 10 192.168.0.50 80 /data.json
+//              ./http_bench -c 4 -t 10 127.0.0.1 8081 /metrics
+#define _GNU_SOURCE  // memmem
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define MAX_CONEXOES 64
+#define MAX_AMOSTRAS 2000000
+#define BUFFER 8192
+
+typedef struct {
+    int fd;
+    double enviado_us;
+    size_t usado;
+    char buffer[BUFFER];
+} conexao_t;
+
+static conexao_t conexoes[MAX_CONEXOES];
+static struct sockaddr_in destino;
+static char requisicao[256];
+static int requisicao_tamanho;
+static bool nova_a_cada = false;
+
+static float latencias_us[MAX_AMOSTRAS];
+static size_t respostas, erros, conexoes_abertas;
+static unsigned long long bytes;
+
+static double agora_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static void enviar(conexao_t *c) {
+    if (c->fd < 0) {
+        c->fd = socket(AF_INET, SOCK_STREAM, 0);
+        int um = 1;
+        setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+        c->enviado_us = agora_us();  // Com -n a latência inclui o handshake
+        if (connect(c->fd, (struct sockaddr *)&destino, sizeof(destino)) < 0) {
+            ++erros;
+            close(c->fd);
+            c->fd = -1;
+            return;
+        }
+        ++conexoes_abertas;
+    } else {
+        c->enviado_us = agora_us();
+    }
+    c->usado = 0;
+    if (send(c->fd, requisicao, requisicao_tamanho, MSG_NOSIGNAL) != requisicao_tamanho) {
+        ++erros;
+        close(c->fd);
+        c->fd = -1;
+    }
+}
+
+// Retorna true quando a resposta está completa (cabeçalho + Content-Length bytes)
+static bool resposta_completa(conexao_t *c) {
+    char *fim = memmem(c->buffer, c->usado, "\r\n\r\n", 4);
+    if (!fim) return false;
+    size_t cabecalho = fim + 4 - c->buffer;
+    char *cl = memmem(c->buffer, cabecalho, "Content-Length:", 15);
+    size_t corpo = cl ? strtoul(cl + 15, NULL, 10) : 0;
+    return c->usado >= cabecalho + corpo;
+}
+
+static int comparar(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    int quantidade = 4, segundos = 10, opt;
+    while ((opt = getopt(argc, argv, "c:t:n")) != -1) {
+        switch (opt) {
+        case 'c': quantidade = atoi(optarg); break;
+        case 't': segundos = atoi(optarg); break;
+        case 'n': nova_a_cada = true; break;
+        default: goto uso;
+        }
+    }
+    if (argc - optind != 3 || quantidade < 1 || quantidade > MAX_CONEXOES) {
+    uso:
+        fprintf(stderr, "uso: %s [-c conexoes] [-t segundos] [-n] ip porta caminho\n", argv[0]);
+        return 1;
+    }
+    destino = (struct sockaddr_in){.sin_family = AF_INET, .sin_port = htons(atoi(argv[optind + 1]))};
+    if (inet_pton(AF_INET, argv[optind], &destino.sin_addr) != 1) goto uso;
+    requisicao_tamanho = snprintf(requisicao, sizeof(requisicao), "GET %s HTTP/1.1\r\nHost: %s\r\n%s\r\n",
+                                  argv[optind + 2], argv[optind], nova_a_cada ? "Connection: close\r\n" : "");
+
+    for (int i = 0; i < quantidade; ++i) {
+        conexoes[i].fd = -1;
+        enviar(&conexoes[i]);
+    }
+
+    double inicio = agora_us(), fim = inicio + segundos * 1e6;
+    while (agora_us() < fim) {
+        struct pollfd fds[MAX_CONEXOES];
+        for (int i = 0; i < quantidade; ++i) {
+            fds[i].fd = conexoes[i].fd;
+            fds[i].events = POLLIN;
+        }
+        if (poll(fds, quantidade, 100) < 0 && errno != EINTR) {
+            perror("poll");
+            return 1;
+        }
+        for (int i = 0; i < quantidade; ++i) {
+            conexao_t *c = &conexoes[i];
+            if (c->fd < 0) {
+                enviar(c);  // Reconecta após erro
+                continue;
+            }
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = recv(c->fd, c->buffer + c->usado, BUFFER - c->usado, 0);
+            if (n <= 0 || (c->usado += (size_t)n) == BUFFER) {
+                ++erros;
+                close(c->fd);
+                c->fd = -1;
+                continue;
+            }
+            if (!resposta_completa(c)) continue;
+
+            if (respostas < MAX_AMOSTRAS) latencias_us[respostas] = (float)(agora_us() - c->enviado_us);
+            ++respostas;
+            bytes += c->usado;
+            if (nova_a_cada) {
+                close(c->fd);
+                c->fd = -1;
+            }
+            enviar(c);
+        }
+    }
+    double duracao_s = (agora_us() - inicio) / 1e6;
+
+    size_t amostras = respostas < MAX_AMOSTRAS ? respostas : MAX_AMOSTRAS;
+    qsort(latencias_us, amostras, sizeof(float), comparar);
+    printf("%s:%s%s com %d conexoes%s por %.1f s\n", argv[optind], argv[optind + 1], argv[optind + 2],
+           quantidade, nova_a_cada ? " (nova a cada requisicao)" : " (keep-alive)", duracao_s);
+    printf("  %zu respostas, %.0f req/s, %.1f KiB/s, %zu conexoes abertas, %zu erros\n", respostas,
+           respostas / duracao_s, bytes / duracao_s / 1024, conexoes_abertas, erros);
+    if (amostras) {
+        printf("  latencia: p50 %.0f us, p90 %.0f us, p99 %.0f us, max %.0f us\n",
+               latencias_us[amostras / 2], latencias_us[amostras * 9 / 10], latencias_us[amostras * 99 / 100],
+               latencias_us[amostras - 1]);
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+// http_servidor_host.c
+// Build de host (Linux) do servidor HTTP local: o mesmo http_servidor.c do
+// firmware, ligado a sockets em vez do lwIP. Serve de referência para o
+// http_bench: a diferença entre as duas medições é o custo do transporte
+// (lwIP + Wi-Fi) na placa, já que a montagem das respostas é idêntica.
+//
+// As leituras são simuladas e mudam a cada segundo, como no laço da placa.
+//
+// Compilação (a partir da raiz do repositório):
+//   gcc -O2 -Wall -I. tools/http_host/http_servidor_host.c http_servidor.c -o http_servidor_host
+// Uso:  ./http_servidor_host [-p porta]
+#define _GNU_SOURCE  // accept4
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "http_servidor.h"
+
+#define MAX_CLIENTES 256
+#define EM_VOO 4
+
+typedef struct {
+    int fd;
+    http_conexao_t leitor;
+    http_resposta_t fila[EM_VOO];   // Respostas ainda não entregues ao kernel
+    uint8_t inicio, quantidade;
+    uint16_t parcial;
+    uint8_t entrada[2048];          // Bytes recebidos ainda não lidos (fila cheia)
+    size_t entrada_inicio, entrada_fim;
+} cliente_t;
+
+static cliente_t clientes[MAX_CLIENTES];
+static double temperatura = 24.5, umidade_v = 1.9;
+static unsigned long instante_s;
+static volatile sig_atomic_t sair;
+
+static size_t gerar_json(char *destino, size_t tamanho) {
+    int n = snprintf(destino, tamanho,
+                     "{\"temperatura_solo\":%.2f,\"tensao_umidade\":%.3f,\"umidade_solo\":true,"
+                     "\"luz\":true,\"irrigacao\":false,\"plantinha_feliz\":true,\"instante_s\":%lu}\n",
+                     temperatura, umidade_v, instante_s);
+    return n > 0 ? (size_t)n : 0;
+}
+
+static size_t gerar_metricas(char *destino, size_t tamanho) {
+    const http_servidor_stats_t *http = http_servidor_stats();
+    int n = snprintf(destino, tamanho,
+                     "# TYPE vaso_temperatura_solo_celsius gauge\nvaso_temperatura_solo_celsius %.2f\n"
+                     "# TYPE vaso_umidade_sensor_volts gauge\nvaso_umidade_sensor_volts %.3f\n"
+                     "# TYPE vaso_uptime_segundos counter\nvaso_uptime_segundos %lu\n"
+                     "vaso_http_conexoes_total %u\nvaso_http_conexoes_recusadas_total %u\n"
+                     "vaso_http_requisicoes_total %u\nvaso_http_bytes_total %u\nvaso_http_atualizacoes_total %u\n",
+                     temperatura, umidade_v, instante_s, http->conexoes, http->recusadas,
+                     http->requisicoes, http->bytes, http->atualizacoes);
+    return n > 0 ? (size_t)n : 0;
+}
+
+static void encerrar(cliente_t *c) {
+    while (c->quantidade) {
+        http_servidor_liberar(c->fila[c->inicio].buffer);
+        c->inicio = (c->inicio + 1) % EM_VOO;
+        --c->quantidade;
+    }
+    // Descarta o que o cliente ainda enviou: fechar com dados não lidos gera um RST,
+    // que pode fazer o cliente perder as últimas respostas
+    char descarte[512];
+    shutdown(c->fd, SHUT_WR);
+    while (recv(c->fd, descarte, sizeof(descarte), 0) > 0) {}
+    close(c->fd);
+    c->fd = -1;
+}
+
+// Lê requisições da entrada enquanto houver espaço na fila de respostas
+static void processar(cliente_t *c) {
+    while (c->entrada_inicio < c->entrada_fim && c->quantidade < EM_VOO && !c->leitor.fechar) {
+        bool pronta;
+        uint8_t i = (c->inicio + c->quantidade) % EM_VOO;
+        c->entrada_inicio += http_conexao_receber(&c->leitor, c->entrada + c->entrada_inicio,
+                                                  c->entrada_fim - c->entrada_inicio, &c->fila[i], &pronta);
+        if (pronta) ++c->quantidade;
+    }
+    if (c->entrada_inicio == c->entrada_fim) c->entrada_inicio = c->entrada_fim = 0;
+}
+
+// Envia o que o kernel aceitar; o send copia, então o buffer é liberado ao fim de cada resposta
+static int escrever(cliente_t *c) {
+    while (c->quantidade) {
+        const http_resposta_t *r = &c->fila[c->inicio];
+        ssize_t n = send(c->fd, r->dados + c->parcial, r->tamanho - c->parcial, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN ? 1 : 0;
+        c->parcial += (uint16_t)n;
+        if (c->parcial < r->tamanho) return 1;
+        c->parcial = 0;
+        http_servidor_liberar(r->buffer);
+        c->inicio = (c->inicio + 1) % EM_VOO;
+        --c->quantidade;
+    }
+    return !c->leitor.fechar;
+}
+
+static void parar(int sinal) {
+    (void)sinal;
+    sair = 1;
+}
+
+int main(int argc, char **argv) {
+    int porta = 8081, opt;
+    while ((opt = getopt(argc, argv, "p:")) != -1) {
+        if (opt == 'p') porta = atoi(optarg);
+        else {
+            fprintf(stderr, "uso: %s [-p porta]\n", argv[0]);
+            return 1;
+        }
+    }
+    signal(SIGINT, parar);
+
+    int servidor = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int um = 1;
+    setsockopt(servidor, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    struct sockaddr_in endereco = {.sin_family = AF_INET, .sin_port = htons(porta), .sin_addr.s_addr = INADDR_ANY};
+    if (bind(servidor, (struct sockaddr *)&endereco, sizeof(endereco)) < 0 || listen(servidor, 128) < 0) {
+        perror("bind/listen");
+        return 1;
+    }
+    printf("Servidor HTTP de host em http://localhost:%d/data.json e /metrics\n", porta);
+
+    http_servidor_init(gerar_json, gerar_metricas);
+    http_servidor_publicar();
+    for (int i = 0; i < MAX_CLIENTES; ++i) clientes[i].fd = -1;
+    time_t ultima_leitura = time(NULL);
+
+    static struct pollfd fds[MAX_CLIENTES + 1];
+    static int indices[MAX_CLIENTES + 1];
+    while (!sair) {
+        // Leitura nova a cada segundo: só então as respostas são refeitas
+        time_t agora = time(NULL);
+        if (agora != ultima_leitura) {
+            ultima_leitura = agora;
+            ++instante_s;
+            temperatura += (rand() % 3 - 1) * 0.0625;
+            umidade_v += (rand() % 3 - 1) * 0.001;
+            http_servidor_publicar();
+        }
+
+        int n = 0;
+        fds[n].fd = servidor;
+        fds[n++].events = POLLIN;
+        for (int i = 0; i < MAX_CLIENTES; ++i) {
+            if (clientes[i].fd < 0) continue;
+            indices[n] = i;
+            fds[n].fd = clientes[i].fd;
+            fds[n++].events = (clientes[i].quantidade ? POLLOUT : 0) |
+                              (clientes[i].entrada_fim < sizeof(clientes[i].entrada) ? POLLIN : 0);
+        }
+        if (poll(fds, n, 100) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            return 1;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(servidor, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+                int livre = -1;
+                for (int i = 0; i < MAX_CLIENTES && livre < 0; ++i) {
+                    if (clientes[i].fd < 0) livre = i;
+                }
+                http_servidor_contar_conexao(livre >= 0);
+                if (livre < 0) {
+                    close(fd);
+                    continue;
+                }
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+                cliente_t *c = &clientes[livre];
+                memset(c, 0, sizeof(*c));
+                c->fd = fd;
+                http_conexao_iniciar(&c->leitor);
+            }
+        }
+
+        for (int k = 1; k < n; ++k) {
+            cliente_t *c = &clientes[indices[k]];
+            if (fds[k].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ssize_t lidos = recv(c->fd, c->entrada + c->entrada_fim, sizeof(c->entrada) - c->entrada_fim, 0);
+                if (lidos == 0 || (lidos < 0 && errno != EAGAIN)) {
+                    encerrar(c);
+                    continue;
+                }
+                if (lidos > 0) c->entrada_fim += (size_t)lidos;
+            }
+            processar(c);
+            if (!escrever(c)) {
+                encerrar(c);
+                continue;
+            }
+            processar(c);  // Requisições que esperavam espaço na fila
+            if (c->quantidade && !escrever(c)) encerrar(c);
+        }
+    }
+
+    const http_servidor_stats_t *stats = http_servidor_stats();
+    printf("\n%u conexoes, %u requisicoes, %u atualizacoes (%u adiadas)\n", stats->conexoes,
+           stats->requisicoes, stats->atualizacoes, stats->atualizacoes_adiadas);
+    return 0;
+}
@@ -0,0 +1,188 @@
+// http_standin.c
+// Servidor HTTP/1.1 mínimo que substitui o ThingSpeak na rede local para
+// medir os envios da placa (conexão persistente, pipelining e reconexão).
+//
+// Cada requisição recebe "200 OK" com o número da entrada no corpo, como o
+// ThingSpeak. O servidor registra em que conexão chegou cada requisição e o
+// intervalo desde a anterior; a latência de cada envio é medida pela placa
+// (ver ts_stats()) e impressa no monitor serial.
+//
+// Compilação:  gcc -O2 -Wall tools/http_standin.c -o http_standin
+// Uso:         ./http_standin [-p porta] [-d atraso_ms] [-c respostas_por_conexao] [-k]
+//   -d  atrasa cada resposta (simula um servidor distante)
+//   -c  responde com "Connection: close" a cada N respostas (testa a reconexão)
+//   -k  usa Transfer-Encoding: chunked em vez de Content-Length
+// Na placa, defina THINGSPEAK_HOST como o IP deste computador e THINGSPEAK_PORT como a porta.
+#define _GNU_SOURCE  // memmem
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define MAX_CLIENTES 8
+#define BUFFER 4096
+
+typedef struct {
+    int fd;
+    unsigned id;            // Número da conexão
+    unsigned respostas;     // Respostas enviadas nesta conexão
+    size_t usado;
+    char buffer[BUFFER];
+} cliente_t;
+
+static cliente_t clientes[MAX_CLIENTES];
+static unsigned atraso_ms = 0, fechar_a_cada = 0, conexoes = 0, entradas = 0;
+static int chunked = 0;
+static double ultima_ms = 0;
+
+static double agora_ms(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e3 + t.tv_nsec / 1e6;
+}
+
+static void encerrar(cliente_t *c) {
+    printf("[conexao %u] fechada apos %u respostas\n", c->id, c->respostas);
+    close(c->fd);
+    c->fd = -1;
+}
+
+// Responde a uma requisição completa; retorna 0 se a conexão deve ser fechada
+static int responder(cliente_t *c, const char *linha) {
+    double t = agora_ms();
+    printf("[conexao %u] #%u %s (%.0f ms desde a anterior)\n", c->id, c->respostas + 1, linha,
+           ultima_ms ? t - ultima_ms : 0.0);
+    ultima_ms = t;
+
+    if (atraso_ms) usleep(atraso_ms * 1000);
+
+    ++entradas;
+    ++c->respostas;
+    int fechar = fechar_a_cada && c->respostas % fechar_a_cada == 0;
+
+    char corpo[16], resposta[256];
+    int n_corpo = snprintf(corpo, sizeof(corpo), "%u", entradas);
+    int n;
+    if (chunked) {
+        n = snprintf(resposta, sizeof(resposta),
+                     "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nTransfer-Encoding: chunked\r\n%s\r\n"
+                     "%x\r\n%s\r\n0\r\n\r\n",
+                     fechar ? "Connection: close\r\n" : "", n_corpo, corpo);
+    } else {
+        n = snprintf(resposta, sizeof(resposta),
+                     "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\n%s\r\n%s",
+                     n_corpo, fechar ? "Connection: close\r\n" : "", corpo);
+    }
+    if (send(c->fd, resposta, n, MSG_NOSIGNAL) != n) return 0;
+    return !fechar;
+}
+
+// Consome as requisições completas do buffer (várias podem chegar juntas com pipelining)
+static int processar(cliente_t *c) {
+    for (;;) {
+        char *fim = memmem(c->buffer, c->usado, "\r\n\r\n", 4);
+        if (!fim) return 1;
+        size_t tamanho = fim + 4 - c->buffer;
+
+        char linha[160];
+        size_t n = strcspn(c->buffer, "\r\n");
+        if (n >= sizeof(linha)) n = sizeof(linha) - 1;
+        memcpy(linha, c->buffer, n);
+        linha[n] = '\0';
+
+        // Corpo de POST com Content-Length
+        const char *cl = memmem(c->buffer, tamanho, "Content-Length:", 15);
+        if (cl) {
+            size_t corpo = strtoul(cl + 15, NULL, 10);
+            if (c->usado < tamanho + corpo) return 1;
+            tamanho += corpo;
+        }
+
+        int continuar = responder(c, linha);
+        memmove(c->buffer, c->buffer + tamanho, c->usado - tamanho);
+        c->usado -= tamanho;
+        if (!continuar) return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    int porta = 8080, opt;
+    while ((opt = getopt(argc, argv, "p:d:c:k")) != -1) {
+        switch (opt) {
+        case 'p': porta = atoi(optarg); break;
+        case 'd': atraso_ms = (unsigned)atoi(optarg); break;
+        case 'c': fechar_a_cada = (unsigned)atoi(optarg); break;
+        case 'k': chunked = 1; break;
+        default:
+            fprintf(stderr, "uso: %s [-p porta] [-d atraso_ms] [-c respostas_por_conexao] [-k]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int servidor = socket(AF_INET, SOCK_STREAM, 0);
+    int um = 1;
+    setsockopt(servidor, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    struct sockaddr_in endereco = {.sin_family = AF_INET, .sin_port = htons(porta), .sin_addr.s_addr = INADDR_ANY};
+    if (bind(servidor, (struct sockaddr *)&endereco, sizeof(endereco)) < 0 || listen(servidor, 4) < 0) {
+        perror("bind/listen");
+        return 1;
+    }
+    printf("Servidor substituto do ThingSpeak na porta %d\n", porta);
+
+    for (int i = 0; i < MAX_CLIENTES; ++i) clientes[i].fd = -1;
+
+    for (;;) {
+        struct pollfd fds[MAX_CLIENTES + 1];
+        int indices[MAX_CLIENTES + 1], n = 0;
+        fds[n].fd = servidor;
+        fds[n++].events = POLLIN;
+        for (int i = 0; i < MAX_CLIENTES; ++i) {
+            if (clientes[i].fd < 0) continue;
+            indices[n] = i;
+            fds[n].fd = clientes[i].fd;
+            fds[n++].events = POLLIN;
+        }
+        if (poll(fds, n, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            return 1;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            struct sockaddr_in origem;
+            socklen_t tamanho = sizeof(origem);
+            int fd = accept(servidor, (struct sockaddr *)&origem, &tamanho);
+            int livre = -1;
+            for (int i = 0; i < MAX_CLIENTES && livre < 0; ++i) {
+                if (clientes[i].fd < 0) livre = i;
+            }
+            if (fd >= 0 && livre >= 0) {
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+                clientes[livre] = (cliente_t){.fd = fd, .id = ++conexoes};
+                printf("[conexao %u] aberta por %s\n", conexoes, inet_ntoa(origem.sin_addr));
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        for (int k = 1; k < n; ++k) {
+            if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            cliente_t *c = &clientes[indices[k]];
+            ssize_t lidos = recv(c->fd, c->buffer + c->usado, BUFFER - c->usado, 0);
+            if (lidos <= 0) {
+                encerrar(c);
+                continue;
+            }
+            c->usado += (size_t)lidos;
+            if (!processar(c) || c->usado == BUFFER) encerrar(c);
+        }
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""
+img2page.py - converte icones BMP/PNG para o formato nativo de paginas do SSD1306.
+
+O formato de saida e o mesmo da GDDRAM do display: cada byte guarda 8 pixels
+verticais (bit 0 = pixel de cima) e os bytes sao ordenados por pagina e depois
+por coluna. Assim o ssd1306_blit_image() copia bytes inteiros para o buffer em
+vez de desenhar pixel a pixel.
+
+Opcionalmente os dados sao comprimidos com RLE no estilo PackBits:
+    c < 0x80  -> seguem (c + 1) bytes literais
+    c >= 0x80 -> o proximo byte se repete ((c & 0x7F) + 1) vezes
+
+Seguindo a convencao do ssd1306_bmp_show_image(), pixels escuros acendem o
+display (use --invert para o contrario). Pixels transparentes ficam apagados.
+
+Uso:
+    python3 tools/img2page.py [--rle {auto,on,off}] [--invert] [--threshold N]
+                              -o icons.h icons/*.bmp icons/*.png
+
+Usa apenas a biblioteca padrao do Python (zlib para o PNG).
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+
+def read_bmp(data):
+    """Retorna (largura, altura, linhas) com cada pixel como (luminancia, alfa)."""
+    if data[:2] != b'BM':
+        raise ValueError('nao e um arquivo BMP')
+    off_bits, = struct.unpack_from('<I', data, 10)
+    bi_size, = struct.unpack_from('<I', data, 14)
+    width, height, _, bpp, compression = struct.unpack_from('<iiHHI', data, 18)
+    if compression not in (0, 3):
+        raise ValueError('BMP comprimido nao suportado')
+    if bpp not in (1, 4, 8, 24, 32):
+        raise ValueError('BMP de %d bits por pixel nao suportado' % bpp)
+
+    palette = []
+    if bpp <= 8:
+        colors_used, = struct.unpack_from('<I', data, 46)
+        n = colors_used or (1 << bpp)
+        base = 14 + bi_size
+        for i in range(n):
+            b, g, r = data[base + 4 * i:base + 4 * i + 3]
+            palette.append((r, g, b))
+
+    bottom_up = height > 0
+    height = abs(height)
+    stride = ((width * bpp + 31) // 32) * 4
+    rows = []
+    for y in range(height):
+        src = y if not bottom_up else height - 1 - y
+        line = data[off_bits + src * stride:off_bits + (src + 1) * stride]
+        row = []
+        for x in range(width):
+            if bpp <= 8:
+                bit = x * bpp
+                idx = (line[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1)
+                r, g, b = palette[idx]
+                a = 255
+            elif bpp == 24:
+                b, g, r = line[3 * x:3 * x + 3]
+                a = 255
+            else:
+                b, g, r, a = line[4 * x:4 * x + 4]
+                if compression == 0:
+                    a = 255
+            row.append((luminance(r, g, b), a))
+        rows.append(row)
+    return width, height, rows
+
+
+def read_png(data):
+    """Decodificador PNG minimo (sem entrelacamento)."""
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('nao e um arquivo PNG')
+    pos = 8
+    idat = b''
+    palette = []
+    trns = b''
+    width = height = depth = ctype = None
+    while pos < len(data):
+        length, kind = struct.unpack_from('>I4s', data, pos)
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, ctype, _, _, interlace = struct.unpack('>IIBBBBB', body)
+            if interlace:
+                raise ValueError('PNG entrelacado nao suportado')
+        elif kind == b'PLTE':
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b'tRNS':
+            trns = body
+        elif kind == b'IDAT':
+            idat += body
+        elif kind == b'IEND':
+            break
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[ctype]
+    if depth == 16:
+        raise ValueError('PNG de 16 bits nao suportado')
+    bpp = max(1, channels * depth // 8)
+    stride = (width * channels * depth + 7) // 8
+    raw = zlib.decompress(idat)
+
+    rows = []
+    prev = bytearray(stride)
+    for y in range(height):
+        ftype = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                pa, pb, pc = abs(b - c), abs(a - c), abs(a + b - 2 * c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                line[i] = (line[i] + pred) & 0xFF
+        prev = line
+
+        row = []
+        for x in range(width):
+            if depth < 8:
+                bit = x * depth
+                v = (line[bit >> 3] >> (8 - depth - (bit & 7))) & ((1 << depth) - 1)
+                if ctype == 3:
+                    r, g, b = palette[v]
+                    a = trns[v] if v < len(trns) else 255
+                    row.append((luminance(r, g, b), a))
+                else:
+                    row.append((v * 255 // ((1 << depth) - 1), 255))
+                continue
+            px = line[x * channels:(x + 1) * channels]
+            if ctype == 0:
+                row.append((px[0], 255))
+            elif ctype == 2:
+                row.append((luminance(*px), 255))
+            elif ctype == 3:
+                r, g, b = palette[px[0]]
+                a = trns[px[0]] if px[0] < len(trns) else 255
+                row.append((luminance(r, g, b), a))
+            elif ctype == 4:
+                row.append((px[0], px[1]))
+            else:
+                row.append((luminance(*px[:3]), px[3]))
+        rows.append(row)
+    return width, height, rows
+
+
+def luminance(r, g, b):
+    return (299 * r + 587 * g + 114 * b) // 1000
+
+
+def to_pages(width, height, rows, threshold, invert):
+    """Gera os bytes ordenados por pagina (8 pixels verticais por byte)."""
+    pages = (height + 7) // 8
+    out = bytearray(pages * width)
+    for y in range(height):
+        for x in range(width):
+            lum, alpha = rows[y][x]
+            lit = alpha >= 128 and ((lum < threshold) != invert)
+            if lit:
+                out[(y >> 3) * width + x] |= 1 << (y & 7)
+    return bytes(out)
+
+
+def rle_encode(data):
+    """RLE estilo PackBits; repeticoes de 3 ou mais bytes viram um par."""
+    out = bytearray()
+    literal = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 128:
+            run += 1
+        if run >= 3:
+            while literal:
+                chunk = literal[:128]
+                out.append(len(chunk) - 1)
+                out += chunk
+                literal = literal[128:]
+            out.append(0x80 | (run - 1))
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    while literal:
+        chunk = literal[:128]
+        out.append(len(chunk) - 1)
+        out += chunk
+        literal = literal[128:]
+    return bytes(out)
+
+
+def c_name(path):
+    name = os.path.splitext(os.path.basename(path))[0]
+    name = re.sub(r'[^0-9A-Za-z_]', '_', name)
+    if name[0].isdigit():
+        name = '_' + name
+    return 'icon_' + name
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('images', nargs='+', help='arquivos BMP ou PNG')
+    ap.add_argument('-o', '--output', help='cabecalho C gerado (padrao: stdout)')
+    ap.add_argument('--rle', choices=('auto', 'on', 'off'), default='auto',
+                    help='auto usa RLE apenas quando reduz o tamanho')
+    ap.add_argument('--threshold', type=int, default=128,
+                    help='luminancia abaixo da qual o pixel acende (0-255)')
+    ap.add_argument('--invert', action='store_true', help='pixels claros acendem')
+    args = ap.parse_args()
+
+    guard = 'GENERATED_ICONS_H'
+    if args.output:
+        guard = '_inc_' + re.sub(r'[^0-9A-Za-z]', '_', os.path.basename(args.output)).lower()
+
+    lines = [
+        '// ------------------------------------------------------------ //',
+        '// Arquivo gerado por tools/img2page.py; nao edite manualmente! //',
+        '// ------------------------------------------------------------ //',
+        '',
+        '#ifndef %s' % guard,
+        '#define %s' % guard,
+        '',
+        '#include "ssd1306.h"',
+        '',
+    ]
+    total_raw = total_out = 0
+    for path in args.images:
+        with open(path, 'rb') as f:
+            blob = f.read()
+        if blob[:2] == b'BM':
+            w, h, rows = read_bmp(blob)
+        else:
+            w, h, rows = read_png(blob)
+        if w > 255 or h > 255:
+            raise SystemExit('%s: imagem maior que 255x255' % path)
+
+        raw = to_pages(w, h, rows, args.threshold, args.invert)
+        packed = rle_encode(raw)
+        use_rle = args.rle == 'on' or (args.rle == 'auto' and len(packed) < len(raw))
+        data = packed if use_rle else raw
+        total_raw += len(raw)
+        total_out += len(data)
+
+        name = c_name(path)
+        lines.append('// %s: %ux%u, %u bytes%s' % (os.path.basename(path), w, h, len(data),
+                                                  ' (RLE, %u sem compressao)' % len(raw) if use_rle else ''))
+        lines.append('static const uint8_t %s_data[] = {' % name)
+        for i in range(0, len(data), 12):
+            lines.append('    ' + ', '.join('0x%02X' % b for b in data[i:i + 12]) + ',')
+        lines.append('};')
+        lines.append('static const ssd1306_image_t %s = {%u, %u, %s, sizeof(%s_data), %s_data};'
+                     % (name, w, h, 'SSD1306_IMG_RLE' if use_rle else '0', name, name))
+        lines.append('')
+
+    lines.append('#endif')
+    text = '\n'.join(lines) + '\n'
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+        print('%d imagens: %d bytes (%d sem RLE)' % (len(args.images), total_out, total_raw),
+              file=sys.stderr)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
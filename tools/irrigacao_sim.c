@@ -0,0 +1,130 @@
+// irrigacao_sim.c
+// Simulação do controle de irrigação (irrigacao.c) contra um modelo simples do
+// vaso, para validar e ajustar os parâmetros antes de ligar a bomba de verdade.
+//
+// O vaso tem duas camadas. A bomba molha a de cima, que guarda pouca água: o
+// que passa da capacidade escorre pelo vaso e é perdido. Da camada de cima, a
+// água infiltra na camada das raízes, onde está o sensor, com uma constante de
+// tempo de alguns minutos. A camada das raízes perde água pela planta (mais de
+// dia que de noite) e drena acima da capacidade de campo. O sensor responde com
+// atraso e ruído e é lido pelo laço principal a cada 1,3 s; o controlador roda
+// a cada 100 ms, como no temporizador do firmware.
+//
+// Compara a histerese com ciclos de pulso e molho com a mesma histerese de uma
+// vez só (sem molho), e simula um sensor solto no segundo dia para exercitar a
+// trava de tempo ligado.
+//
+// Compilação:  gcc -O2 -Wall -I. tools/irrigacao_sim.c irrigacao.c -lm -o irrigacao_sim
+// Uso:         ./irrigacao_sim [liga_% desliga_% pulso_s molho_s]
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "irrigacao.h"
+
+#define PASSO_MS 100                    // Período do controlador
+#define LEITURA_MS 1300                 // Uma volta do laço principal
+#define DIAS 3
+#define VAZAO 6.0                       // % de umidade por minuto de bomba, na camada de cima
+#define CIMA_MAX 8.0                    // Água que a camada de cima segura antes de escorrer
+#define INFILTRACAO_MIN 4.0             // Constante de tempo da infiltração
+#define CAPACIDADE_CAMPO 65.0           // Acima disso a camada das raízes drena
+#define DRENAGEM_MIN 30.0
+#define SENSOR_MIN 1.0                  // Atraso do sensor
+
+typedef struct {
+    double cima, raiz, sensor;
+    double perdida, bomba_min;
+    double minimo, maximo, seco_min;    // seco_min: minutos abaixo de 25%
+    unsigned ligacoes;
+} vaso_t;
+
+static double ruido(double amplitude) {
+    return amplitude * (2.0 * rand() / RAND_MAX - 1.0);
+}
+
+// Consumo da planta em % por minuto: ~0,005 à noite, ~0,035 ao meio-dia
+static double consumo(double hora) {
+    double sol = sin((hora - 6) / 12 * M_PI);
+    return 0.005 + (sol > 0 ? 0.03 * sol : 0);
+}
+
+static void simular(const char *nome, const irrigacao_config_t *config, bool sensor_solto) {
+    irrigacao_t c;
+    irrigacao_init(&c, config, 0);
+    vaso_t v = {.cima = 0, .raiz = 45, .sensor = 45, .minimo = 100, .maximo = 0};
+    srand(1);
+    const double dt = PASSO_MS / 60000.0;  // Minutos por passo
+    int16_t lida = 450;
+    uint32_t leitura_ms = 0;
+    bool ligada = false;
+    for (uint32_t t = 0; t < DIAS * 24u * 3600 * 1000; t += PASSO_MS) {
+        double hora = fmod(t / 3600000.0, 24);
+        if (ligada) {
+            v.cima += VAZAO * dt;
+            v.bomba_min += dt;
+        }
+        if (v.cima > CIMA_MAX) {
+            v.perdida += v.cima - CIMA_MAX;
+            v.cima = CIMA_MAX;
+        }
+        double infiltra = v.cima * dt / INFILTRACAO_MIN;
+        v.cima -= infiltra;
+        v.raiz += infiltra - consumo(hora) * dt;
+        if (v.raiz > CAPACIDADE_CAMPO) {
+            double drena = (v.raiz - CAPACIDADE_CAMPO) * dt / DRENAGEM_MIN;
+            v.raiz -= drena;
+            v.perdida += drena;
+        }
+        v.sensor += (v.raiz - v.sensor) * dt / SENSOR_MIN;
+        if (v.raiz < v.minimo) v.minimo = v.raiz;
+        if (v.raiz > v.maximo && t > 3600000) v.maximo = v.raiz;
+        if (v.raiz < 25) v.seco_min += dt;
+
+        if (t - leitura_ms >= LEITURA_MS) {
+            leitura_ms = t;
+            bool solto = sensor_solto && t >= 30u * 3600 * 1000;  // Solta no segundo dia
+            lida = solto ? 0 : (int16_t)lround((v.sensor + ruido(0.5)) * 10);
+        }
+        bool antes = ligada;
+        ligada = irrigacao_passo(&c, lida, t - leitura_ms, IRRIGACAO_NENHUM, t);
+        if (ligada && !antes) ++v.ligacoes;
+    }
+    printf("%-22s %6.1f %6.1f %6.1f %7.1f %8.1f %7.1f %6u %6u %6u\n", nome, v.minimo, v.maximo, v.seco_min,
+           v.bomba_min / DIAS, v.perdida / DIAS, v.perdida / (v.bomba_min * VAZAO) * 100, c.stats.ciclos,
+           v.ligacoes, c.stats.bloqueios);
+}
+
+int main(int argc, char **argv) {
+    irrigacao_config_t config = {
+        .liga_pdm = 350,
+        .desliga_pdm = 500,
+        .pulso_ms = 20000,
+        .molho_ms = 4 * 60000,
+        .ciclo_max_ms = 5 * 60000,
+        .desligado_min_ms = 30 * 60000,
+        .pausa_ms = 60 * 60000,
+        .bloqueio_ms = 6 * 3600000,
+        .validade_ms = 2 * 60000,
+    };
+    if (argc == 5) {
+        config.liga_pdm = (int16_t)(atof(argv[1]) * 10);
+        config.desliga_pdm = (int16_t)(atof(argv[2]) * 10);
+        config.pulso_ms = (uint32_t)(atof(argv[3]) * 1000);
+        config.molho_ms = (uint32_t)(atof(argv[4]) * 1000);
+    }
+    irrigacao_config_t sem_molho = config;
+    sem_molho.pulso_ms = sem_molho.ciclo_max_ms;
+    sem_molho.molho_ms = 0;
+
+    printf("Histerese %.1f%% a %.1f%%, pulsos de %lu s, molho de %lu s, trava de %lu s por ciclo, %d dias\n\n",
+           config.liga_pdm / 10.0, config.desliga_pdm / 10.0, (unsigned long)config.pulso_ms / 1000,
+           (unsigned long)config.molho_ms / 1000, (unsigned long)config.ciclo_max_ms / 1000, DIAS);
+    printf("%-22s %6s %6s %6s %7s %8s %7s %6s %6s %6s\n", "", "mín%", "máx%", "<25%", "bomba", "perdida",
+           "perda", "ciclos", "liga", "bloq.");
+    printf("%-22s %6s %6s %6s %7s %8s %7s\n", "", "", "", "min", "min/dia", "%/dia", "%");
+    simular("pulso e molho", &config, false);
+    simular("sem molho", &sem_molho, false);
+    simular("pulso e molho, solto", &config, true);
+    return 0;
+}
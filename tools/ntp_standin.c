@@ -0,0 +1,114 @@
+// ntp_standin.c
+// Servidor SNTP mínimo que substitui o pool.ntp.org na rede local para testar a
+// sincronização do relógio da placa (relogio.c).
+//
+// Responde cada consulta com a hora deste computador (CLOCK_REALTIME). Para cada
+// consulta imprime a hora que a placa informou ao enviar e a diferença para a
+// nossa, o que mostra a deriva do cristal entre sincronizações.
+//
+// Compilação:  gcc -O2 -Wall tools/ntp_standin.c -o ntp_standin
+// Uso:         sudo ./ntp_standin [-p porta] [-o deslocamento_s] [-d atraso_ms] [-x n]
+//   -o  soma um deslocamento à hora enviada (simula um servidor adiantado ou atrasado)
+//   -d  atrasa cada resposta entre a recepção e a transmissão (a placa deve descontar)
+//   -x  ignora uma a cada N consultas (testa as novas tentativas)
+// A porta padrão é a 123 (exige root). Com outra porta, defina SNTP_PORT em lwipopts.h.
+// Na placa, defina NTP_SERVIDOR como o IP deste computador.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define NTP_PACOTE 48
+#define NTP_1900_1970 2208988800u   // Segundos entre as épocas do NTP e do UNIX
+
+static void ler_hora(double deslocamento, uint32_t *segundos, uint32_t *fracao) {
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    double s = t.tv_sec + t.tv_nsec / 1e9 + deslocamento;
+    *segundos = (uint32_t)((uint64_t)s + NTP_1900_1970);
+    *fracao = (uint32_t)((s - (double)(uint64_t)s) * 4294967296.0);
+}
+
+static void escrever32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint32_t ler32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static double ntp_para_unix(uint32_t segundos, uint32_t fracao) {
+    return (double)(segundos - NTP_1900_1970) + fracao / 4294967296.0;
+}
+
+int main(int argc, char **argv) {
+    int porta = 123, atraso_ms = 0, ignorar = 0;
+    double deslocamento = 0;
+    int op;
+    while ((op = getopt(argc, argv, "p:o:d:x:")) != -1) {
+        switch (op) {
+        case 'p': porta = atoi(optarg); break;
+        case 'o': deslocamento = atof(optarg); break;
+        case 'd': atraso_ms = atoi(optarg); break;
+        case 'x': ignorar = atoi(optarg); break;
+        default:
+            fprintf(stderr, "uso: ntp_standin [-p porta] [-o deslocamento_s] [-d atraso_ms] [-x n]\n");
+            return 1;
+        }
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in endereco = {.sin_family = AF_INET, .sin_port = htons(porta), .sin_addr.s_addr = INADDR_ANY};
+    if (bind(fd, (struct sockaddr *)&endereco, sizeof(endereco)) < 0) {
+        perror("bind");
+        return 1;
+    }
+    printf("SNTP na porta UDP %d (deslocamento %.3f s, atraso %d ms)\n", porta, deslocamento, atraso_ms);
+
+    unsigned consultas = 0;
+    for (;;) {
+        uint8_t pacote[NTP_PACOTE + 16];
+        struct sockaddr_in cliente;
+        socklen_t tamanho_cliente = sizeof(cliente);
+        ssize_t n = recvfrom(fd, pacote, sizeof(pacote), 0, (struct sockaddr *)&cliente, &tamanho_cliente);
+        uint32_t recebido_s, recebido_f;
+        ler_hora(deslocamento, &recebido_s, &recebido_f);
+        if (n < NTP_PACOTE || (pacote[0] & 0x07) != 3) continue;  // Só consultas de cliente (modo 3)
+        ++consultas;
+
+        // Hora da placa no envio (0 antes da primeira sincronização dela, ou o tempo desde o boot)
+        uint32_t cliente_s = ler32(pacote + 40), cliente_f = ler32(pacote + 44);
+        double diferenca = ntp_para_unix(cliente_s, cliente_f) - ntp_para_unix(recebido_s, recebido_f);
+        printf("#%u de %s: placa %+.3f s em relação a este servidor%s\n", consultas,
+               inet_ntoa(cliente.sin_addr), diferenca,
+               ignorar && consultas % ignorar == 0 ? " (ignorada)" : "");
+        fflush(stdout);
+        if (ignorar && consultas % ignorar == 0) continue;
+
+        if (atraso_ms) usleep(atraso_ms * 1000);
+        uint8_t resposta[NTP_PACOTE] = {0};
+        resposta[0] = (uint8_t)(pacote[0] & 0x38) | 4;  // LI 0, versão do cliente, modo 4 (servidor)
+        resposta[1] = 1;                                // Estrato 1: relógio de referência local
+        resposta[2] = pacote[2];                        // Intervalo de consulta do cliente
+        resposta[3] = (uint8_t)-20;                     // Precisão de ~1 us
+        memcpy(resposta + 12, "LOCL", 4);
+        uint32_t enviado_s, enviado_f;
+        ler_hora(deslocamento, &enviado_s, &enviado_f);
+        escrever32(resposta + 16, recebido_s);          // Referência: a hora atual
+        escrever32(resposta + 20, recebido_f);
+        memcpy(resposta + 24, pacote + 40, 8);          // Origem: o que o cliente enviou
+        escrever32(resposta + 32, recebido_s);          // Recepção
+        escrever32(resposta + 36, recebido_f);
+        escrever32(resposta + 40, enviado_s);           // Transmissão
+        escrever32(resposta + 44, enviado_f);
+        sendto(fd, resposta, sizeof(resposta), 0, (struct sockaddr *)&cliente, tamanho_cliente);
+    }
+}
@@ -0,0 +1,115 @@
+// politica_sim.c
+// Simulação de um dia de leituras passando pela política de envio (politica.c),
+// comparada com o envio fixo a cada 30 s que ela substituiu.
+//
+// As leituras são sintéticas: temperatura com ciclo diário e o ruído de
+// quantização do DS18B20, tensão de umidade subindo enquanto o solo seca, com
+// ruído do ADC, duas irrigações por dia, luz das 6 h às 18 h e, no meio da
+// tarde, um minuto de relé oscilando (mau contato) para exercitar o limite de taxa.
+// Mede envios por dia, latência dos eventos e o maior erro entre a leitura e o
+// último valor enviado. A latência de um evento vai da primeira leitura com um
+// estado diferente do último enviado até o envio; um estado que volta antes
+// disso (oscilação no limiar) não conta como evento.
+//
+// Compilação:  gcc -O2 -Wall -I. tools/politica_sim.c politica.c -lm -o politica_sim
+// Uso:         ./politica_sim [banda_temperatura banda_umidade]
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "politica.h"
+
+#define VOLTA_MS 1300                   // Uma volta do laço principal (DS18B20 + 500 ms)
+#define DIA_MS (24u * 60 * 60 * 1000)
+#define FIXO_MS 30000
+
+typedef struct {
+    float temperatura, umidade_v;
+    bool umido, escuro, irrigando, feliz;
+} leitura_t;
+
+static float ruido(float amplitude) {
+    return amplitude * (2.0f * rand() / RAND_MAX - 1.0f);
+}
+
+static void ler(uint32_t t, leitura_t *l) {
+    double hora = t / 3600000.0;
+    float temperatura = 22.0f + 3.0f * (float)sin((hora - 9) / 24 * 2 * M_PI) + ruido(0.05f);
+    l->temperatura = roundf(temperatura * 16) / 16;  // Resolução de 0,0625 °C
+
+    // Irrigação às 7 h e às 19 h por 2 minutos; entre elas, o solo seca
+    double desde = fmod(hora + 5, 12.0);
+    l->irrigando = desde < 2.0 / 60;
+    if (hora >= 15.5 && hora < 15.5 + 1.0 / 60) l->irrigando = (t / VOLTA_MS) % 2;  // Relé oscilando
+    l->umidade_v = (float)(1.2 + 0.9 * desde / 12) + ruido(0.01f);
+    l->umido = l->umidade_v < 1.8f;
+    l->escuro = hora < 6 || hora >= 18;
+    l->feliz = l->umido && !l->escuro && l->temperatura > 18 && l->temperatura < 30;
+}
+
+int main(int argc, char **argv) {
+    politica_config_t config = {
+        .campos = 6,
+        .banda = {0.25f, 0.05f, 0, 0, 0, 0},
+        .pulsacao_ms = 10 * 60 * 1000,
+        .intervalo_ms = 10000,
+        .rajada = 3,
+    };
+    if (argc == 3) {
+        config.banda[0] = (float)atof(argv[1]);
+        config.banda[1] = (float)atof(argv[2]);
+    }
+    politica_t p;
+    politica_init(&p, &config, 0);
+    srand(1);
+
+    unsigned fixo = 0, eventos = 0, oscilacoes = 0;
+    double latencia_fixo = 0, latencia_politica = 0, erro_temp_max = 0, erro_umid_max = 0;
+    uint32_t latencia_politica_max = 0;
+    leitura_t l;
+    uint32_t evento_ms = 0;
+    bool evento_aberto = false;
+    for (uint32_t t = 0; t < DIA_MS; t += VOLTA_MS) {
+        ler(t, &l);
+        if (t % FIXO_MS < VOLTA_MS) ++fixo;
+
+        float valores[] = {l.temperatura, l.umidade_v, l.umido, l.escuro, l.irrigando, l.feliz};
+        bool diferente = false;
+        for (int i = 2; i < 6; ++i) diferente |= t && valores[i] != p.enviados[i];
+        if (diferente && !evento_aberto) {
+            evento_aberto = true;
+            evento_ms = t;
+        } else if (!diferente && evento_aberto) {
+            evento_aberto = false;  // Voltou ao estado enviado: oscilação, não evento
+            ++oscilacoes;
+        }
+
+        politica_motivo_t motivo = politica_avaliar(&p, valores, t);
+        if (motivo != POLITICA_NADA && evento_aberto) {
+            uint32_t latencia = t - evento_ms;
+            ++eventos;
+            latencia_politica += latencia;
+            if (latencia > latencia_politica_max) latencia_politica_max = latencia;
+            latencia_fixo += FIXO_MS - evento_ms % FIXO_MS;  // Envio fixo: na próxima amostra de 30 s
+            evento_aberto = false;
+        }
+        double erro_temp = fabs(l.temperatura - p.enviados[0]), erro_umid = fabs(l.umidade_v - p.enviados[1]);
+        if (erro_temp > erro_temp_max) erro_temp_max = erro_temp;
+        if (erro_umid > erro_umid_max) erro_umid_max = erro_umid;
+    }
+
+    const politica_stats_t *s = &p.stats;
+    unsigned total = s->envios[POLITICA_PULSACAO] + s->envios[POLITICA_BANDA] + s->envios[POLITICA_EVENTO];
+    printf("Bandas: %.3f °C, %.3f V; pulsação %u s; até %u envios seguidos, 1 a cada %u s em média\n\n",
+           config.banda[0], config.banda[1], config.pulsacao_ms / 1000, config.rajada, config.intervalo_ms / 1000);
+    printf("                           fixo 30 s   política\n");
+    printf("Amostras por dia           %9u  %9u  (pulsação %u, banda %u, evento %u)\n", fixo, total,
+           s->envios[POLITICA_PULSACAO], s->envios[POLITICA_BANDA], s->envios[POLITICA_EVENTO]);
+    printf("Latência média de evento   %8.1f s  %8.1f s  (%u eventos, %u oscilações ignoradas)\n",
+           latencia_fixo / eventos / 1000, latencia_politica / eventos / 1000, eventos, oscilacoes);
+    printf("Latência máxima de evento  %8.1f s  %8.1f s  (%u adiados pelo limite)\n", FIXO_MS / 1000.0,
+           latencia_politica_max / 1000.0, s->adiados);
+    printf("Maior erro, temperatura        -      %6.3f °C\n", erro_temp_max);
+    printf("Maior erro, umidade            -      %6.3f V\n", erro_umid_max);
+    return 0;
+}
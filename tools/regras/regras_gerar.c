@@ -0,0 +1,235 @@
+// regras_gerar.c
+// Gera a tabela binária de perfis de planta (formato em regras.h) a partir de um
+// arquivo de texto, confere uma tabela gerada e simula um dia com o perfil de um
+// vaso, contando quantas leituras precisaram de avaliação.
+//
+// Compilação e uso (a partir da raiz do repositório):
+//   gcc -O2 -Wall -I. tools/regras/regras_gerar.c regras.c -lm -o regras_gerar
+//   ./regras_gerar tools/regras/perfis.txt perfis.bin
+//   ./regras_gerar -l perfis.bin              (lista os perfis e as regras)
+//   ./regras_gerar -s perfis.bin [vaso]       (um dia de leituras sintéticas)
+// Gravação na placa (setor logo antes do histórico, numa flash de 2 MB):
+//   picotool load -t bin -o 0x101BF000 perfis.bin
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "regras.h"
+
+#define TABELA_MAX 4096                 // Um setor da flash
+
+static const char *const nomes_entrada[REGRAS_ENTRADAS] = {"temperatura", "umidade", "luz"};
+static const double escala[REGRAS_ENTRADAS] = {100, 10, 1};  // Unidade do texto -> inteiro da regra
+
+static regras_perfil_t perfis[255];
+static regras_regra_t regras[255];
+static uint8_t vasos[255];
+static uint64_t roms[255];              // DS18B20 de cada vaso (modo frota), 0 = sem sensor
+static int n_perfis, n_regras, n_vasos;
+static bool com_roms;
+
+static int erro(int linha, const char *mensagem) {
+    fprintf(stderr, "linha %d: %s\n", linha, mensagem);
+    return 1;
+}
+
+// Limite de uma faixa no texto: um número na unidade da entrada, ou "-" para
+// deixar o lado aberto (INT16_MIN no mínimo, INT16_MAX no máximo)
+static bool ler_limite(const char *texto, int entrada, int16_t aberto, int16_t *limite) {
+    if (strcmp(texto, "-") == 0) {
+        *limite = aberto;
+        return true;
+    }
+    char *fim;
+    double valor = strtod(texto, &fim) * escala[entrada];
+    if (fim == texto || *fim || valor <= INT16_MIN || valor >= INT16_MAX) return false;
+    *limite = (int16_t)lround(valor);
+    return true;
+}
+
+static int achar_perfil(const char *nome) {
+    for (int i = 0; i < n_perfis; ++i) {
+        if (strncmp(perfis[i].nome, nome, REGRAS_NOME_MAX) == 0) return i;
+    }
+    return -1;
+}
+
+static int gerar(const char *texto, const char *saida) {
+    FILE *f = fopen(texto, "r");
+    if (!f) {
+        perror(texto);
+        return 1;
+    }
+    char linha[256];
+    for (int n = 1; fgets(linha, sizeof(linha), f); ++n) {
+        char *comentario = strchr(linha, '#');
+        if (comentario) *comentario = 0;
+        char palavra[32], nome[32], min[32], max[32];
+        int lidos;
+        if (sscanf(linha, "%31s%n", palavra, &lidos) != 1) continue;
+        char *resto = linha + lidos;
+
+        if (strcmp(palavra, "perfil") == 0) {
+            if (sscanf(resto, "%31s", nome) != 1 || strlen(nome) > REGRAS_NOME_MAX) return erro(n, "nome de perfil");
+            if (n_perfis == 255 || achar_perfil(nome) >= 0) return erro(n, "perfil repetido ou perfis demais");
+            regras_perfil_t *p = &perfis[n_perfis++];
+            strncpy(p->nome, nome, REGRAS_NOME_MAX);
+            p->primeira = (uint8_t)n_regras;
+        } else if (strcmp(palavra, "vaso") == 0) {
+            int vaso, perfil;
+            if (sscanf(resto, "%d %31s%n", &vaso, nome, &lidos) != 2 || vaso < 0 || vaso > 254) return erro(n, "vaso");
+            if ((perfil = achar_perfil(nome)) < 0) return erro(n, "perfil desconhecido");
+            while (n_vasos <= vaso) vasos[n_vasos++] = 0;
+            vasos[vaso] = (uint8_t)perfil;
+            char opcao[32];
+            unsigned long long rom;
+            if (sscanf(resto + lidos, "%31s %llx", opcao, &rom) == 2) {
+                if (strcmp(opcao, "ds18b20") != 0 || !rom) return erro(n, "opção do vaso");
+                roms[vaso] = rom;
+                com_roms = true;
+            }
+        } else {
+            int e = 0;
+            while (e < REGRAS_ENTRADAS && strcmp(palavra, nomes_entrada[e]) != 0) ++e;
+            if (e == REGRAS_ENTRADAS) return erro(n, "entrada desconhecida");
+            if (!n_perfis) return erro(n, "regra antes de um perfil");
+            regras_regra_t faixa = {.entrada = (uint8_t)e};
+            if (sscanf(resto, "%31s %31s%n", min, max, &lidos) != 2 || !ler_limite(min, e, INT16_MIN, &faixa.min) ||
+                !ler_limite(max, e, INT16_MAX, &faixa.max) || faixa.min > faixa.max) {
+                return erro(n, "faixa");
+            }
+            regras_perfil_t *p = &perfis[n_perfis - 1];
+            if (n_regras == 255 || p->quantidade == REGRAS_POR_PERFIL_MAX) return erro(n, "regras demais");
+            regras_regra_t *r = &regras[n_regras++];
+            ++p->quantidade;
+            *r = faixa;
+            char opcao[32];
+            double valor;
+            int mais;
+            for (resto += lidos; sscanf(resto, "%31s %lf%n", opcao, &valor, &mais) == 2; resto += mais) {
+                if (strcmp(opcao, "histerese") == 0) {
+                    r->histerese = (int16_t)lround(valor * escala[e]);
+                } else if (strcmp(opcao, "duracao") == 0 && valor >= 0 && valor <= 65535) {
+                    r->duracao_s = (uint16_t)valor;
+                } else {
+                    return erro(n, "opção da regra");
+                }
+            }
+        }
+    }
+    fclose(f);
+    if (!n_perfis) return erro(0, "nenhum perfil");
+
+    static uint8_t tabela[TABELA_MAX];
+    regras_cabecalho_t c = {.magica = REGRAS_MAGICA, .versao = REGRAS_VERSAO, .perfis = (uint8_t)n_perfis,
+                            .regras = (uint8_t)n_regras, .vasos = (uint8_t)n_vasos,
+                            .roms = (uint8_t)(com_roms ? n_vasos : 0)};
+    size_t pos = sizeof(c);
+    memcpy(tabela + pos, perfis, n_perfis * sizeof(perfis[0]));
+    pos += n_perfis * sizeof(perfis[0]);
+    memcpy(tabela + pos, regras, n_regras * sizeof(regras[0]));
+    pos += n_regras * sizeof(regras[0]);
+    memcpy(tabela + pos, vasos, n_vasos);
+    pos += n_vasos;
+    for (int i = 0; i < c.roms; ++i) {
+        for (int b = 0; b < 8; ++b) tabela[pos++] = (uint8_t)(roms[i] >> 8 * b);
+    }
+    c.tamanho = (uint16_t)(pos - sizeof(c));
+    c.crc = regras_crc16(tabela + sizeof(c), c.tamanho);
+    memcpy(tabela, &c, sizeof(c));
+
+    regras_tabela_t conferida;
+    if (!regras_carregar(&conferida, tabela, pos)) return erro(0, "tabela gerada inválida");
+    FILE *s = fopen(saida, "wb");
+    if (!s || fwrite(tabela, 1, pos, s) != pos || fclose(s)) {
+        perror(saida);
+        return 1;
+    }
+    printf("%s: %d perfis, %d regras, %d vasos%s, %zu bytes\n", saida, n_perfis, n_regras, n_vasos,
+           com_roms ? " com mapa de DS18B20" : "", pos);
+    return 0;
+}
+
+static int abrir(const char *arquivo, regras_tabela_t *t) {
+    static uint8_t tabela[TABELA_MAX];
+    FILE *f = fopen(arquivo, "rb");
+    if (!f) {
+        perror(arquivo);
+        return 1;
+    }
+    size_t tamanho = fread(tabela, 1, sizeof(tabela), f);
+    fclose(f);
+    if (!regras_carregar(t, tabela, tamanho)) {
+        fprintf(stderr, "%s: tabela inválida (mágica, versão, tamanho, CRC ou índices)\n", arquivo);
+        return 1;
+    }
+    return 0;
+}
+
+static void listar(const regras_tabela_t *t) {
+    for (uint8_t i = 0; i < t->perfis; ++i) {
+        const regras_perfil_t *p = &t->perfil[i];
+        printf("perfil %.*s\n", REGRAS_NOME_MAX, p->nome);
+        for (uint8_t j = p->primeira; j < p->primeira + p->quantidade; ++j) {
+            const regras_regra_t *r = &t->regra[j];
+            double k = escala[r->entrada];
+            printf("  %-12s ", nomes_entrada[r->entrada]);
+            if (r->min == INT16_MIN) printf("%7s ", "-");
+            else printf("%7.2f ", r->min / k);
+            if (r->max == INT16_MAX) printf("%7s", "-");
+            else printf("%7.2f", r->max / k);
+            printf("  histerese %.2f  duracao %u s\n", r->histerese / k, r->duracao_s);
+        }
+    }
+    for (uint8_t i = 0; i < t->vasos; ++i) {
+        uint64_t rom = regras_rom_do_vaso(t, i);
+        printf("vaso %u %.*s", i, REGRAS_NOME_MAX, t->perfil[t->vaso[i]].nome);
+        if (rom) printf(" ds18b20 %016llx", (unsigned long long)rom);
+        printf("\n");
+    }
+}
+
+// Um dia a cada 1,3 s (uma volta do laço): temperatura com ciclo diário e a
+// quantização do DS18B20, umidade caindo de 70 % a 30 % com ruído, luz das 6 h às 18 h
+static void simular(const regras_tabela_t *t, uint8_t vaso) {
+    regras_vaso_t v;
+    regras_vaso_init(&v, t, regras_perfil_do_vaso(t, vaso));
+    srand(1);
+    uint32_t voltas = 0, triste_ms = 0;
+    for (uint32_t ms = 0; ms < 24u * 3600 * 1000; ms += 1300, ++voltas) {
+        double hora = ms / 3600000.0;
+        double temperatura = 23 + 6 * sin((hora - 9) / 24 * 2 * M_PI) + 0.05 * (2.0 * rand() / RAND_MAX - 1);
+        double umidade = 70 - 40 * hora / 24 + 0.5 * (2.0 * rand() / RAND_MAX - 1);
+        regras_atualizar(&v, REGRAS_TEMPERATURA, (int16_t)(round(temperatura * 16) / 16 * 100), ms);
+        regras_atualizar(&v, REGRAS_UMIDADE, (int16_t)lround(umidade * 10), ms);
+        regras_atualizar(&v, REGRAS_LUZ, hora >= 6 && hora < 18, ms);
+        regras_tempo(&v, ms);
+        if (!v.feliz) triste_ms += 1300;
+    }
+    printf("vaso %u, perfil %.*s: %lu voltas, %lu leituras, %lu avaliações (%.2f%%), %lu mudanças, triste %.1f h\n",
+           vaso, REGRAS_NOME_MAX, v.perfil, (unsigned long)voltas, (unsigned long)v.stats.entradas,
+           (unsigned long)v.stats.avaliacoes, 100.0 * v.stats.avaliacoes / v.stats.entradas,
+           (unsigned long)v.stats.mudancas, triste_ms / 3600000.0);
+}
+
+int main(int argc, char **argv) {
+    regras_tabela_t t;
+    if (argc >= 3 && strcmp(argv[1], "-l") == 0) {
+        if (abrir(argv[2], &t)) return 1;
+        listar(&t);
+        return 0;
+    }
+    if (argc >= 3 && strcmp(argv[1], "-s") == 0) {
+        if (abrir(argv[2], &t)) return 1;
+        if (argc > 3) {
+            simular(&t, (uint8_t)atoi(argv[3]));
+        } else {
+            for (uint8_t i = 0; i < (t.vasos ? t.vasos : 1); ++i) simular(&t, i);
+        }
+        return 0;
+    }
+    if (argc == 3) return gerar(argv[1], argv[2]);
+    fprintf(stderr, "uso: %s perfis.txt perfis.bin | -l perfis.bin | -s perfis.bin [vaso]\n", argv[0]);
+    return 1;
+}
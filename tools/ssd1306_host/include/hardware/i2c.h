@@ -0,0 +1,19 @@
+// Shim de host: o barramento I2C é atendido pelo modelo do SSD1306 em ssd1306_host.c.
+#ifndef SSD1306_HOST_HARDWARE_I2C_H
+#define SSD1306_HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst {
+    uint baudrate;  // Frequência configurada em i2c_init(), usada na estimativa de tempo no fio
+} i2c_inst_t;
+
+extern i2c_inst_t ssd1306_host_i2c[2];
+#define i2c0 (&ssd1306_host_i2c[0])
+#define i2c1 (&ssd1306_host_i2c[1])
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us);
+
+#endif
@@ -0,0 +1,4 @@
+// Shim de host: o emulador não usa binary_info.
+#ifndef SSD1306_HOST_PICO_BINARY_INFO_H
+#define SSD1306_HOST_PICO_BINARY_INFO_H
+#endif
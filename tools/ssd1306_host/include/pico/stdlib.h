@@ -0,0 +1,14 @@
+// Shim de host: subconjunto de pico/stdlib.h usado pelo driver SSD1306 e pela camada de widgets.
+#ifndef SSD1306_HOST_PICO_STDLIB_H
+#define SSD1306_HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+#endif
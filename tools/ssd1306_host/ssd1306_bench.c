@@ -0,0 +1,133 @@
+// ssd1306_bench.c
+// Mede o tráfego I2C de cada forma de atualizar o display e salva as imagens
+// reconstruídas pelo emulador (ssd1306_host.c) para comparação com imagens de referência.
+//
+// Compilação e execução (a partir da raiz do repositório):
+//   gcc -O2 -Wall -Itools/ssd1306_host/include -Itools/ssd1306_host -I.
+//       tools/ssd1306_host/ssd1306_bench.c tools/ssd1306_host/ssd1306_host.c
+//       ssd1306.c oled_ui.c -o ssd1306_bench
+//   ./ssd1306_bench [diretorio_de_saida]
+#include <stdio.h>
+#include <string.h>
+
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "oled_ui.h"
+#include "icons.h"
+#include "ssd1306_host.h"
+
+#define I2C_FREQUENCIA 1000000  // Mesma frequência configurada em Projeto-Final.c
+
+static const char *diretorio = ".";
+
+// Imprime uma linha da tabela com as estatísticas acumuladas e zera os contadores
+static void relatar(const char *cenario) {
+    const ssd1306_host_stats_t *s = ssd1306_host_stats();
+    printf("%-38s %6u %7u %7u %7u %10.1f\n", cenario, s->transacoes, s->bytes,
+           s->bytes_comando, s->bytes_dados, s->tempo_fio_us);
+    ssd1306_host_stats_reset();
+}
+
+static void salvar(const char *nome) {
+    char caminho[256];
+    snprintf(caminho, sizeof(caminho), "%s/%s.pbm", diretorio, nome);
+    if (!ssd1306_host_write_pbm(caminho)) fprintf(stderr, "falha ao salvar %s\n", caminho);
+    snprintf(caminho, sizeof(caminho), "%s/%s.png", diretorio, nome);
+    if (!ssd1306_host_write_png(caminho)) fprintf(stderr, "falha ao salvar %s\n", caminho);
+}
+
+// Tela como era desenhada antes dos widgets: limpa, formata e reenvia tudo
+static void quadro_completo(ssd1306_t *oled) {
+    char buffer[32];
+    ssd1306_clear(oled);
+    snprintf(buffer, sizeof(buffer), "Umidade solo: %s", "Umido");
+    ssd1306_draw_string(oled, 0, 0, 1, buffer);
+    snprintf(buffer, sizeof(buffer), "Temp. Solo: %.2f C", 25.5);
+    ssd1306_draw_string(oled, 0, 16, 1, buffer);
+    snprintf(buffer, sizeof(buffer), "Luz: %s", "Detectada");
+    ssd1306_draw_string(oled, 0, 32, 1, buffer);
+    snprintf(buffer, sizeof(buffer), "Irrigacao: %s", "Desativada");
+    ssd1306_draw_string(oled, 0, 48, 1, buffer);
+    ssd1306_show(oled);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) diretorio = argv[1];
+
+    ssd1306_host_reset(true);
+    i2c_init(i2c1, I2C_FREQUENCIA);
+
+    printf("I2C a %u Hz\n", I2C_FREQUENCIA);
+    printf("%-38s %6s %7s %7s %7s %10s\n", "cenario", "trans", "bytes", "cmd", "dados", "fio (us)");
+
+    ssd1306_t oled;
+    ssd1306_init(&oled, 128, 64, 0x3C, i2c1);
+    relatar("ssd1306_init");
+
+    quadro_completo(&oled);
+    relatar("quadro completo (clear + show)");
+    salvar("quadro_completo");
+
+    // Mesma tela com widgets: o primeiro desenho envia cada widget uma vez
+    ssd1306_clear(&oled);
+    ssd1306_show(&oled);
+    ssd1306_host_stats_reset();
+
+    ui_widget_t r1, v1, r2, v2, r3, v3, r4, v4, g1, g2, icone;
+    static ui_historico_t h1, h2;
+    ui_label(&r1, 0, 0, "Umidade solo:");
+    ui_label(&v1, 14 * UI_FONTE_LARGURA, 0, "Umido");
+    ui_label(&r2, 0, 8, "Temp. Solo:");
+    ui_value(&v2, 12 * UI_FONTE_LARGURA, 8, 2, 2, " C");
+    ui_label(&r3, 0, 16, "Luz:");
+    ui_label(&v3, 5 * UI_FONTE_LARGURA, 16, "Detectada");
+    ui_label(&r4, 0, 24, "Irrigacao:");
+    ui_label(&v4, 11 * UI_FONTE_LARGURA, 24, "Desativada");
+    ui_sparkline(&g1, &h1, 0, 32, 128, 16, 1000, 4000);
+    ui_sparkline(&g2, &h2, 0, 48, 128, 16, 0, 3300);
+    ui_icon(&icone, 112, 16, &icon_planta_feliz);
+    ui_set_value(&v2, 2550);
+    ui_widget_t *const widgets[] = {&r1, &v1, &r2, &v2, &r3, &v3, &r4, &v4, &g1, &g2, &icone};
+    const uint n = sizeof(widgets) / sizeof(widgets[0]);
+
+    ui_render(&oled, widgets, n);
+    relatar("widgets: primeiro desenho");
+
+    ui_render(&oled, widgets, n);
+    relatar("widgets: sem mudancas");
+
+    ui_set_value(&v2, 2562);
+    ui_render(&oled, widgets, n);
+    relatar("widgets: temperatura mudou");
+
+    ui_set_text(&v4, "Ativada");
+    ui_set_icon(&icone, &icon_gota);
+    ui_render(&oled, widgets, n);
+    relatar("widgets: irrigacao + icone mudaram");
+
+    for (int i = 0; i < 140; ++i) {
+        ui_push_sample(&g1, 2000 + (i % 40) * 25);
+        ui_push_sample(&g2, 1500 + ((i * 7) % 50) * 20);
+        ui_render(&oled, widgets, n);
+        if (i == 0) relatar("graficos: primeira amostra");
+    }
+    ssd1306_host_stats_reset();
+    ui_push_sample(&g1, 2500);
+    ui_push_sample(&g2, 1800);
+    ui_render(&oled, widgets, n);
+    relatar("graficos: nova amostra (regime)");
+    salvar("widgets");
+
+    ssd1306_blit_image(&oled, &icon_wifi_on, 0, 0, SSD1306_BLIT_COPY);
+    ssd1306_show_area(&oled, 0, 0, icon_wifi_on.width, icon_wifi_on.height);
+    relatar("icone 16x16 (blit + show_area)");
+
+    ssd1306_show_area(&oled, 0, 0, 128, 8);
+    relatar("uma pagina inteira (show_area)");
+
+    ssd1306_set_start_line(&oled, 8);
+    relatar("troca de linha inicial");
+    salvar("linha_inicial_8");
+
+    return 0;
+}
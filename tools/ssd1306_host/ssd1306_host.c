@@ -0,0 +1,294 @@
+// ssd1306_host.c
+// Modelo do controlador SSD1306 atrás do barramento I2C emulado (ver ssd1306_host.h).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/i2c.h"
+#include "ssd1306_host.h"
+
+i2c_inst_t ssd1306_host_i2c[2] = {{100000}, {100000}};
+
+static ssd1306_host_t painel;
+static ssd1306_host_stats_t stats;
+
+// Comando em andamento (os argumentos podem chegar em transações separadas)
+static uint8_t comando;
+static uint8_t argumentos[8];
+static uint8_t argumentos_lidos, argumentos_esperados;
+
+//-----------------------------------------------------------------------------------------------------
+// Estado e estatísticas
+//-----------------------------------------------------------------------------------------------------
+void ssd1306_host_reset(bool aleatorio) {
+    memset(&painel, 0, sizeof(painel));
+    if (aleatorio) {
+        for (uint32_t p = 0; p < SSD1306_HOST_LINHAS / 8; ++p)
+            for (uint32_t c = 0; c < SSD1306_HOST_COLUNAS; ++c)
+                painel.gddram[p][c] = (uint8_t)rand();
+    }
+    painel.endereco_i2c = 0x3C;
+    painel.contraste = 0x7F;
+    painel.mux = SSD1306_HOST_LINHAS - 1;
+    painel.modo_endereco = 2;                 // Modo página após o reset do controlador
+    painel.col_fim = SSD1306_HOST_COLUNAS - 1;
+    painel.pag_fim = SSD1306_HOST_LINHAS / 8 - 1;
+    argumentos_esperados = argumentos_lidos = 0;
+    ssd1306_host_stats_reset();
+}
+
+const ssd1306_host_t *ssd1306_host_state(void) {
+    return &painel;
+}
+
+const ssd1306_host_stats_t *ssd1306_host_stats(void) {
+    return &stats;
+}
+
+void ssd1306_host_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Interpretação dos comandos
+//-----------------------------------------------------------------------------------------------------
+static uint8_t argumentos_do_comando(uint8_t cmd) {
+    switch (cmd) {
+    case 0x81: case 0x20: case 0xA8: case 0xD3: case 0xDA:
+    case 0xD5: case 0xD9: case 0xDB: case 0x8D:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void executar_comando(uint8_t cmd, const uint8_t *arg) {
+    if (cmd >= 0x40 && cmd <= 0x7F) { painel.linha_inicial = cmd & 0x3F; return; }
+    if (cmd >= 0xB0 && cmd <= 0xB7) { painel.pag = cmd & 0x07; return; }                        // Modo página
+    if (cmd <= 0x0F) { painel.col = (painel.col & 0xF0) | cmd; return; }                        // Modo página
+    if (cmd >= 0x10 && cmd <= 0x1F) { painel.col = (painel.col & 0x0F) | ((cmd & 0x0F) << 4); return; }
+
+    switch (cmd) {
+    case 0xAE: case 0xAF: painel.ligado = cmd & 1; break;
+    case 0xA6: case 0xA7: painel.invertido = cmd & 1; break;
+    case 0xA4: case 0xA5: painel.tudo_aceso = cmd & 1; break;
+    case 0xA0: case 0xA1: painel.seg_remap = cmd & 1; break;
+    case 0xC0: painel.com_invertido = false; break;
+    case 0xC8: painel.com_invertido = true; break;
+    case 0x81: painel.contraste = arg[0]; break;
+    case 0xA8: painel.mux = arg[0] & 0x3F; break;
+    case 0xD3: painel.offset = arg[0] & 0x3F; break;
+    case 0x20: painel.modo_endereco = arg[0] & 0x03; break;
+    case 0x21:
+        painel.col = painel.col_inicio = arg[0] & 0x7F;
+        painel.col_fim = arg[1] & 0x7F;
+        break;
+    case 0x22:
+        painel.pag = painel.pag_inicio = arg[0] & 0x07;
+        painel.pag_fim = arg[1] & 0x07;
+        break;
+    case 0x2E: painel.rolando = false; break;
+    case 0x2F: painel.rolando = true; break;
+    default: break; // Temporização, bomba de carga etc. não afetam a imagem
+    }
+}
+
+static void receber_comando(uint8_t byte) {
+    ++stats.bytes_comando;
+    if (argumentos_esperados) {
+        argumentos[argumentos_lidos++] = byte;
+        if (argumentos_lidos == argumentos_esperados) {
+            argumentos_esperados = 0;
+            executar_comando(comando, argumentos);
+        }
+        return;
+    }
+    comando = byte;
+    argumentos_lidos = 0;
+    argumentos_esperados = argumentos_do_comando(byte);
+    if (!argumentos_esperados)
+        executar_comando(comando, argumentos);
+}
+
+// Escrita na GDDRAM com avanço do ponteiro conforme o modo de endereçamento
+static void receber_dado(uint8_t byte) {
+    ++stats.bytes_dados;
+    painel.gddram[painel.pag & 7][painel.col & 0x7F] = byte;
+
+    switch (painel.modo_endereco) {
+    case 0: // Horizontal
+        if (painel.col++ >= painel.col_fim) {
+            painel.col = painel.col_inicio;
+            if (painel.pag++ >= painel.pag_fim) painel.pag = painel.pag_inicio;
+        }
+        break;
+    case 1: // Vertical
+        if (painel.pag++ >= painel.pag_fim) {
+            painel.pag = painel.pag_inicio;
+            if (painel.col++ >= painel.col_fim) painel.col = painel.col_inicio;
+        }
+        break;
+    default: // Página: a coluna volta ao início sem mudar de página
+        if (painel.col++ >= painel.col_fim) painel.col = painel.col_inicio;
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Barramento I2C
+//-----------------------------------------------------------------------------------------------------
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    // START + endereço (9 bits com ACK) + 9 bits por byte + STOP
+    ++stats.transacoes;
+    stats.bytes += len;
+    stats.tempo_fio_us += (1.0 + 9.0 * (len + 1) + (nostop ? 0.0 : 1.0)) * 1e6 / i2c->baudrate;
+
+    if (addr != painel.endereco_i2c) {
+        ++stats.nacks;
+        return PICO_ERROR_GENERIC;
+    }
+
+    // Cada byte de controle: Co (bit 7) indica se vem outro byte de controle após
+    // o próximo byte; D/C# (bit 6) indica se os bytes seguintes são dados ou comandos
+    size_t i = 0;
+    while (i < len) {
+        uint8_t controle = src[i++];
+        bool continua = controle & 0x80;
+        bool dados = controle & 0x40;
+
+        if (continua) {
+            if (i < len) {
+                if (dados) receber_dado(src[i]); else receber_comando(src[i]);
+                ++i;
+            }
+            continue;
+        }
+        for (; i < len; ++i) {
+            if (dados) receber_dado(src[i]); else receber_comando(src[i]);
+        }
+    }
+    return (int)len;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us) {
+    (void)timeout_us;
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+//-----------------------------------------------------------------------------------------------------
+// Reconstrução da imagem
+//-----------------------------------------------------------------------------------------------------
+
+// Orientação relativa à inicialização do driver (A1 + C8 = imagem na posição normal)
+bool ssd1306_host_pixel(uint32_t x, uint32_t y) {
+    if (x >= SSD1306_HOST_COLUNAS || y > painel.mux || !painel.ligado) return false;
+    if (painel.tudo_aceso) return true;
+
+    uint32_t coluna = painel.seg_remap ? x : SSD1306_HOST_COLUNAS - 1 - x;
+    uint32_t linha = painel.com_invertido ? y : painel.mux - y;
+    linha = (linha + painel.linha_inicial) % SSD1306_HOST_LINHAS;
+
+    bool aceso = (painel.gddram[linha >> 3][coluna] >> (linha & 7)) & 1;
+    return aceso != painel.invertido;
+}
+
+bool ssd1306_host_write_pbm(const char *caminho) {
+    FILE *f = fopen(caminho, "wb");
+    if (!f) return false;
+
+    const uint32_t linhas = painel.mux + 1;
+    fprintf(f, "P4\n%u %u\n", SSD1306_HOST_COLUNAS, linhas);
+    for (uint32_t y = 0; y < linhas; ++y) {
+        uint8_t linha[SSD1306_HOST_COLUNAS / 8] = {0};
+        for (uint32_t x = 0; x < SSD1306_HOST_COLUNAS; ++x)
+            if (!ssd1306_host_pixel(x, y)) linha[x >> 3] |= 0x80 >> (x & 7); // PBM: 1 = preto (apagado)
+        fwrite(linha, 1, sizeof(linha), f);
+    }
+    return fclose(f) == 0;
+}
+
+static uint32_t crc32_png(uint32_t crc, const uint8_t *dados, size_t n) {
+    crc = ~crc;
+    while (n--) {
+        crc ^= *dados++;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static void be32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+static void escrever_chunk(FILE *f, const char *tipo, const uint8_t *dados, uint32_t n) {
+    uint8_t cabecalho[8];
+    be32(cabecalho, n);
+    memcpy(cabecalho + 4, tipo, 4);
+    fwrite(cabecalho, 1, 8, f);
+    if (n) fwrite(dados, 1, n, f);
+    uint8_t crc[4];
+    be32(crc, crc32_png(crc32_png(0, (const uint8_t *)tipo, 4), dados, n));
+    fwrite(crc, 1, 4, f);
+}
+
+// PNG em tons de cinza (pixel aceso = branco, como no painel), com blocos
+// deflate sem compressão para não depender da zlib
+bool ssd1306_host_write_png(const char *caminho) {
+    const uint32_t largura = SSD1306_HOST_COLUNAS, altura = painel.mux + 1;
+    const uint32_t cru = altura * (largura + 1);  // Byte de filtro + pixels por linha
+    uint8_t bruto[SSD1306_HOST_LINHAS * (SSD1306_HOST_COLUNAS + 1)];
+
+    for (uint32_t y = 0, i = 0; y < altura; ++y) {
+        bruto[i++] = 0;
+        for (uint32_t x = 0; x < largura; ++x)
+            bruto[i++] = ssd1306_host_pixel(x, y) ? 0xFF : 0x00;
+    }
+
+    // zlib: cabeçalho, um bloco "stored" (cabe em 65535 bytes) e Adler-32
+    static uint8_t idat[2 + 5 + sizeof(bruto) + 4];
+    uint32_t n = 0, a = 1, b = 0;
+    idat[n++] = 0x78;
+    idat[n++] = 0x01;
+    idat[n++] = 0x01;                       // BFINAL = 1, BTYPE = 00
+    idat[n++] = cru & 0xFF;
+    idat[n++] = cru >> 8;
+    idat[n++] = ~cru & 0xFF;
+    idat[n++] = (~cru >> 8) & 0xFF;
+    memcpy(idat + n, bruto, cru);
+    n += cru;
+    for (uint32_t i = 0; i < cru; ++i) {
+        a = (a + bruto[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    be32(idat + n, (b << 16) | a);
+    n += 4;
+
+    FILE *f = fopen(caminho, "wb");
+    if (!f) return false;
+
+    static const uint8_t assinatura[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13];
+    be32(ihdr, largura);
+    be32(ihdr + 4, altura);
+    ihdr[8] = 8;   // 8 bits por pixel
+    ihdr[9] = 0;   // Tons de cinza
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+    fwrite(assinatura, 1, sizeof(assinatura), f);
+    escrever_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    escrever_chunk(f, "IDAT", idat, n);
+    escrever_chunk(f, "IEND", NULL, 0);
+    return fclose(f) == 0;
+}
@@ -0,0 +1,66 @@
+// ssd1306_host.h
+// Emulador de host (Linux) do controlador SSD1306 para o driver ssd1306.c.
+//
+// O driver é compilado sem alterações contra os shims de include/; cada
+// i2c_write_blocking() é interpretado como o controlador faria (byte de
+// controle, comandos com argumentos, modos de endereçamento e escrita na
+// GDDRAM). Com isso é possível:
+//   - reconstruir a imagem do painel e salvá-la em PBM/PNG;
+//   - contar bytes e transações I2C por quadro e estimar o tempo no fio
+//     na frequência configurada em i2c_init().
+#ifndef SSD1306_HOST_H
+#define SSD1306_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SSD1306_HOST_COLUNAS 128
+#define SSD1306_HOST_LINHAS 64
+
+// Contadores de tráfego I2C (zerados por ssd1306_host_stats_reset)
+typedef struct {
+    uint32_t transacoes;      // START ... STOP
+    uint32_t bytes;           // Bytes após o endereço (inclui os bytes de controle)
+    uint32_t bytes_comando;   // Bytes interpretados como comando ou argumento
+    uint32_t bytes_dados;     // Bytes escritos na GDDRAM
+    uint32_t nacks;           // Transações para endereços sem dispositivo
+    double tempo_fio_us;      // Estimativa de tempo no barramento
+} ssd1306_host_stats_t;
+
+// Estado do controlador emulado
+typedef struct {
+    uint8_t gddram[SSD1306_HOST_LINHAS / 8][SSD1306_HOST_COLUNAS];
+    uint8_t endereco_i2c;     // Endereço ao qual o painel responde (padrão 0x3C)
+    bool ligado;              // AE/AF
+    bool invertido;           // A6/A7
+    bool tudo_aceso;          // A4/A5
+    bool seg_remap;           // A0/A1
+    bool com_invertido;       // C0/C8
+    uint8_t contraste;
+    uint8_t linha_inicial;    // 40-7F
+    uint8_t offset;           // D3
+    uint8_t mux;              // A8 (linhas ativas - 1)
+    uint8_t modo_endereco;    // 20: 0 horizontal, 1 vertical, 2 página
+    uint8_t col_inicio, col_fim, col;
+    uint8_t pag_inicio, pag_fim, pag;
+    bool rolando;             // 2F/2E
+} ssd1306_host_t;
+
+// Reinicia o controlador (GDDRAM aleatória como num painel real, se `aleatorio`)
+void ssd1306_host_reset(bool aleatorio);
+
+// Acesso ao estado emulado
+const ssd1306_host_t *ssd1306_host_state(void);
+
+// Estatísticas acumuladas desde o último reset das estatísticas
+const ssd1306_host_stats_t *ssd1306_host_stats(void);
+void ssd1306_host_stats_reset(void);
+
+// Pixel visível no painel (considera linha inicial, remapeamentos, inversão e liga/desliga)
+bool ssd1306_host_pixel(uint32_t x, uint32_t y);
+
+// Salva a imagem visível do painel; retornam false em erro de E/S
+bool ssd1306_host_write_pbm(const char *caminho);
+bool ssd1306_host_write_png(const char *caminho);
+
+#endif
@@ -0,0 +1,210 @@
+// coletor.c
+// Coletor de referência da telemetria UDP (telemetria_protocolo.h): recebe os
+// datagramas de muitos vasos, verifica o CRC, acompanha a sequência de cada
+// dispositivo (perdas, atrasos e reinícios) e grava uma linha CSV por amostra.
+//
+// Os datagramas são lidos em rajadas com recvmmsg() e o CSV sai por um buffer
+// grande, sem uma escrita por amostra. A cada segundo imprime as taxas em stderr.
+//
+// Compilação:  gcc -O2 -Wall -I. tools/telemetria/coletor.c telemetria_protocolo.c -o coletor
+// Uso:         ./coletor [-p porta] [-o arquivo.csv | -o -] [-t segundos] [-q]
+//              -o -  grava em stdout;  -q  só decodifica (sem CSV), para medir
+#define _GNU_SOURCE  // recvmmsg
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "telemetria_protocolo.h"
+
+#define RAJADA 64                   // Datagramas por recvmmsg()
+#define DISPOSITIVOS_MAX (1 << 16)  // Capacidade da tabela (potência de 2)
+#define CSV_BUFFER (1 << 20)
+
+// Estado de um dispositivo na tabela de espalhamento (endereçamento aberto)
+typedef struct {
+    uint32_t id;
+    bool usado;
+    uint32_t proxima;       // Sequência esperada
+    uint64_t datagramas;
+    uint64_t perdidos;      // Lacunas na sequência
+    uint64_t atrasados;     // Abaixo da esperada: duplicados ou fora de ordem
+    uint32_t reinicios;     // Sequência voltou a 0 (reboot da placa)
+} dispositivo_t;
+
+static dispositivo_t tabela[DISPOSITIVOS_MAX];
+static uint32_t dispositivos;
+
+typedef struct {
+    uint64_t datagramas, amostras, bytes, invalidos, perdidos, atrasados;
+} totais_t;
+
+static totais_t total;
+static volatile sig_atomic_t parar;
+
+static void ao_sinal(int s) {
+    (void)s;
+    parar = 1;
+}
+
+static double agora_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static dispositivo_t *buscar(uint32_t id) {
+    uint32_t h = (id * 2654435761u) & (DISPOSITIVOS_MAX - 1);
+    while (tabela[h].usado && tabela[h].id != id) h = (h + 1) & (DISPOSITIVOS_MAX - 1);
+    if (!tabela[h].usado) {
+        if (dispositivos == DISPOSITIVOS_MAX - 1) return NULL;  // Tabela cheia
+        tabela[h].usado = true;
+        tabela[h].id = id;
+        ++dispositivos;
+    }
+    return &tabela[h];
+}
+
+// Compara a sequência recebida com a esperada. Retorna false para datagramas atrasados,
+// que não são gravados de novo (um duplicado repetiria as amostras no CSV).
+static bool acompanhar(dispositivo_t *d, uint32_t sequencia) {
+    if (d->datagramas && sequencia == 0 && d->proxima != 0) {
+        ++d->reinicios;  // A placa reiniciou: a contagem recomeça
+    } else if (d->datagramas && sequencia != d->proxima) {
+        int32_t diferenca = (int32_t)(sequencia - d->proxima);
+        if (diferenca < 0) {
+            ++d->atrasados;
+            ++total.atrasados;
+            return false;
+        }
+        d->perdidos += (uint32_t)diferenca;
+        total.perdidos += (uint32_t)diferenca;
+    }
+    ++d->datagramas;
+    d->proxima = sequencia + 1;
+    return true;
+}
+
+static void uso(void) {
+    fprintf(stderr, "uso: coletor [-p porta] [-o arquivo.csv | -o -] [-t segundos] [-q]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    int porta = 5005, duracao = 0;
+    const char *saida = "telemetria.csv";
+    bool sem_csv = false;
+    int op;
+    while ((op = getopt(argc, argv, "p:o:t:q")) != -1) {
+        switch (op) {
+        case 'p': porta = atoi(optarg); break;
+        case 'o': saida = optarg; break;
+        case 't': duracao = atoi(optarg); break;
+        case 'q': sem_csv = true; break;
+        default: uso();
+        }
+    }
+
+    FILE *csv = NULL;
+    if (!sem_csv) {
+        csv = strcmp(saida, "-") ? fopen(saida, "a") : stdout;
+        if (!csv) {
+            perror(saida);
+            return 1;
+        }
+        setvbuf(csv, NULL, _IOFBF, CSV_BUFFER);
+        fseek(csv, 0, SEEK_END);  // Cabeçalho só num arquivo novo
+        if (ftell(csv) <= 0) fprintf(csv, "dispositivo,sequencia,instante_s,temperatura_c,umidade_mv,estados\n");
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int buffer = 8 << 20;  // Absorve rajadas enquanto o CSV é gravado (limitado por rmem_max)
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    struct sockaddr_in endereco = {.sin_family = AF_INET, .sin_port = htons(porta), .sin_addr.s_addr = INADDR_ANY};
+    if (bind(fd, (struct sockaddr *)&endereco, sizeof(endereco)) < 0) {
+        perror("bind");
+        return 1;
+    }
+    struct timeval espera = {.tv_sec = 0, .tv_usec = 200000};  // Acorda para imprimir as taxas
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &espera, sizeof(espera));
+
+    signal(SIGINT, ao_sinal);
+    signal(SIGTERM, ao_sinal);
+    fprintf(stderr, "Coletor na porta UDP %d, gravando em %s\n", porta, sem_csv ? "(nada)" : saida);
+
+    static uint8_t dados[RAJADA][TLM_DATAGRAMA_MAX + 1];  // +1: detecta datagramas maiores
+    struct mmsghdr mensagens[RAJADA];
+    struct iovec vetores[RAJADA];
+    for (int i = 0; i < RAJADA; ++i) {
+        vetores[i] = (struct iovec){dados[i], sizeof(dados[i])};
+        mensagens[i] = (struct mmsghdr){.msg_hdr = {.msg_iov = &vetores[i], .msg_iovlen = 1}};
+    }
+
+    double inicio = agora_s(), proximo_relatorio = inicio + 1;
+    totais_t anterior = total;
+    tlm_cabecalho_t cabecalho;
+    tlm_amostra_t amostras[TLM_MAX_AMOSTRAS];
+    while (!parar) {
+        int n = recvmmsg(fd, mensagens, RAJADA, MSG_WAITFORONE, NULL);
+        if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            perror("recvmmsg");
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            total.bytes += mensagens[i].msg_len;
+            if (tlm_decodificar(dados[i], mensagens[i].msg_len, &cabecalho, amostras) != TLM_OK) {
+                ++total.invalidos;
+                continue;
+            }
+            dispositivo_t *d = buscar(cabecalho.dispositivo);
+            if (!d || !acompanhar(d, cabecalho.sequencia)) continue;
+            ++total.datagramas;
+            total.amostras += cabecalho.quantidade;
+            if (!csv) continue;
+            for (int k = 0; k < cabecalho.quantidade; ++k) {
+                const tlm_amostra_t *a = &amostras[k];
+                int t = a->temperatura_centi;
+                char temperatura[12] = "";  // Vazia sem leitura
+                if (t != TLM_SEM_TEMPERATURA) {
+                    snprintf(temperatura, sizeof(temperatura), "%s%d.%02d", t < 0 ? "-" : "", abs(t) / 100, abs(t) % 100);
+                }
+                fprintf(csv, "%08x,%u,%u,%s,%u,%u\n", cabecalho.dispositivo, cabecalho.sequencia,
+                        a->instante_s, temperatura, a->umidade_mv, a->estados);
+            }
+        }
+
+        double agora = agora_s();
+        if (agora >= proximo_relatorio) {
+            fprintf(stderr, "%8.0f datagramas/s %9.0f amostras/s  dispositivos %u  perdidos %lu  "
+                            "atrasados %lu  inválidos %lu\n",
+                    (double)(total.datagramas - anterior.datagramas),
+                    (double)(total.amostras - anterior.amostras), dispositivos,
+                    (unsigned long)total.perdidos, (unsigned long)total.atrasados,
+                    (unsigned long)total.invalidos);
+            anterior = total;
+            proximo_relatorio = agora + 1;
+        }
+        if (duracao && agora - inicio >= duracao) break;
+    }
+
+    if (csv) fflush(csv);
+    double tempo = agora_s() - inicio;
+    uint32_t reinicios = 0;
+    for (uint32_t i = 0; i < DISPOSITIVOS_MAX; ++i) reinicios += tabela[i].reinicios;
+    fprintf(stderr,
+            "\nTotal em %.1f s: %lu datagramas (%.0f/s), %lu amostras (%.0f/s), %lu bytes\n"
+            "%u dispositivos, %lu datagramas perdidos, %lu atrasados, %lu inválidos, %u reinícios\n",
+            tempo, (unsigned long)total.datagramas, total.datagramas / tempo, (unsigned long)total.amostras,
+            total.amostras / tempo, (unsigned long)total.bytes, dispositivos, (unsigned long)total.perdidos,
+            (unsigned long)total.atrasados, (unsigned long)total.invalidos, reinicios);
+    if (csv && csv != stdout) fclose(csv);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,138 @@
+// gerador.c
+// Gerador de carga para o coletor de telemetria: simula muitos vasos enviando
+// datagramas no formato de telemetria_protocolo.h, com a mesma codificação do
+// firmware, e mede a taxa alcançada.
+//
+// Os datagramas saem em rajadas com sendmmsg(), em rodízio entre os dispositivos.
+// Com -e, uma fração leva o CRC corrompido; com -l, uma fração é "perdida"
+// (a sequência avança sem envio), para conferir as contagens do coletor.
+//
+// Compilação:  gcc -O2 -Wall -I. tools/telemetria/gerador.c telemetria_protocolo.c -o gerador
+// Uso:         ./gerador [-d dispositivos] [-r datagramas/s] [-t segundos] [-a amostras]
+//                        [-e fração] [-l fração] ip porta
+//              -r 0 envia o mais rápido possível
+#define _GNU_SOURCE  // sendmmsg
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "telemetria_protocolo.h"
+
+#define RAJADA 64  // Datagramas por sendmmsg()
+
+static double agora_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void uso(void) {
+    fprintf(stderr, "uso: gerador [-d dispositivos] [-r datagramas/s] [-t segundos] [-a amostras] "
+                    "[-e fração] [-l fração] ip porta\n");
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    int quantidade = 1000, taxa = 0, duracao = 10, por_datagrama = 10;
+    double erro = 0, perda = 0;
+    int op;
+    while ((op = getopt(argc, argv, "d:r:t:a:e:l:")) != -1) {
+        switch (op) {
+        case 'd': quantidade = atoi(optarg); break;
+        case 'r': taxa = atoi(optarg); break;
+        case 't': duracao = atoi(optarg); break;
+        case 'a': por_datagrama = atoi(optarg); break;
+        case 'e': erro = atof(optarg); break;
+        case 'l': perda = atof(optarg); break;
+        default: uso();
+        }
+    }
+    if (argc - optind != 2 || quantidade < 1 || por_datagrama < 1 || por_datagrama > TLM_MAX_AMOSTRAS) uso();
+
+    struct sockaddr_in destino = {.sin_family = AF_INET, .sin_port = htons(atoi(argv[optind + 1]))};
+    if (inet_pton(AF_INET, argv[optind], &destino.sin_addr) != 1) uso();
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (connect(fd, (struct sockaddr *)&destino, sizeof(destino)) < 0) {
+        perror("connect");
+        return 1;
+    }
+
+    // Cada dispositivo guarda a sua sequência e o seu relógio
+    uint32_t *sequencias = calloc(quantidade, sizeof(uint32_t));
+    uint32_t *relogios = calloc(quantidade, sizeof(uint32_t));
+    for (int i = 0; i < quantidade; ++i) relogios[i] = 1700000000u + (uint32_t)i;
+
+    static uint8_t dados[RAJADA][TLM_DATAGRAMA_MAX];
+    struct mmsghdr mensagens[RAJADA];
+    struct iovec vetores[RAJADA];
+    tlm_amostra_t amostras[TLM_MAX_AMOSTRAS];
+    srand(1);
+
+    unsigned long enviados = 0, corrompidos = 0, pulados = 0, bytes = 0;
+    int proximo = 0;
+    double inicio = agora_s(), fim = inicio + duracao;
+    for (;;) {
+        double agora = agora_s();
+        if (agora >= fim) break;
+        // Com taxa definida, espera até o instante da próxima rajada
+        if (taxa) {
+            double previsto = inicio + (double)enviados / taxa;
+            if (previsto > agora) {
+                struct timespec pausa = {0, (long)((previsto - agora) * 1e9)};
+                nanosleep(&pausa, NULL);
+            }
+        }
+
+        int n = 0;
+        while (n < RAJADA) {
+            int d = proximo;
+            proximo = (proximo + 1) % quantidade;
+            for (int k = 0; k < por_datagrama; ++k) {
+                int ruido = rand() % 200;
+                amostras[k] = (tlm_amostra_t){
+                    .instante_s = relogios[d],
+                    .temperatura_centi = (int16_t)(2200 + ruido - 100),
+                    .umidade_mv = (uint16_t)(1500 + ruido * 5),
+                    .estados = (uint8_t)(ruido & 0x0F),
+                };
+                relogios[d] += 30;
+            }
+            uint32_t sequencia = sequencias[d]++;
+            if (perda && rand() < perda * RAND_MAX) {
+                ++pulados;  // O coletor deve contar esta lacuna
+                continue;
+            }
+            size_t tamanho = tlm_codificar(dados[n], sequencia, 0x10000000u + (uint32_t)d, amostras,
+                                           (uint8_t)por_datagrama);
+            if (erro && rand() < erro * RAND_MAX) {
+                dados[n][TLM_CABECALHO] ^= 0x01;  // Amostra alterada: o CRC não confere
+                ++corrompidos;
+            }
+            vetores[n] = (struct iovec){dados[n], tamanho};
+            mensagens[n] = (struct mmsghdr){.msg_hdr = {.msg_iov = &vetores[n], .msg_iovlen = 1}};
+            bytes += tamanho;
+            ++n;
+        }
+        int m = sendmmsg(fd, mensagens, n, 0);
+        if (m < 0) {
+            perror("sendmmsg");
+            break;
+        }
+        enviados += (unsigned long)m;
+    }
+
+    double tempo = agora_s() - inicio;
+    printf("%lu datagramas em %.1f s (%.0f/s, %.0f amostras/s), %lu bytes, %d dispositivos\n"
+           "%lu com CRC corrompido, %lu pulados (perdas simuladas)\n",
+           enviados, tempo, enviados / tempo, enviados * por_datagrama / tempo, bytes, quantidade,
+           corrompidos, pulados);
+    free(sequencias);
+    free(relogios);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// vigia.c
+// Implementação do monitor de prazos (ver vigia.h).
+#include <stdio.h>
+
+#include "hardware/watchdog.h"
+#include "vigia.h"
+
+// Registradores de rascunho 0 a 3 (o SDK usa os de 4 a 7 em watchdog_reboot())
+#define VIGIA_MAGICA 0x56470000u        // "VG" nos 16 bits altos, etapa nos baixos
+#define VIGIA_RASCUNHO_ETAPA 0
+#define VIGIA_RASCUNHO_PARADA 1
+#define VIGIA_RASCUNHO_INSTANTE 2
+#define VIGIA_RASCUNHO_REINICIOS 3
+
+static struct {
+    const vigia_etapa_t *etapas;
+    uint8_t quantidade;
+    volatile uint8_t atual;             // Etapa do laço em andamento
+    volatile uint32_t desde_ms[VIGIA_ETAPAS_MAX];  // Início (laço) ou última passagem (periódica)
+    volatile uint32_t marcadas;         // Etapas periódicas que já passaram uma vez
+    volatile bool disparado;
+    struct repeating_timer timer;
+    vigia_relatorio_t relatorio;
+    vigia_stats_t stats;
+} vigia;
+
+static inline uint32_t agora_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void vigia_registrar(uint8_t etapa, uint32_t parada_ms, uint32_t agora) {
+    watchdog_hw->scratch[VIGIA_RASCUNHO_ETAPA] = VIGIA_MAGICA | etapa;
+    watchdog_hw->scratch[VIGIA_RASCUNHO_PARADA] = parada_ms;
+    watchdog_hw->scratch[VIGIA_RASCUNHO_INSTANTE] = agora;
+    watchdog_hw->scratch[VIGIA_RASCUNHO_REINICIOS] = vigia.relatorio.reinicios + 1;
+    vigia.disparado = true;
+}
+
+// Confere os prazos; sem estouro, alimenta o watchdog. Depois de um estouro
+// não alimenta mais, e o watchdog reinicia a placa em VIGIA_WATCHDOG_MS.
+static bool vigia_conferir(struct repeating_timer *t) {
+    if (vigia.disparado) return true;
+    uint32_t agora = agora_ms();
+    ++vigia.stats.conferencias;
+    for (uint8_t i = 0; i < vigia.quantidade; ++i) {
+        const vigia_etapa_t *e = &vigia.etapas[i];
+        if (e->periodica ? !(vigia.marcadas & 1u << i) : i != vigia.atual) continue;
+        uint32_t parada_ms = agora - vigia.desde_ms[i];
+        if (parada_ms > vigia.stats.max_ms[i]) vigia.stats.max_ms[i] = parada_ms;
+        if (parada_ms > e->prazo_ms) {
+            vigia_registrar(i, parada_ms, agora);
+            return true;
+        }
+    }
+    watchdog_update();
+    return true;
+}
+
+void vigia_init(const vigia_etapa_t *etapas, uint8_t quantidade) {
+    vigia.etapas = etapas;
+    vigia.quantidade = quantidade <= VIGIA_ETAPAS_MAX ? quantidade : VIGIA_ETAPAS_MAX;
+    vigia.atual = VIGIA_NENHUMA;
+
+    // Os registradores de rascunho só valem depois de um reset do watchdog
+    vigia_relatorio_t *r = &vigia.relatorio;
+    uint32_t marca = watchdog_hw->scratch[VIGIA_RASCUNHO_ETAPA];
+    r->reinicio = watchdog_caused_reboot();
+    r->reinicios = r->reinicio ? watchdog_hw->scratch[VIGIA_RASCUNHO_REINICIOS] : 0;
+    watchdog_hw->scratch[VIGIA_RASCUNHO_REINICIOS] = r->reinicios;
+    if (r->reinicio && (marca & 0xFFFF0000u) == VIGIA_MAGICA) {
+        r->registrado = true;
+        r->etapa = (uint8_t)marca;
+        r->parada_ms = watchdog_hw->scratch[VIGIA_RASCUNHO_PARADA];
+        r->instante_ms = watchdog_hw->scratch[VIGIA_RASCUNHO_INSTANTE];
+        printf("Vigia: reinício pela etapa %s, parada há %lu ms (prazo %lu ms), %lu ms depois do boot; "
+               "%lu reinícios desde que a placa foi ligada\n",
+               vigia_nome(r->etapa), (unsigned long)r->parada_ms,
+               (unsigned long)(r->etapa < vigia.quantidade ? etapas[r->etapa].prazo_ms : 0),
+               (unsigned long)r->instante_ms, (unsigned long)r->reinicios);
+    } else if (r->reinicio) {
+        printf("Vigia: reinício pelo watchdog sem etapa registrada (interrupções paradas)\n");
+    }
+    watchdog_hw->scratch[VIGIA_RASCUNHO_ETAPA] = 0;  // Um reset sem registro não repete este
+
+    uint32_t agora = agora_ms();
+    for (uint8_t i = 0; i < vigia.quantidade; ++i) vigia.desde_ms[i] = agora;
+    watchdog_enable(VIGIA_WATCHDOG_MS, true);  // Pausado no depurador
+    add_repeating_timer_ms(-VIGIA_PERIODO_MS, vigia_conferir, NULL, &vigia.timer);
+}
+
+void vigia_entrar(uint8_t etapa) {
+    uint32_t agora = agora_ms();
+    uint8_t anterior = vigia.atual;
+    if (anterior != VIGIA_NENHUMA && agora - vigia.desde_ms[anterior] > vigia.stats.max_ms[anterior]) {
+        vigia.stats.max_ms[anterior] = agora - vigia.desde_ms[anterior];
+    }
+    vigia.desde_ms[etapa] = agora;
+    vigia.atual = etapa;
+}
+
+void vigia_marcar(uint8_t etapa) {
+    uint32_t agora = agora_ms();
+    if (vigia.marcadas & 1u << etapa && agora - vigia.desde_ms[etapa] > vigia.stats.max_ms[etapa]) {
+        vigia.stats.max_ms[etapa] = agora - vigia.desde_ms[etapa];
+    }
+    vigia.desde_ms[etapa] = agora;
+    vigia.marcadas |= 1u << etapa;
+}
+
+const vigia_relatorio_t *vigia_relatorio(void) {
+    return &vigia.relatorio;
+}
+
+const vigia_stats_t *vigia_stats(void) {
+    return &vigia.stats;
+}
+
+const char *vigia_nome(uint8_t etapa) {
+    return etapa < vigia.quantidade ? vigia.etapas[etapa].nome : "?";
+}
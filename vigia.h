@@ -0,0 +1,62 @@
+// vigia.h
+// Monitor de prazos sobre o watchdog do RP2040: cada etapa do firmware avisa
+// quando começa (etapas do laço principal) ou quando passa (etapas periódicas,
+// como o temporizador da irrigação), e um temporizador confere os prazos a
+// cada VIGIA_PERIODO_MS. Com todas as etapas no prazo, ele alimenta o watchdog.
+// Quando uma etapa estoura o prazo (I2C travado, 1-Wire sem resposta, laço
+// preso), a etapa, o tempo parado e o instante vão para os registradores de
+// rascunho do watchdog, que sobrevivem ao reset, e o watchdog deixa de ser
+// alimentado e reinicia a placa. Depois do reset, vigia_init() recupera o
+// registro para o monitor serial e o /metrics.
+//
+// Se o próprio temporizador parar (interrupções desligadas), o watchdog
+// reinicia a placa sem registro, e o relatório diz isso.
+#ifndef VIGIA_H
+#define VIGIA_H
+
+#include "pico/stdlib.h"
+
+#define VIGIA_ETAPAS_MAX 8
+#define VIGIA_PERIODO_MS 100            // Conferência dos prazos
+#define VIGIA_WATCHDOG_MS 1000          // Sem conferência por 1 s, o watchdog reinicia sozinho
+#define VIGIA_NENHUMA 0xFF              // Nenhuma etapa do laço em andamento
+
+typedef struct {
+    const char *nome;
+    uint32_t prazo_ms;                  // Laço: duração máxima; periódica: intervalo máximo
+    bool periodica;
+} vigia_etapa_t;
+
+// O que houve antes deste boot
+typedef struct {
+    bool reinicio;                      // O último reset foi do watchdog
+    bool registrado;                    // ...com uma etapa registrada pelo vigia
+    uint8_t etapa;
+    uint32_t parada_ms;                 // Tempo da etapa sem avançar quando o prazo venceu
+    uint32_t instante_ms;               // Desde o boot anterior
+    uint32_t reinicios;                 // Reinícios com etapa registrada desde que a placa foi ligada
+} vigia_relatorio_t;
+
+typedef struct {
+    uint32_t conferencias;
+    uint32_t max_ms[VIGIA_ETAPAS_MAX];  // Maior duração (laço) ou intervalo (periódica) visto
+} vigia_stats_t;
+
+// Lê o registro do reset anterior, liga o watchdog e começa a conferir os
+// prazos. `etapas` deve continuar válido (normalmente uma tabela constante).
+void vigia_init(const vigia_etapa_t *etapas, uint8_t quantidade);
+
+// Laço principal: a etapa em andamento passa a ser `etapa`
+void vigia_entrar(uint8_t etapa);
+
+// Etapa periódica: passou agora (pode ser chamada de interrupção). O prazo
+// só começa a contar depois da primeira passagem.
+void vigia_marcar(uint8_t etapa);
+
+const vigia_relatorio_t *vigia_relatorio(void);
+const vigia_stats_t *vigia_stats(void);
+
+// Nome da etapa para o monitor serial e as métricas
+const char *vigia_nome(uint8_t etapa);
+
+#endif
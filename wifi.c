@@ -0,0 +1,144 @@
+// wifi.c
+// Implementação da conexão Wi-Fi sem bloqueio (ver wifi.h).
+#include <stdio.h>
+
+#include "pico/cyw43_arch.h"
+#include "lwip/netif.h"
+
+#include "wifi.h"
+
+typedef enum {
+    WIFI_DESLIGADO,     // Chip ainda não iniciado
+    WIFI_ESPERA,        // Aguardando a próxima tentativa
+    WIFI_CONECTANDO,    // Associação ou DHCP em andamento
+    WIFI_CONECTADO,
+    WIFI_ERRO,          // cyw43_arch_init() falhou: segue sem rede
+} wifi_estado_t;
+
+static struct {
+    const char *ssid;
+    const char *senha;
+    uint32_t autenticacao;
+    wifi_estado_t estado;
+    uint32_t tentativa_desde_ms;
+    uint32_t proxima_tentativa_ms;
+    uint32_t backoff_ms;
+    uint32_t queda_ms;          // Instante da última queda (0 = nenhuma pendente)
+    wifi_stats_t stats;
+} wifi;
+
+static inline uint32_t agora_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+// Agenda a próxima tentativa; a espera dobra a cada falha seguida
+static void wifi_agendar(bool falha) {
+    if (falha) {
+        wifi.backoff_ms = wifi.backoff_ms ? wifi.backoff_ms * 2 : WIFI_BACKOFF_MIN_MS;
+        if (wifi.backoff_ms > WIFI_BACKOFF_MAX_MS) wifi.backoff_ms = WIFI_BACKOFF_MAX_MS;
+        ++wifi.stats.falhas;
+    }
+    wifi.estado = WIFI_ESPERA;
+    wifi.proxima_tentativa_ms = agora_ms() + (falha ? wifi.backoff_ms : 0);
+}
+
+static void wifi_tentar(void) {
+    ++wifi.stats.tentativas;
+    wifi.tentativa_desde_ms = agora_ms();
+    if (cyw43_arch_wifi_connect_async(wifi.ssid, wifi.senha, wifi.autenticacao)) {
+        printf("Wi-Fi: erro ao iniciar a conexão\n");
+        wifi_agendar(true);
+        return;
+    }
+    wifi.estado = WIFI_CONECTANDO;
+}
+
+static void wifi_conectou(void) {
+    uint32_t agora = agora_ms();
+    wifi.estado = WIFI_CONECTADO;
+    wifi.backoff_ms = 0;
+    if (!wifi.stats.primeira_conexao_ms) {
+        wifi.stats.primeira_conexao_ms = agora;
+        printf("Wi-Fi conectado em %lu ms após o reset, IP %s\n", (unsigned long)agora,
+               ip4addr_ntoa(netif_ip4_addr(netif_default)));
+    } else if (wifi.queda_ms) {
+        wifi.stats.ultima_reconexao_ms = agora - wifi.queda_ms;
+        if (wifi.stats.ultima_reconexao_ms > wifi.stats.reconexao_max_ms) {
+            wifi.stats.reconexao_max_ms = wifi.stats.ultima_reconexao_ms;
+        }
+        printf("Wi-Fi reconectado em %lu ms\n", (unsigned long)wifi.stats.ultima_reconexao_ms);
+    }
+    wifi.queda_ms = 0;
+}
+
+void wifi_init(const char *ssid, const char *senha, uint32_t autenticacao) {
+    wifi.ssid = ssid;
+    wifi.senha = senha;
+    wifi.autenticacao = autenticacao;
+    wifi.estado = WIFI_DESLIGADO;
+}
+
+void wifi_poll(void) {
+    int status;
+    switch (wifi.estado) {
+    case WIFI_DESLIGADO: {
+        // Carrega o firmware do CYW43 (centenas de ms), depois do primeiro quadro do laço
+        uint32_t inicio = agora_ms();
+        if (cyw43_arch_init()) {
+            printf("Falha ao iniciar Wi-Fi, seguindo sem rede\n");
+            wifi.estado = WIFI_ERRO;
+            return;
+        }
+        wifi.stats.init_ms = agora_ms() - inicio;
+        cyw43_arch_enable_sta_mode();
+        printf("Conectando ao Wi-Fi...\n");
+        wifi_tentar();
+        break;
+    }
+
+    case WIFI_ESPERA:
+        if ((int32_t)(agora_ms() - wifi.proxima_tentativa_ms) >= 0) wifi_tentar();
+        break;
+
+    case WIFI_CONECTANDO:
+        status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        wifi.stats.ultimo_status = status;
+        if (status == CYW43_LINK_UP) {
+            wifi_conectou();
+        } else if (status == CYW43_LINK_FAIL || status == CYW43_LINK_NONET || status == CYW43_LINK_BADAUTH ||
+                   agora_ms() - wifi.tentativa_desde_ms > WIFI_TIMEOUT_MS) {
+            printf("Wi-Fi: tentativa sem sucesso (status %d)\n", status);
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            wifi_agendar(true);
+        }
+        break;
+
+    case WIFI_CONECTADO:
+        status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        wifi.stats.ultimo_status = status;
+        if (status != CYW43_LINK_UP) {
+            // Queda do link: reassocia na hora; as seguintes seguem o backoff
+            printf("Wi-Fi: conexão perdida (status %d)\n", status);
+            ++wifi.stats.quedas;
+            wifi.queda_ms = agora_ms();
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            wifi_agendar(false);
+        }
+        break;
+
+    case WIFI_ERRO:
+        break;
+    }
+}
+
+bool wifi_pilha_pronta(void) {
+    return wifi.estado != WIFI_DESLIGADO && wifi.estado != WIFI_ERRO;
+}
+
+bool wifi_conectado(void) {
+    return wifi.estado == WIFI_CONECTADO;
+}
+
+const wifi_stats_t *wifi_stats(void) {
+    return &wifi.stats;
+}
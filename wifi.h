@@ -0,0 +1,44 @@
+// wifi.h
+// Conexão Wi-Fi sem bloqueio: o laço principal começa a ler os sensores, a
+// desenhar o display e a controlar o relé logo após o reset, e a rede entra
+// quando estiver pronta.
+//
+// wifi_poll() inicia o chip CYW43 na primeira chamada, pede a associação com
+// cyw43_arch_wifi_connect_async() e acompanha o estado do link. Tentativas que
+// falham (senha errada, rede ausente, tempo esgotado) e quedas do link são
+// refeitas com espera exponencial.
+#ifndef WIFI_H
+#define WIFI_H
+
+#include "pico/stdlib.h"
+
+#define WIFI_TIMEOUT_MS 20000          // Tempo máximo de uma tentativa (associação + DHCP)
+#define WIFI_BACKOFF_MIN_MS 1000       // Espera após a primeira falha
+#define WIFI_BACKOFF_MAX_MS 60000      // Espera máxima entre tentativas
+
+typedef struct {
+    uint32_t tentativas;               // Chamadas a cyw43_arch_wifi_connect_async()
+    uint32_t falhas;                   // Tentativas sem sucesso
+    uint32_t quedas;                   // Perdas do link depois de conectado
+    uint32_t init_ms;                  // Duração de cyw43_arch_init() (carga do firmware)
+    uint32_t primeira_conexao_ms;      // Do reset até o primeiro IP
+    uint32_t ultima_reconexao_ms;      // Da última queda até o IP de volta
+    uint32_t reconexao_max_ms;
+    int32_t ultimo_status;             // CYW43_LINK_* da última verificação
+} wifi_stats_t;
+
+// Guarda as credenciais; não acessa o chip (a inicialização fica para wifi_poll)
+void wifi_init(const char *ssid, const char *senha, uint32_t autenticacao);
+
+// Inicia o chip, conecta e reconecta. Chamar no laço principal.
+void wifi_poll(void);
+
+// true depois de cyw43_arch_init(): a partir daí o lwIP pode ser usado
+bool wifi_pilha_pronta(void);
+
+// true com o link ativo e um endereço IP
+bool wifi_conectado(void);
+
+const wifi_stats_t *wifi_stats(void);
+
+#endif